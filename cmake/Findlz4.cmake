@@ -0,0 +1,47 @@
+#######################
+#
+#  Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+#  agreements.  See the NOTICE file distributed with this work for additional information regarding
+#  copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+#  (the "License"); you may not use this file except in compliance with the License.  You may obtain
+#  a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software distributed under the License
+#  is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+#  or implied. See the License for the specific language governing permissions and limitations under
+#  the License.
+#
+#######################
+
+# Findlz4.cmake
+#
+# This will define the following variables
+#
+#     lz4_FOUND
+#     lz4_LIBRARY
+#     lz4_INCLUDE_DIRS
+#
+# and the following imported targets
+#
+#     lz4::lz4
+#
+
+find_library(lz4_LIBRARY NAMES lz4)
+find_path(lz4_INCLUDE_DIR NAMES lz4.h)
+
+mark_as_advanced(lz4_FOUND lz4_LIBRARY lz4_INCLUDE_DIR)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(lz4 REQUIRED_VARS lz4_LIBRARY lz4_INCLUDE_DIR)
+
+if(lz4_FOUND)
+  set(lz4_INCLUDE_DIRS ${lz4_INCLUDE_DIR})
+endif()
+
+if(lz4_FOUND AND NOT TARGET lz4::lz4)
+  add_library(lz4::lz4 INTERFACE IMPORTED)
+  target_include_directories(lz4::lz4 INTERFACE ${lz4_INCLUDE_DIRS})
+  target_link_libraries(lz4::lz4 INTERFACE ${lz4_LIBRARY})
+endif()
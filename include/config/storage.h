@@ -72,6 +72,7 @@ struct StorageVolumeEntry {
   int64_t              ram_cache_cutoff = -1;
   int                  avg_obj_size     = -1;
   int                  fragment_size    = -1;
+  int                  lower_tier       = 0; ///< id of the volume objects are demoted to, 0 for none
   std::vector<SpanRef> spans;
 };
 
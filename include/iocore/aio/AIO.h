@@ -109,4 +109,9 @@ void ink_aio_set_err_callback(Continuation *error_callback);
 int          ink_aio_read(AIOCallback *op,
                           int fromAPI = 0); // fromAPI is a boolean to indicate if this is from an API call such as upload proxy feature
 int          ink_aio_write(AIOCallback *op, int fromAPI = 0);
+
+// Register a disk fd or a long lived buffer for fixed io_uring I/O. These do nothing with the thread backend.
+void ink_aio_register_fd(int fd);
+void ink_aio_register_buffer(void *buf, size_t len);
+void ink_aio_unregister_buffer(void *buf);
 AIOCallback *new_AIOCallback();
@@ -39,12 +39,25 @@ static constexpr ts::ModuleVersion CACHE_MODULE_VERSION(1, 0);
 #define RAM_CACHE_ALGORITHM_CLFUS 0
 #define RAM_CACHE_ALGORITHM_LRU   1
 
+#define RAM_CACHE_ADMISSION_NONE    0
+#define RAM_CACHE_ADMISSION_TINYLFU 1
+
 #define CACHE_COMPRESSION_NONE    0
 #define CACHE_COMPRESSION_FASTLZ  1
 #define CACHE_COMPRESSION_LIBZ    2
 #define CACHE_COMPRESSION_LIBLZMA 3
-
-enum { RAM_HIT_COMPRESS_NONE = 1, RAM_HIT_COMPRESS_FASTLZ, RAM_HIT_COMPRESS_LIBZ, RAM_HIT_COMPRESS_LIBLZMA, RAM_HIT_LAST_ENTRY };
+#define CACHE_COMPRESSION_ZSTD    4
+#define CACHE_COMPRESSION_LZ4     5
+
+enum {
+  RAM_HIT_COMPRESS_NONE = 1,
+  RAM_HIT_COMPRESS_FASTLZ,
+  RAM_HIT_COMPRESS_LIBZ,
+  RAM_HIT_COMPRESS_LIBLZMA,
+  RAM_HIT_COMPRESS_ZSTD,
+  RAM_HIT_COMPRESS_LZ4,
+  RAM_HIT_LAST_ENTRY
+};
 
 struct CacheVC;
 class CacheEvacuateDocVC;
@@ -207,6 +220,23 @@ struct CacheVConnection : public VConnection {
   */
   virtual bool is_pread_capable() = 0;
 
+  /** Make this write a fill of part of a sparse object.
+
+      The data written starts at @a offset in an object of @a object_size
+      bytes. Only whole fragments are stored, so leading and trailing bytes
+      that do not fill one are dropped. If the cache has a sparse alternate
+      with the same size and validators the fill is merged into it.
+      This must be called after @c set_http_info and before @c do_io_write.
+
+      @return @c true if the fill was set up, @c false if this write cannot
+      be a fill, in which case it should be closed without writing.
+  */
+  virtual bool
+  set_sparse_fill(int64_t /* offset ATS_UNUSED */, int64_t /* object_size ATS_UNUSED */)
+  {
+    return false;
+  }
+
   CacheVConnection();
 };
 
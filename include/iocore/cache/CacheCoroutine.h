@@ -0,0 +1,41 @@
+/** @file
+
+  Cache operations for coroutines, see iocore/eventsystem/Coroutine.h.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#pragma once
+
+#include "iocore/cache/Cache.h"
+#include "iocore/eventsystem/Coroutine.h"
+
+namespace ts::coro
+{
+/** Open @a key for reading.
+
+    Resumes with @c CACHE_EVENT_OPEN_READ and the @c CacheVC, which is then read with @c vio_read,
+    or with @c CACHE_EVENT_OPEN_READ_FAILED and the error.
+ */
+inline auto
+cache_read(CacheKey const &key, CacheFragType frag_type = CACHE_FRAG_TYPE_NONE)
+{
+  return call([key, frag_type](Continuation *c) { cacheProcessor.open_read(c, &key, frag_type); });
+}
+} // namespace ts::coro
@@ -86,4 +86,11 @@ public:
                                                            ink_time_t response_received_time);
 
   static bool validate_ifrange_header_if_any(HTTPHdr *ua_request, HTTPHdr *c_response);
+
+  /** Check if a sparse alternate can serve the range in a request.
+
+      Only a request for a single byte range that validates any If-Range
+      against @a obj can be served, and only if every byte of it is present.
+  */
+  static bool is_range_cached(HTTPHdr *client_request, HTTPInfo *obj);
 };
@@ -228,6 +228,17 @@ public:
     return (this->*handler)(event, data);
   }
 
+  /**
+    Code that handles the events of this Continuation, for the event loop profiler.
+
+    This is the current handler. A Continuation that passes its events on to a callback should
+    return the callback, so that the time is charged to it rather than to the forwarding.
+
+    @return The address of the code, or @c nullptr if it is not known.
+
+  */
+  virtual void const *profile_target() const;
+
 protected:
   /**
     Constructor of the Continuation object. It should not be used
@@ -279,3 +290,14 @@ inline Continuation::Continuation(ProxyMutex *amutex) : mutex(amutex)
   // Pick up the control flags from the creating thread
   this->control_flags.set_flags(get_cont_flags().get_flags());
 }
+
+inline void const *
+Continuation::profile_target() const
+{
+  // In the Itanium C++ ABI a pointer to member function starts with the address of the function,
+  // or with one more than its vtable offset if it is virtual.
+  uintptr_t fn;
+  static_assert(sizeof(handler) >= sizeof(fn));
+  memcpy(&fn, &handler, sizeof(fn));
+  return (fn & 1) ? nullptr : reinterpret_cast<void const *>(fn);
+}
@@ -0,0 +1,289 @@
+/** @file
+
+  C++20 coroutines on the event system.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#pragma once
+
+#include "iocore/eventsystem/Continuation.h"
+#include "iocore/eventsystem/EThread.h"
+#include "iocore/eventsystem/Event.h"
+#include "iocore/eventsystem/Lock.h"
+#include "iocore/eventsystem/VConnection.h"
+#include "iocore/eventsystem/VIO.h"
+
+#include <array>
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+/** Coroutines that suspend on the event system rather than on a switch over events.
+
+    @code
+    ts::coro::Task
+    Fetcher::run()
+    {
+      auto [event, vio] = co_await ts::coro::vio_read(vc, buf, INT64_MAX);
+      while (event == VC_EVENT_READ_READY) {
+        consume(vio->get_reader());
+        std::tie(event, vio) = co_await ts::coro::vio_next(vio);
+      }
+      vc->do_io_close();
+      co_await ts::coro::schedule_in(HRTIME_SECONDS(1));
+      ...
+    }
+    @endcode
+ */
+namespace ts::coro
+{
+/// Get memory for a coroutine frame, from the free list of the thread if it is small enough.
+void *frame_alloc(size_t size);
+/// Free memory from @c frame_alloc.
+void frame_free(void *p, size_t size);
+
+/// What an awaited operation called back with.
+struct Result {
+  int   event = EVENT_NONE;
+  void *data  = nullptr;
+};
+
+/// The event a VIO called back with.
+struct IOEvent {
+  int  event = EVENT_NONE;
+  VIO *vio   = nullptr;
+};
+
+/** Coroutine run by the event system.
+
+    The coroutine starts in the caller and runs up to its first @c co_await. After that it is
+    resumed by the event system, on the thread that called back, with its mutex held. The mutex is
+    that of the @c Continuation if that is the first parameter, as it is for member functions of a
+    continuation, otherwise a new one. It is not taken for the start, so the caller must hold it
+    if it is shared.
+
+    The frame is freed when the coroutine returns. VConnections it read or wrote must be closed by
+    then, as their VIOs call back into the frame.
+ */
+class Task
+{
+public:
+  /// Continuation for the VIOs of a coroutine, which keeps their events until they are awaited.
+  class IOHandler : public Continuation
+  {
+  public:
+    explicit IOHandler(ProxyMutex *m) : Continuation(m) { SET_HANDLER(&IOHandler::handle_event); }
+
+    /// Take the event kept for @a vio, if there is one.
+    bool take(VIO *vio);
+
+    VIO                    *awaiting = nullptr; ///< VIO the coroutine is suspended on.
+    int                     event    = EVENT_NONE;
+    std::coroutine_handle<> handle;
+
+  private:
+    int handle_event(int event, void *data);
+
+    /// Latest event of each VIO that called back while the coroutine was not waiting for it.
+    std::array<std::pair<VIO *, int>, 4> _pending{};
+  };
+
+  struct promise_type {
+    Ptr<ProxyMutex> mutex;
+    IOHandler       io;
+
+    template <typename C, typename... Args>
+      requires std::derived_from<C, Continuation>
+    explicit promise_type(C &cont, Args &...) : mutex(cont.mutex), io(mutex.get())
+    {
+    }
+    template <typename... Args> explicit promise_type(Args &...) : mutex(new_ProxyMutex()), io(mutex.get()) {}
+
+    Task
+    get_return_object() noexcept
+    {
+      return {};
+    }
+    std::suspend_never
+    initial_suspend() noexcept
+    {
+      return {};
+    }
+    std::suspend_never
+    final_suspend() noexcept
+    {
+      return {};
+    }
+    void
+    return_void() noexcept
+    {
+    }
+    void
+    unhandled_exception() noexcept
+    {
+      std::terminate();
+    }
+
+    static void *
+    operator new(size_t size)
+    {
+      return frame_alloc(size);
+    }
+    static void
+    operator delete(void *p, size_t size)
+    {
+      frame_free(p, size);
+    }
+  };
+};
+
+/** Awaits one callback to a continuation of its own, which @a start passes on.
+
+    The continuation is in the coroutine frame and has the mutex of the coroutine. The callback may
+    come from inside @a start.
+ */
+template <typename F> class Callback : public Continuation
+{
+public:
+  explicit Callback(F start) : _start(std::move(start)) { SET_HANDLER(&Callback::handle_event); }
+
+  bool
+  await_ready() const noexcept
+  {
+    return false;
+  }
+
+  void
+  await_suspend(std::coroutine_handle<Task::promise_type> h)
+  {
+    mutex   = h.promise().mutex;
+    _handle = h;
+    // The frame may be gone once this returns.
+    _start(static_cast<Continuation *>(this));
+  }
+
+  Result
+  await_resume() const noexcept
+  {
+    return _result;
+  }
+
+private:
+  int
+  handle_event(int event, void *data)
+  {
+    _result = {event, data};
+    _handle.resume();
+    return EVENT_DONE;
+  }
+
+  F                       _start;
+  Result                  _result;
+  std::coroutine_handle<> _handle;
+};
+
+/// Call @a start with a continuation and resume with what it is called back with.
+template <typename F>
+Callback<F>
+call(F start)
+{
+  return Callback<F>{std::move(start)};
+}
+
+/// Resume after @a delay, on this thread.
+inline auto
+schedule_in(ink_hrtime delay)
+{
+  return call([delay](Continuation *c) { this_ethread()->schedule_in(c, delay); });
+}
+
+/// Resume in the next pass of the event loop of this thread, to let other events run.
+inline auto
+schedule_imm()
+{
+  return call([](Continuation *c) { this_ethread()->schedule_imm(c); });
+}
+
+/** Awaits the next event of the VIO that @a start returns.
+
+    The VIOs of a coroutine call back to its @c Task::IOHandler. The coroutine must hold its mutex
+    when it starts or reenables a VIO.
+ */
+template <typename F> class IO
+{
+public:
+  explicit IO(F start) : _start(std::move(start)) {}
+
+  bool
+  await_ready() const noexcept
+  {
+    return false;
+  }
+
+  bool
+  await_suspend(std::coroutine_handle<Task::promise_type> h)
+  {
+    _io  = &h.promise().io;
+    _vio = _start(static_cast<Continuation *>(_io));
+    if (_io->take(_vio)) {
+      return false;
+    }
+    _io->awaiting = _vio;
+    _io->handle   = h;
+    return true;
+  }
+
+  IOEvent
+  await_resume() const noexcept
+  {
+    return {_io->event, _vio};
+  }
+
+private:
+  F               _start;
+  Task::IOHandler *_io  = nullptr;
+  VIO             *_vio = nullptr;
+};
+
+/// Start reading @a nbytes from @a vc into @a buf and resume with the first event.
+inline auto
+vio_read(VConnection *vc, MIOBuffer *buf, int64_t nbytes)
+{
+  return IO{[=](Continuation *c) { return vc->do_io_read(c, nbytes, buf); }};
+}
+
+/// Start writing @a nbytes from @a reader to @a vc and resume with the first event.
+inline auto
+vio_write(VConnection *vc, IOBufferReader *reader, int64_t nbytes)
+{
+  return IO{[=](Continuation *c) { return vc->do_io_write(c, nbytes, reader); }};
+}
+
+/// Reenable @a vio and resume with its next event.
+inline auto
+vio_next(VIO *vio)
+{
+  return IO{[vio](Continuation *) {
+    vio->reenable();
+    return vio;
+  }};
+}
+} // namespace ts::coro
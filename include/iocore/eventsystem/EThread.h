@@ -25,6 +25,7 @@
 #pragma once
 
 #include <atomic>
+#include <typeinfo>
 
 #include "tscore/ink_platform.h"
 #include "tscore/ink_rand.h"
@@ -32,6 +33,7 @@
 #include "iocore/eventsystem/Thread.h"
 #include "iocore/eventsystem/PriorityEventQueue.h"
 #include "iocore/eventsystem/ProtectedQueue.h"
+#include "iocore/eventsystem/StealQueue.h"
 #include "tsutil/Histogram.h"
 #include "iocore/eventsystem/Watchdog.h"
 
@@ -337,6 +339,36 @@ public:
   ProtectedQueue     EventQueueExternal;
   PriorityEventQueue EventQueue;
 
+  /** Immediate events for a work stealing thread group.
+      Idle threads of the group take events from here while this thread is busy.
+      @see EventProcessor::ThreadGroupDescriptor::_work_stealing
+  */
+  StealQueue            EventQueueStealable;
+  EventType             steal_group = -1; ///< Work stealing group of this thread, -1 if none.
+  std::atomic<uint64_t> steal_count{0};   ///< Events taken from other threads of the group.
+
+  /** Limits on one pass of the event loop, 0 for none.
+      Once a pass has run @a loop_event_budget handlers or has taken @a loop_time_budget
+      microseconds, the immediate and timed events still ready are left for the next pass so that
+      polling for I/O is not held up behind them. Poll events are always run.
+  */
+  static int loop_event_budget;
+  static int loop_time_budget;
+  /// Time the event handlers of each continuation type, see @c Metrics::HandlerTiming.
+  static int handler_timing;
+  /// Time one in this many event handler calls for the @c Profile, 0 for none.
+  static int profile_sample_rate;
+
+  /** Check whether this pass of the event loop has used up its budget.
+      A handler that can split up its work may check this and reschedule itself for the rest.
+  */
+  bool loop_budget_spent() const;
+
+  int                   loop_events    = 0;     ///< Handlers run in this pass of the event loop.
+  ink_hrtime            loop_deadline  = 0;     ///< End of the time budget of this pass, 0 if there is none.
+  bool                  loop_cut_short = false; ///< Immediate events were left for the next pass.
+  std::atomic<uint64_t> loop_deferred{0};       ///< Passes that left ready events for the next pass.
+
   static constexpr int NO_ETHREAD_ID = -1;
   int                  id            = NO_ETHREAD_ID;
 
@@ -355,6 +387,7 @@ public:
   void             execute_regular();
   ink_hrtime       process_queue(Que(Event, link) * NegativeQueue, int *ev_count, int *nq_count, ink_hrtime event_time);
   ink_hrtime       process_event(Event *e, int calling_code, ink_hrtime event_time);
+  ink_hrtime       process_stealable(int *ev_count, ink_hrtime event_time);
   void             free_event(Event *e);
   LoopTailHandler *tail_cb = &DEFAULT_TAIL_HANDLER;
 
@@ -382,7 +415,7 @@ public:
 
   /** Default handler used until it is overridden.
 
-      This uses the cond var wait in @a ExternalQueue.
+      This sleeps in @a ExternalQueue until it is signaled.
   */
   class DefaultTailHandler : public LoopTailHandler
   {
@@ -391,18 +424,16 @@ public:
     int
     waitForActivity(ink_hrtime timeout) override
     {
-      _q.wait(ink_get_hrtime() + timeout);
+      _q.wait(timeout);
       return 0;
     }
     void
     signalActivity() override
     {
-      /* Try to acquire the `EThread::lock` of the Event Thread:
-       *   - Acquired, indicating that the Event Thread is sleep,
-       *               must send a wakeup signal to the Event Thread.
-       *   - Failed, indicating that the Event Thread is busy, do nothing.
+      /* Only called for a parked Event Thread, which is sleeping in wait()
+       * or about to, so wake it up.
        */
-      (void)_q.try_signal();
+      _q.signal();
     }
 
     ProtectedQueue &_q;
@@ -567,6 +598,27 @@ public:
     static constexpr ts_milliseconds API_HISTOGRAM_BUCKET_SIZE{1};
     Graph                            _api_timing; ///< Plugin API callout timings.
 
+    /// Run times of the event handlers of one continuation type, in microseconds up to a second.
+    struct HandlerTiming {
+      using Graph = ts::Histogram<18, 2>;
+      /// Type of the continuation, the dynamic type so that the handlers of subclasses are apart.
+      std::atomic<std::type_info const *> _type{nullptr};
+      Graph                               _timing;
+    };
+    /// Continuation types timed per thread. Types past this are not timed.
+    static constexpr int N_HANDLER_TYPES = 64;
+    /// Base name for handler timing stats, followed by the type name and percentile.
+    static constexpr swoc::TextView HANDLER_STAT_STEM = "proxy.process.eventloop.handler.";
+    std::array<HandlerTiming, N_HANDLER_TYPES> _handler_timing;
+
+    /** Record the run time of an event handler.
+     *
+     * @param type Dynamic type of the continuation.
+     * @param delta Duration of the call.
+     * @return @a this
+     */
+    self_type &record_handler_time(std::type_info const &type, ink_hrtime delta);
+
     /// Data in the histogram needs to decay over time. To avoid races and locks the
     /// summarizing thread bumps this to indicate a decay is needed and doesn't update if
     /// this is non-zero. The event loop does the decay and decrements the count.
@@ -585,6 +637,38 @@ public:
 
   Metrics metrics;
 
+  /** Sampling profile of the event handlers run by this thread.
+
+      Sampled calls are charged to the type of the continuation and the code that handled the
+      event, see @c Continuation::profile_target. Only this thread writes, others may read at any
+      time.
+  */
+  struct Profile {
+    using self_type = Profile; ///< Self reference type.
+
+    struct Entry {
+      std::atomic<std::type_info const *> _type{nullptr}; ///< Set last, when the entry is ready.
+      std::atomic<void const *>           _target{nullptr};
+      std::atomic<uint64_t>               _samples{0};
+      std::atomic<uint64_t>               _nsec{0}; ///< Estimated time, the sampled time scaled up by the rate.
+    };
+    /// Distinct handlers profiled per thread, samples for more are dropped.
+    static constexpr int N_ENTRIES = 256;
+
+    std::array<Entry, N_ENTRIES> _entry;
+    std::atomic<uint64_t>        _dropped{0};    ///< Samples there was no entry for.
+    int                          _countdown = 0; ///< Calls until the next sample.
+
+    /** Record a sampled call.
+     *
+     * @param type Dynamic type of the continuation.
+     * @param target Code that handled the event.
+     * @param nsec Estimated time for all the calls the sample stands for.
+     * @return @a this
+     */
+    self_type &record(std::type_info const &type, void const *target, uint64_t nsec);
+  } profile;
+
   Watchdog::Heartbeat heartbeat_state;
 
 private:
@@ -683,12 +767,36 @@ EThread::Metrics::record_api_time(ink_hrtime delta) -> self_type &
   return *this;
 }
 
+inline auto
+EThread::Metrics::record_handler_time(std::type_info const &type, ink_hrtime delta) -> self_type &
+{
+  // Only this thread adds types, the slot is published after it is claimed for readers.
+  size_t hash = reinterpret_cast<uintptr_t>(&type) >> 4;
+  for (int i = 0; i < N_HANDLER_TYPES; ++i) {
+    HandlerTiming &h = _handler_timing[(hash + i) % N_HANDLER_TYPES];
+    auto           t = h._type.load(std::memory_order_relaxed);
+    if (t == nullptr) {
+      h._type.store(&type, std::memory_order_release);
+    } else if (t != &type) {
+      continue;
+    }
+    h._timing(ink_hrtime_to_usec(std::max<ink_hrtime>(0, delta)));
+    break;
+  }
+  return *this;
+}
+
 inline auto
 EThread::Metrics::decay() -> self_type &
 {
   while (_decay_count) {
     _loop_timing.decay();
     _api_timing.decay();
+    for (auto &h : _handler_timing) {
+      if (h._type.load(std::memory_order_relaxed)) {
+        h._timing.decay();
+      }
+    }
     --_decay_count;
   }
   return *this;
@@ -710,6 +818,33 @@ operator new(size_t, ink_dummy_for_new *p)
 }
 #define ETHREAD_GET_PTR(thread, offset) ((void *)((char *)(thread) + (offset)))
 
+inline auto
+EThread::Profile::record(std::type_info const &type, void const *target, uint64_t nsec) -> self_type &
+{
+  size_t hash = (reinterpret_cast<uintptr_t>(&type) ^ reinterpret_cast<uintptr_t>(target)) >> 4;
+  for (int i = 0; i < N_ENTRIES; ++i) {
+    Entry &e = _entry[(hash + i) % N_ENTRIES];
+    auto   t = e._type.load(std::memory_order_relaxed);
+    if (t == nullptr) {
+      e._target.store(target, std::memory_order_relaxed);
+      e._type.store(&type, std::memory_order_release);
+    } else if (t != &type || e._target.load(std::memory_order_relaxed) != target) {
+      continue;
+    }
+    e._samples.fetch_add(1, std::memory_order_relaxed);
+    e._nsec.fetch_add(nsec, std::memory_order_relaxed);
+    return *this;
+  }
+  _dropped.fetch_add(1, std::memory_order_relaxed);
+  return *this;
+}
+
+inline bool
+EThread::loop_budget_spent() const
+{
+  return (loop_event_budget > 0 && loop_events >= loop_event_budget) || (loop_deadline && ink_get_hrtime() >= loop_deadline);
+}
+
 inline EThread *
 this_ethread()
 {
@@ -212,7 +212,7 @@ public:
   unsigned int in_the_priority_queue : 1;
   unsigned int immediate             : 1;
   unsigned int globally_allocated    : 1;
-  unsigned int in_heap               : 4;
+  uint16_t     in_heap        = UINT16_MAX; ///< Slot in the timing wheel of the thread.
   int          callback_event = 0;
 
   ink_hrtime timeout_at = 0;
@@ -228,7 +228,7 @@ public:
 
   // Private
 
-  Event() : in_the_prot_queue(false), in_the_priority_queue(false), immediate(false), globally_allocated(true), in_heap(false) {}
+  Event() : in_the_prot_queue(false), in_the_priority_queue(false), immediate(false), globally_allocated(true) {}
 
   Event *
   init(Continuation *c, ink_hrtime atimeout_at = 0, ink_hrtime aperiod = 0)
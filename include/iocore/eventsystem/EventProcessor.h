@@ -297,6 +297,9 @@ public:
     Que(Event, link) _spawnQueue;                                 ///< Events to dispatch when thread is spawned.
     EThread              *_thread[MAX_THREADS_IN_EACH_TYPE] = {}; ///< The actual threads in this group.
     std::function<void()> _afterStartCallback               = nullptr;
+    /// Immediate events are queued where idle threads of the group can steal them. Set before the group is spawned.
+    bool     _work_stealing = false;
+    uint64_t _next_thief    = 0; ///< Index of the thread to wake when the target of an event is busy.
   };
 
   /// Storage for per group data.
@@ -122,7 +122,8 @@ extern MeteredAllocator<FreelistAllocator> ioBufAllocator[DEFAULT_BUFFER_SIZES];
 extern FreelistAllocator ioBufAllocator[DEFAULT_BUFFER_SIZES];
 #endif
 
-void init_buffer_allocators(int iobuffer_advice, int chunk_sizes[DEFAULT_BUFFER_SIZES], bool use_hugepages);
+void init_buffer_allocators(int iobuffer_advice, int chunk_sizes[DEFAULT_BUFFER_SIZES], bool use_hugepages,
+                            bool use_arena = false);
 void init_buffer_allocators(int iobuffer_advice);
 
 bool parse_buffer_chunk_sizes(const char *s, int chunk_sizes[DEFAULT_BUFFER_SIZES]);
@@ -26,63 +26,29 @@
 #include "tscore/ink_platform.h"
 #include "iocore/eventsystem/Event.h"
 
-// <5ms, 10, 20, 40, 80, 160, 320, 640, 1280, 2560, 5120
-#define N_PQ_LIST          10
-#define PQ_BUCKET_TIME(_i) (HRTIME_MSECONDS(5) << (_i))
+#include "tscore/TimerWheel.h"
 
 class EThread;
 
+/** Timed events of a thread.
+
+    The events are kept in a timing wheel with 1ms ticks, events that are due are moved to a
+    ready queue by check_ready() and taken from there by dequeue_ready().
+ */
 struct PriorityEventQueue {
-  Que(Event, link) after[N_PQ_LIST];
+  using Wheel = TimerWheel<Event, Event::Link_link, &Event::timeout_at, &Event::in_heap, HRTIME_MSECONDS(1)>;
+
+  static constexpr uint16_t READY = Wheel::NONE - 1; ///< @c in_heap of events in the ready queue.
+
+  Wheel wheel;
+  Que(Event, link) ready;
   ink_hrtime last_check_time;
-  uint32_t   last_check_buckets;
 
   void
-  enqueue(Event *e, ink_hrtime now)
+  enqueue(Event *e, ink_hrtime /* now ATS_UNUSED */)
   {
-    ink_hrtime t = e->timeout_at - now;
-    int        i = 0;
-    // equivalent but faster
-    if (t <= PQ_BUCKET_TIME(3)) {
-      if (t <= PQ_BUCKET_TIME(1)) {
-        if (t <= PQ_BUCKET_TIME(0)) {
-          i = 0;
-        } else {
-          i = 1;
-        }
-      } else {
-        if (t <= PQ_BUCKET_TIME(2)) {
-          i = 2;
-        } else {
-          i = 3;
-        }
-      }
-    } else {
-      if (t <= PQ_BUCKET_TIME(7)) {
-        if (t <= PQ_BUCKET_TIME(5)) {
-          if (t <= PQ_BUCKET_TIME(4)) {
-            i = 4;
-          } else {
-            i = 5;
-          }
-        } else {
-          if (t <= PQ_BUCKET_TIME(6)) {
-            i = 6;
-          } else {
-            i = 7;
-          }
-        }
-      } else {
-        if (t <= PQ_BUCKET_TIME(8)) {
-          i = 8;
-        } else {
-          i = 9;
-        }
-      }
-    }
     e->in_the_priority_queue = 1;
-    e->in_heap               = i;
-    after[i].enqueue(e);
+    wheel.insert(e);
   }
 
   void
@@ -90,17 +56,22 @@ struct PriorityEventQueue {
   {
     ink_assert(e->in_the_priority_queue);
     e->in_the_priority_queue = 0;
-    after[e->in_heap].remove(e);
+    if (e->in_heap == READY) {
+      ready.remove(e);
+      e->in_heap = Wheel::NONE;
+    } else {
+      wheel.remove(e);
+    }
   }
 
   Event *
-  dequeue_ready(ink_hrtime t)
+  dequeue_ready(ink_hrtime /* t ATS_UNUSED */)
   {
-    (void)t;
-    Event *e = after[0].dequeue();
+    Event *e = ready.dequeue();
     if (e) {
       ink_assert(e->in_the_priority_queue);
       e->in_the_priority_queue = 0;
+      e->in_heap               = Wheel::NONE;
     }
     return e;
   }
@@ -110,12 +81,10 @@ struct PriorityEventQueue {
   ink_hrtime
   earliest_timeout()
   {
-    for (int i = 0; i < N_PQ_LIST; i++) {
-      if (after[i].head) {
-        return last_check_time + (PQ_BUCKET_TIME(i) / 2);
-      }
+    if (ready.head) {
+      return last_check_time;
     }
-    return last_check_time + HRTIME_FOREVER;
+    return wheel.earliest();
   }
 
   PriorityEventQueue();
@@ -24,11 +24,12 @@
 /****************************************************************************
 
   Protected Queue, a FIFO queue with the following functionality:
-  (1). Multiple threads could be simultaneously trying to enqueue
-       and dequeue. Hence the queue needs to be protected with mutex.
-  (2). In case the queue is empty, dequeue() sleeps for a specified
-       amount of time, or until a new element is inserted, whichever
-       is earlier
+  (1). Multiple threads could be simultaneously trying to enqueue, and
+       one thread, the owner, dequeues. Producers never block each other,
+       each enqueue is a single atomic exchange.
+  (2). In case the queue is empty, the owner parks and sleeps for a
+       specified amount of time, or until a new element is inserted,
+       whichever is earlier. Producers only wake a parked owner.
 
 
  ****************************************************************************/
@@ -36,51 +37,84 @@
 
 #include "tscore/ink_platform.h"
 #include "iocore/eventsystem/Event.h"
+
+#include <atomic>
+
 struct ProtectedQueue {
   void   enqueue(Event *e);
-  void   signal();
-  int    try_signal();            // Use non blocking lock and if acquired, signal
-  void   enqueue_local(Event *e); // Safe when called from the same thread
+  void   signal();                 // Wake the owner if it is sleeping in wait()
+  void   enqueue_local(Event *e);  // Safe when called from the same thread
   Event *dequeue_local();
   void   dequeue_external();       // Dequeue any external events.
-  void   wait(ink_hrtime timeout); // Wait for @a timeout nanoseconds on a condition variable if there are no events.
+  void   wait(ink_hrtime timeout); // Wait for @a timeout nanoseconds if parked, until signaled.
+
+  /** Mark the owner as about to sleep.
+
+      Producers ring the doorbell (@c LoopTailHandler::signalActivity) only for a parked owner, so
+      this checks for events again after parking.
+
+      @return @c false if there are external events, in which case the owner is not parked.
+   */
+  bool park();
+  void unpark(); // Called by the owner after it wakes up.
+
+  /// Signal @a owner if it is parked. @return @c true if it was.
+  bool ring(EThread *owner);
+
+  bool external_empty() const;
 
-  InkAtomicList al;
-  ink_mutex     lock;
-  ink_cond      might_have_data;
+#if !defined(__linux__)
+  ink_mutex lock;
+  ink_cond  might_have_data;
+#endif
   Que(Event, link) localQueue;
 
   ProtectedQueue();
+
+private:
+  void   push(Event *e);
+  Event *pop();
+
+  // Intrusive multi producer, single consumer queue linked through Event::link.next, with a stub
+  // element so that it is never empty. Producers exchange the tail and then link the previous
+  // tail to the new element; the owner follows the links from the head.
+  Event                _stub;
+  Event               *_head = &_stub;
+  std::atomic<Event *> _tail{&_stub};
+  std::atomic<int>     _parked{0}; // Also the futex word, 1 while the owner is parked.
 };
 
 inline ProtectedQueue::ProtectedQueue()
 {
-  Event e;
+#if !defined(__linux__)
   ink_mutex_init(&lock);
-  ink_atomiclist_init(&al, "ProtectedQueue", (char *)&e.link.next - (char *)&e);
   ink_cond_init(&might_have_data);
+#endif
 }
 
-inline void
-ProtectedQueue::signal()
+inline bool
+ProtectedQueue::external_empty() const
 {
-  // Need to get the lock before you can signal the thread
-  ink_mutex_acquire(&lock);
-  ink_cond_signal(&might_have_data);
-  ink_mutex_release(&lock);
+  return _head == &_stub && _tail.load() == &_stub;
 }
 
-inline int
-ProtectedQueue::try_signal()
+inline bool
+ProtectedQueue::park()
 {
-  // Need to get the lock before you can signal the thread
-  if (ink_mutex_try_acquire(&lock)) {
-    ink_cond_signal(&might_have_data);
-    ink_mutex_release(&lock);
-    return 1;
-  } else {
-    return 0;
+  // Sequentially consistent with the exchange of the tail in push(), so either this sees the
+  // event or the producer sees the owner parked.
+  _parked.store(1);
+  if (!external_empty()) {
+    _parked.store(0, std::memory_order_relaxed);
+    return false;
   }
+  return true;
+}
+
+inline void
+ProtectedQueue::unpark()
+{
+  _parked.store(0, std::memory_order_relaxed);
 }
 
 // Called from the same thread (don't need to signal)
@@ -0,0 +1,106 @@
+/** @file
+
+  Queue of immediate events that idle threads of the same group can take.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#pragma once
+
+#include "tscore/ink_platform.h"
+#include "iocore/eventsystem/Event.h"
+
+#include <atomic>
+
+/** Per thread deque of a work stealing thread group.
+
+    Any thread adds events at the back. The owner takes them from the front, one at a time, so
+    that the rest stay available while it runs a long event. Other threads of the group steal
+    from the back, leaving the owner the events it would have run next.
+ */
+class StealQueue
+{
+public:
+  StealQueue() { ink_mutex_init(&_lock); }
+  ~StealQueue() { ink_mutex_destroy(&_lock); }
+
+  void   push(Event *e);
+  Event *take();
+  Event *steal();
+
+  /// Number of events queued, maintained so that thieves can skip empty queues without locking.
+  int
+  depth() const
+  {
+    return _depth.load();
+  }
+
+private:
+  Event *remove(Event *e);
+
+  ink_mutex        _lock;
+  Que(Event, link) _events;
+  std::atomic<int> _depth{0};
+};
+
+inline void
+StealQueue::push(Event *e)
+{
+  ink_assert(!e->in_the_prot_queue && !e->in_the_priority_queue);
+  e->in_the_prot_queue = 1;
+  ink_mutex_acquire(&_lock);
+  _events.enqueue(e);
+  ++_depth;
+  ink_mutex_release(&_lock);
+}
+
+inline Event *
+StealQueue::remove(Event *e)
+{
+  if (e) {
+    _events.remove(e);
+    --_depth;
+    e->in_the_prot_queue = 0;
+  }
+  return e;
+}
+
+inline Event *
+StealQueue::take()
+{
+  if (!depth()) {
+    return nullptr;
+  }
+  ink_mutex_acquire(&_lock);
+  Event *e = remove(_events.head);
+  ink_mutex_release(&_lock);
+  return e;
+}
+
+inline Event *
+StealQueue::steal()
+{
+  if (!depth()) {
+    return nullptr;
+  }
+  ink_mutex_acquire(&_lock);
+  Event *e = remove(_events.tail);
+  ink_mutex_release(&_lock);
+  return e;
+}
@@ -69,6 +69,9 @@ class ProxyMutex;
 
 constexpr int MAX_THREAD_NAME_LENGTH = 16;
 
+/// Size classes of coroutine frames with per thread free lists, see Coroutine.h.
+constexpr int CORO_FRAME_SIZES = 6;
+
 /// The signature of a function to be called by a thread.
 using ThreadFunction = std::function<void()>;
 
@@ -134,11 +137,13 @@ public:
   ProxyAllocator openDirEntryAllocator;
   ProxyAllocator ramCacheCLFUSEntryAllocator;
   ProxyAllocator ramCacheLRUEntryAllocator;
+  ProxyAllocator ramCacheShardedEntryAllocator;
   ProxyAllocator evacuationBlockAllocator;
   ProxyAllocator ioDataAllocator;
   ProxyAllocator ioAllocator;
   ProxyAllocator ioBlockAllocator;
   ProxyAllocator preWarmSMAllocator;
+  ProxyAllocator coroFrameAllocator[CORO_FRAME_SIZES];
   // From InkAPI (plugins wrappers)
   ProxyAllocator apiHookAllocator;
   ProxyAllocator INKContAllocator;
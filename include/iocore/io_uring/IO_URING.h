@@ -25,6 +25,7 @@ Linux io_uring helper library
 
 #include <liburing.h>
 #include <utility>
+#include <vector>
 #include "tscore/ink_hrtime.h"
 
 struct IOUringConfig {
@@ -33,6 +34,7 @@ struct IOUringConfig {
   int attach_wq     = 0;
   int wq_bounded    = 0;
   int wq_unbounded  = 0;
+  int fixed         = 0;
 };
 
 class IOUringCompletionHandler
@@ -74,6 +76,20 @@ public:
 
   int register_eventfd();
 
+  /* Files and buffers registered with every ring. They are recorded process wide
+     and each ring registers them with the kernel before its next lookup, so the
+     kernel does not look up the file or pin the pages on each I/O. Registering
+     does nothing unless IOUringConfig::fixed is set.
+   */
+  static void register_file(int fd);
+  static void register_buffer(void *base, size_t len);
+  static void unregister_buffer(void *base);
+
+  // Index of @a fd in this ring's fixed file table, or -1.
+  int fixed_file(int fd);
+  // Index of the registered buffer holding [@a p, @a p + @a len) in this ring, or -1.
+  int fixed_buffer(const void *p, size_t len);
+
   // assigns the global iouring config
   static void            set_config(const IOUringConfig &);
   static IOUringContext *local_context();
@@ -91,6 +107,12 @@ private:
   io_uring_probe *probe = nullptr;
   int             evfd  = -1;
 
+  // this ring's copy of the registered files and buffers
+  uint64_t           fixed_generation = 0;
+  std::vector<int>   fixed_files;
+  std::vector<iovec> fixed_buffers;
+
   void                 handle_cqe(io_uring_cqe *);
+  void                 sync_fixed();
   static IOUringConfig config;
 };
@@ -120,8 +120,14 @@ public:
   /** Whether the current timeout is a default inactivity timeout. */
   bool use_default_inactivity_timeout = false;
 
+  /** When the InactivityCop looks at the timeouts next, and the slot of its timer wheel this is in. */
+  ink_hrtime cop_check_at       = 0;
+  uint16_t   cop_slot           = UINT16_MAX;
+  int        in_cop_retime_list = 0;
+
   LINK(NetEvent, open_link);
   LINK(NetEvent, cop_link);
+  SLINK(NetEvent, cop_retime_link);
   LINKM(NetEvent, read, ready_link)
   SLINKM(NetEvent, read, enable_link)
   LINKM(NetEvent, write, ready_link)
@@ -28,6 +28,7 @@
 #include "iocore/eventsystem/Continuation.h"
 #include "iocore/eventsystem/EThread.h"
 #include "iocore/net/NetEvent.h"
+#include "tscore/TimerWheel.h"
 
 //
 // NetHandler
@@ -101,7 +102,8 @@ public:
   QueM(NetEvent, NetState, read, ready_link) read_ready_list;
   QueM(NetEvent, NetState, write, ready_link) write_ready_list;
   Que(NetEvent, open_link) open_list;
-  DList(NetEvent, cop_link) cop_list;
+  TimerWheel<NetEvent, NetEvent::Link_cop_link, &NetEvent::cop_check_at, &NetEvent::cop_slot, HRTIME_SECOND> cop_wheel;
+  ASLL(NetEvent, cop_retime_link) cop_retime_list;
   ASLLM(NetEvent, NetState, read, enable_link) read_enable_list;
   ASLLM(NetEvent, NetState, write, enable_link) write_enable_list;
   Que(NetEvent, keep_alive_queue_link) keep_alive_queue;
@@ -198,16 +200,33 @@ public:
 
   /**
     Start to handle active timeout and inactivity timeout on a NetEvent.
-    Put the ne into open_list. All NetEvents in the open_list is checked for
-    timeout by InactivityCop. Only be called when holding the mutex of this
-    NetHandler and must call startIO(ne) first.
+    Put the ne into open_list and file it in cop_wheel for when its timeouts
+    are due, which is when InactivityCop checks it. Only be called when
+    holding the mutex of this NetHandler and must call startIO(ne) first.
 
     @param ne NetEvent to be managed by InactivityCop
    */
   void startCop(NetEvent *ne);
+  /**
+    Have InactivityCop look at the timeouts of a NetEvent again at its next
+    run, because they may now be due earlier than it was filed for. This is
+    needed when a timeout is set, not when one is pushed back. Can be called
+    from any thread holding the mutex of the ne.
+
+    @param ne NetEvent whose timeouts changed.
+   */
+  void retime_cop(NetEvent *ne);
+  /**
+    File ne in cop_wheel for when InactivityCop should check it next, not
+    before @a not_before. Only be called when holding the mutex of this
+    NetHandler.
+   */
+  void file_cop(NetEvent *ne, ink_hrtime now, ink_hrtime not_before = 0);
+  /// File the NetEvents passed to retime_cop() again.
+  void process_cop_retime_list(ink_hrtime now);
   /**
     Stop to handle active timeout and inactivity on a NetEvent.
-    Remove the ne from open_list and cop_list.
+    Remove the ne from open_list and cop_wheel.
     Also remove the ne from keep_alive_queue and active_queue if its context is
     IN. Only be called when holding the mutex of this NetHandler.
 
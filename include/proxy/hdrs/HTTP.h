@@ -1288,6 +1288,12 @@ struct HTTPCacheAlt {
   /// # of fragment offsets in this alternate.
   /// @note This is one less than the number of fragments.
   int m_frag_offset_count = 0;
+  /// Non-zero if this is a sparse object, one stored in fixed size
+  /// fragments of which only some may be present. The fragment table is
+  /// then followed by a bitmap of the fragments that are present.
+  /// @note This occupies what was padding before the fragment table pointer
+  /// so that the marshaled layout of older objects is unchanged.
+  int32_t m_frag_sparse = 0;
   /// Type of offset for a fragment.
   using FragOffset = uint64_t;
   /// Table of fragment offsets.
@@ -1301,6 +1307,19 @@ struct HTTPCacheAlt {
   /// Integral fragment offset table.
   FragOffset m_integral_frag_offsets[N_INTEGRAL_FRAG_OFFSETS];
 
+  /// # of 64 bit words in the fragment presence bitmap.
+  int
+  frag_present_words() const
+  {
+    return m_frag_sparse ? (m_frag_offset_count + 64) / 64 : 0;
+  }
+  /// # of entries in the fragment table, including any presence bitmap.
+  int
+  frag_table_size() const
+  {
+    return m_frag_offset_count + frag_present_words();
+  }
+
   // With clustering, our alt may be in cluster
   //  incoming channel buffer, when we are
   //  destroyed we decrement the refcount
@@ -1347,6 +1366,7 @@ public:
   int        marshal(char *buf, int len);
   static int unmarshal(char *buf, int len, RefCountObj *block_ref);
   static int unmarshal_v24_1(char *buf, int len, RefCountObj *block_ref);
+  static int unmarshal_v24_2(char *buf, int len, RefCountObj *block_ref);
   void       set_buffer_reference(RefCountObj *block_ref);
   int        get_handle(char *buf, int len);
 
@@ -1449,6 +1469,26 @@ public:
   int get_frag_offset_count();
   /// Add an @a offset to the end of the fragment offset table.
   void push_frag_offset(FragOffset offset);
+  /// Get the # of bytes in fragment @a idx, 0 if there is no such fragment.
+  int64_t get_frag_length(int idx);
+
+  /// Check if this is a sparse object.
+  bool is_sparse() const;
+  /** Make this a sparse object with none of its fragments present.
+
+      @param object_size Size of the object, which must need more than one fragment.
+      @param frag_size # of bytes in each fragment but the last.
+  */
+  void init_sparse_frags(int64_t object_size, int64_t frag_size);
+  /// Mark fragment @a idx of a sparse object as present.
+  void mark_frag_present(int idx);
+  /// Check if fragment @a idx is present, always true if the object is not sparse.
+  bool is_frag_present(int idx);
+  /** Check if the bytes from @a start to @a end inclusive are all present.
+
+      @note This is always true if the object is not sparse.
+  */
+  bool is_range_present(int64_t start, int64_t end);
 
   // Sanity check functions
   static bool check_marshalled(char *buf, int len);
@@ -1541,3 +1581,9 @@ HTTPInfo::get_frag_offset_count()
 {
   return m_alt ? m_alt->m_frag_offset_count : 0;
 }
+
+inline bool
+HTTPInfo::is_sparse() const
+{
+  return m_alt && m_alt->m_frag_sparse;
+}
@@ -42,6 +42,8 @@ public:
   void handle_event_count(int event);
   int  handle_event(int event, void *edata);
 
+  void const *profile_target() const override;
+
 protected:
   virtual void clear();
   virtual void free();
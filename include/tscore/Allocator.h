@@ -105,9 +105,9 @@ public:
   /** Re-initialize the parameters of the allocator. */
   void
   re_init(const char *name, unsigned int element_size, unsigned int chunk_size, unsigned int alignment, bool use_hugepages,
-          int advice)
+          int advice, bool use_arena = false)
   {
-    ink_freelist_madvise_init(&this->fl, name, element_size, chunk_size, alignment, use_hugepages, advice);
+    ink_freelist_madvise_init(&this->fl, name, element_size, chunk_size, alignment, use_hugepages, advice, use_arena);
   }
 
   // Dummies
@@ -196,7 +196,7 @@ public:
   /** Re-initialize the parameters of the allocator. */
   void
   re_init(const char * /* name ATS_UNUSED */, unsigned int element_size, unsigned int /* chunk_size ATS_UNUSED */,
-          unsigned int alignment, bool /* use_hugepages ATS_UNUSED */, int advice)
+          unsigned int alignment, bool /* use_hugepages ATS_UNUSED */, int advice, bool /* use_arena ATS_UNUSED */ = false)
   {
     this->element_size = element_size;
     this->alignment    = alignment;
@@ -279,7 +279,7 @@ public:
 
   void
   re_init(const char *name, unsigned int element_size, unsigned int chunk_size, unsigned int alignment, bool use_hugepages,
-          int advice)
+          int advice, bool use_arena = false)
   {
     if (inuse_metric == nullptr) {
       inuse_metric = ts::Metrics::Gauge::createPtr("proxy.process.allocator.inuse.", name);
@@ -289,7 +289,7 @@ public:
     }
     size_metric->store(element_size);
 
-    WrappedAllocator::re_init(name, element_size, chunk_size, alignment, use_hugepages, advice);
+    WrappedAllocator::re_init(name, element_size, chunk_size, alignment, use_hugepages, advice, use_arena);
   }
 
   void
@@ -0,0 +1,242 @@
+/** @file
+
+  Hierarchical timing wheel of intrusive list items.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#pragma once
+
+#include "tscore/ink_assert.h"
+#include "tscore/ink_hrtime.h"
+#include "tscore/List.h"
+
+#include <bit>
+#include <cstdint>
+
+/** Timer wheel with O(1) insertion and removal.
+
+    Time is counted in ticks of @a TICK. Level 0 has a slot for each of the next 64 ticks, and
+    each level above has slots 64 times as wide, so four levels reach 2^24 ticks ahead. Items in
+    the upper levels are moved down a level when the wheel below them wraps. Items due further
+    out than that are kept in the top level and filed again until they are in range.
+
+    The deadline of an item is @a AT and the slot it is in is @a SLOT, both are members of @a C.
+    Items are linked through @a L, which must not be used for anything else while they are in
+    the wheel. The deadline must not be changed while the item is in the wheel, remove it first.
+
+    An item is due in the first tick that ends at or after its deadline, so it is never expired
+    early. The wheel is not thread safe.
+ */
+template <class C, class L, ink_hrtime C::*AT, uint16_t C::*SLOT, ink_hrtime TICK> class TimerWheel
+{
+public:
+  static constexpr int      BITS   = 6;
+  static constexpr int      SLOTS  = 1 << BITS;
+  static constexpr int      LEVELS = 4;
+  static constexpr uint16_t NONE   = UINT16_MAX; ///< @a SLOT value of an item not in the wheel.
+
+  explicit TimerWheel(ink_hrtime now = ink_get_hrtime()) : _cur(now / TICK) {}
+
+  /// Add @a item, due at its deadline. Deadlines in the past are due in the next tick.
+  void insert(C *item);
+  /// Remove @a item if it is in the wheel.
+  void remove(C *item);
+
+  bool
+  in(C const *item) const
+  {
+    return item->*SLOT != NONE;
+  }
+
+  /// Number of items in the wheel.
+  int
+  count() const
+  {
+    return _count;
+  }
+
+  /** Expire everything due at or before @a now.
+
+      @a expire is called for each item due, after it is removed from the wheel. It may insert
+      and remove items, including the one it was called for. Items for which @a early returns
+      true when they are moved down a level are expired then, so that items that are no longer
+      wanted but were left in the wheel are not kept until they are due.
+   */
+  template <typename F, typename E = bool (*)(C *)>
+  void advance(ink_hrtime now, F &&expire, E &&early = [](C *) { return false; });
+
+  /** Earliest time at which advance() might expire something.
+
+      This is exact for items due in the next 64 ticks, for the rest it is the time at which
+      they are moved down a level.
+   */
+  ink_hrtime earliest() const;
+
+private:
+  static uint64_t
+  tick_of(C const *item)
+  {
+    return (item->*AT + TICK - 1) / TICK;
+  }
+
+  template <typename F, typename E> void cascade(int level, F &expire, E &early);
+
+  Queue<C, L> _slot[LEVELS * SLOTS];
+  uint64_t    _used[LEVELS] = {}; ///< Bit per slot of each level, set when the slot is not empty.
+  uint64_t    _cur;               ///< First tick not yet expired.
+  int         _count = 0;
+};
+
+template <class C, class L, ink_hrtime C::*AT, uint16_t C::*SLOT, ink_hrtime TICK>
+void
+TimerWheel<C, L, AT, SLOT, TICK>::insert(C *item)
+{
+  ink_assert(item->*SLOT == NONE);
+
+  uint64_t tick  = std::max(tick_of(item), _cur);
+  uint64_t delta = tick - _cur;
+  int      level = 0;
+  while (level < LEVELS - 1 && delta >= (uint64_t{1} << (BITS * (level + 1)))) {
+    ++level;
+  }
+  if (level == LEVELS - 1 && delta >= (uint64_t{1} << (BITS * LEVELS))) {
+    // Out of range, park it in the last slot it can reach and file it again from there.
+    tick = _cur + (uint64_t{1} << (BITS * LEVELS)) - 1;
+  }
+
+  int index = (tick >> (BITS * level)) & (SLOTS - 1);
+  int slot  = level * SLOTS + index;
+
+  _slot[slot].enqueue(item);
+  _used[level] |= uint64_t{1} << index;
+  item->*SLOT   = slot;
+  ++_count;
+}
+
+template <class C, class L, ink_hrtime C::*AT, uint16_t C::*SLOT, ink_hrtime TICK>
+void
+TimerWheel<C, L, AT, SLOT, TICK>::remove(C *item)
+{
+  int slot = item->*SLOT;
+  if (slot == NONE) {
+    return;
+  }
+
+  _slot[slot].remove(item);
+  if (_slot[slot].empty()) {
+    _used[slot / SLOTS] &= ~(uint64_t{1} << (slot % SLOTS));
+  }
+  item->*SLOT = NONE;
+  --_count;
+}
+
+template <class C, class L, ink_hrtime C::*AT, uint16_t C::*SLOT, ink_hrtime TICK>
+template <typename F, typename E>
+void
+TimerWheel<C, L, AT, SLOT, TICK>::cascade(int level, F &expire, E &early)
+{
+  int          index = (_cur >> (BITS * level)) & (SLOTS - 1);
+  Queue<C, L> &q     = _slot[level * SLOTS + index];
+
+  // Nothing goes back in this slot, it is a full turn of this level ahead.
+  while (C *item = q.dequeue()) {
+    item->*SLOT = NONE;
+    --_count;
+    if (early(item)) {
+      expire(item);
+    } else {
+      insert(item);
+    }
+  }
+  _used[level] &= ~(uint64_t{1} << index);
+}
+
+template <class C, class L, ink_hrtime C::*AT, uint16_t C::*SLOT, ink_hrtime TICK>
+template <typename F, typename E>
+void
+TimerWheel<C, L, AT, SLOT, TICK>::advance(ink_hrtime now, F &&expire, E &&early)
+{
+  uint64_t last = now / TICK;
+
+  while (_cur <= last) {
+    if (_count == 0) {
+      _cur = last + 1;
+      break;
+    }
+
+    int index = _cur & (SLOTS - 1);
+
+    // Going into a new span of level 0, move down what is due in it.
+    if (index == 0) {
+      for (int level = 1; level < LEVELS; ++level) {
+        cascade(level, expire, early);
+        if ((_cur >> (BITS * level)) & (SLOTS - 1)) {
+          break;
+        }
+      }
+    }
+
+    // Items put in this slot by @a expire are due next time around, behind the ones due now.
+    Queue<C, L> &q    = _slot[index];
+    uint64_t     tick = _cur++;
+
+    while (q.head && tick_of(q.head) <= tick) {
+      C *item     = q.dequeue();
+      item->*SLOT = NONE;
+      --_count;
+      expire(item);
+    }
+    if (q.empty()) {
+      _used[0] &= ~(uint64_t{1} << index);
+    }
+
+    // Skip the empty slots up to the start of the next span.
+    if (_cur & (SLOTS - 1)) {
+      uint64_t ahead = _used[0] >> (_cur & (SLOTS - 1));
+      uint64_t next  = ahead ? _cur + std::countr_zero(ahead) : (_cur | (SLOTS - 1)) + 1;
+      _cur           = std::min(next, std::max(_cur, last + 1));
+    }
+  }
+}
+
+template <class C, class L, ink_hrtime C::*AT, uint16_t C::*SLOT, ink_hrtime TICK>
+ink_hrtime
+TimerWheel<C, L, AT, SLOT, TICK>::earliest() const
+{
+  int      shift = _cur & (SLOTS - 1);
+  uint64_t span  = (_cur | (SLOTS - 1)) + 1;
+  bool     upper = _used[1] | _used[2] | _used[3];
+
+  // Upper levels are not exact, but nothing in them is due before they are moved down.
+  if (shift == 0 && upper) {
+    return _cur * TICK;
+  }
+  // Slots before the current one are for the next span.
+  if (uint64_t ahead = _used[0] >> shift; ahead) {
+    return (_cur + std::countr_zero(ahead)) * TICK;
+  }
+  if (upper) {
+    return span * TICK;
+  }
+  if (_used[0]) {
+    return (span + std::countr_zero(_used[0])) * TICK;
+  }
+  return _cur * TICK + HRTIME_FOREVER;
+}
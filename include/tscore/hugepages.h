@@ -27,3 +27,22 @@ bool   ats_hugepage_enabled();
 void   ats_hugepage_init(int);
 void  *ats_alloc_hugepage(size_t);
 bool   ats_free_hugepage(void *, size_t);
+
+/** Arena that allocations are carved out of, backed by huge pages.
+
+    Regions of @a region_size bytes, rounded up to @a page_size, are mapped with huge pages of
+    @a page_size (2 MB or 1 GB) as they are needed. If that fails the region is mapped with
+    normal pages instead and transparent huge pages are requested for it. Memory carved out of
+    the arena is never given back.
+ */
+void  ats_hugepage_arena_init(size_t page_size, size_t region_size);
+bool  ats_hugepage_arena_enabled();
+void *ats_hugepage_arena_alloc(size_t size, size_t alignment);
+
+struct HugepageArenaStats {
+  size_t hugepage_bytes = 0; ///< Mapped with huge pages.
+  size_t fallback_bytes = 0; ///< Mapped with normal pages because huge pages were not available.
+  size_t used_bytes     = 0; ///< Carved out of the regions.
+  size_t failures       = 0; ///< Regions that could not be mapped with huge pages.
+};
+HugepageArenaStats ats_hugepage_arena_stats();
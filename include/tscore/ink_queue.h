@@ -177,14 +177,27 @@ union head_p {
 #error "unsupported processor"
 #endif
 
+/// NUMA nodes that get free lists of their own, threads on the nodes above this share them.
+#define INK_FREELIST_NODES 4
+
+/// Free items of a free list for the threads of one NUMA node, on a cache line of its own.
+struct alignas(64) InkFreeListNode {
+  head_p  head;       ///< Items freed by the threads of the node.
+  head_p  cold;       ///< Items whose pages were given back by ink_freelists_reclaim().
+  int32_t free;       ///< Items in @a head.
+  int32_t min_free;   ///< Fewest items in @a head since the last reclaim.
+  int32_t cold_count; ///< Items in @a cold.
+};
+
 struct _InkFreeList {
-  head_p      head;
-  const char *name;
-  uint32_t    type_size, chunk_size, used, allocated, alignment;
-  uint32_t    allocated_base, used_base;
-  uint32_t    hugepages_failure;
-  bool        use_hugepages;
-  int         advice;
+  InkFreeListNode node[INK_FREELIST_NODES];
+  const char     *name;
+  uint32_t        type_size, chunk_size, used, allocated, alignment;
+  uint32_t        allocated_base, used_base;
+  uint32_t        hugepages_failure;
+  bool            use_hugepages;
+  bool            use_arena; ///< Carve chunks out of the huge page arena, see ats_hugepage_arena_alloc().
+  int             advice;
 };
 
 using InkFreeListOps = struct ink_freelist_ops;
@@ -203,11 +216,29 @@ InkFreeList *ink_freelist_create(const char *name, uint32_t type_size, uint32_t
 void  ink_freelist_init(InkFreeList **fl, const char *name, uint32_t type_size, uint32_t chunk_size, uint32_t alignment,
                         bool use_hugepages);
 void  ink_freelist_madvise_init(InkFreeList **fl, const char *name, uint32_t type_size, uint32_t chunk_size, uint32_t alignment,
-                                bool use_hugepages, int advice);
+                                bool use_hugepages, int advice, bool use_arena = false);
 void *ink_freelist_new(InkFreeList *f);
 void  ink_freelist_free(InkFreeList *f, void *item);
 void  ink_freelist_free_bulk(InkFreeList *f, void *head, void *tail, size_t num_item);
 void  ink_freelists_dump(FILE *f);
+
+/** Allocate and free items through the free lists of NUMA node @a node on this thread.
+
+    Items freed by a thread go to the lists of its node, and it allocates from those before it
+    takes items from other nodes. Pages of new chunks are placed by the kernel on the node of the
+    thread that first touches them. Threads that do not set a node use node 0.
+ */
+void ink_freelist_set_thread_node(int node);
+
+/** Give back to the OS the pages of free items that have not been used since the last call.
+
+    Only items of two pages or more are reclaimed. The first page of an item is kept, the rest
+    are dropped with madvise and are faulted in again as zero pages when the item is next used.
+    These items are allocated after the recently freed ones, but before a new chunk.
+
+    @return The number of bytes given back.
+ */
+size_t ink_freelists_reclaim();
 void  ink_freelists_dump_baselinerel(FILE *f);
 void  ink_freelists_snap_baseline();
 
@@ -0,0 +1,303 @@
+/**
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+/**
+ * @file Coroutine.h
+ * @brief C++20 coroutines over TSCont, TSVIO and the cache API.
+ */
+
+#pragma once
+
+#include <ts/ts.h>
+
+#include "tscpp/api/Continuation.h"
+
+#include <array>
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace atscppapi::coro
+{
+/// What an awaited operation called back with.
+struct Result {
+  TSEvent event = TS_EVENT_NONE;
+  void   *data  = nullptr;
+};
+
+/// The event a VIO called back with.
+struct IOEvent {
+  TSEvent event = TS_EVENT_NONE;
+  TSVIO   vio   = nullptr;
+};
+
+/** Coroutine run by the event system.
+ *
+ * It starts in the caller and runs up to its first co_await, after that it is resumed by the
+ * continuation that was called back, with the mutex of the coroutine held. That is the mutex of the
+ * atscppapi::Continuation if it is the first parameter, otherwise a new one. The caller must hold it
+ * for the start if it is shared.
+ *
+ * The frame is freed when the coroutine returns, by then the VConns it read or wrote must be closed.
+ */
+class Task
+{
+public:
+  /// State of the continuation for the VIOs of a coroutine.
+  struct IOState {
+    TSVIO                   awaiting = nullptr; ///< VIO the coroutine is suspended on.
+    TSEvent                 event    = TS_EVENT_NONE;
+    std::coroutine_handle<> handle;
+    /// Latest event of each VIO that called back while the coroutine was not waiting for it.
+    std::array<std::pair<TSVIO, TSEvent>, 4> pending{};
+
+    /// Take the event kept for @a vio, if there is one.
+    bool
+    take(TSVIO vio)
+    {
+      for (auto &[v, e] : pending) {
+        if (v == vio) {
+          event = e;
+          v     = nullptr;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    static int
+    handle_event(TSCont cont, TSEvent e, void *data)
+    {
+      auto *self = static_cast<IOState *>(TSContDataGet(cont));
+      auto  vio  = static_cast<TSVIO>(data);
+
+      if (vio == self->awaiting) {
+        self->awaiting = nullptr;
+        self->event    = e;
+        self->handle.resume();
+        return 0;
+      }
+
+      std::pair<TSVIO, TSEvent> *slot = nullptr;
+      for (auto &p : self->pending) {
+        if (p.first == vio) {
+          slot = &p;
+          break;
+        }
+        if (p.first == nullptr && slot == nullptr) {
+          slot = &p;
+        }
+      }
+      TSReleaseAssert(slot != nullptr);
+      *slot = {vio, e};
+      return 0;
+    }
+  };
+
+  struct promise_type {
+    TSMutex mutex;
+    IOState io_state;
+    TSCont  io;
+
+    template <typename C, typename... Args>
+      requires std::derived_from<C, atscppapi::Continuation>
+    explicit promise_type(C &cont, Args &...) : mutex(cont.mutex()), io(TSContCreate(&IOState::handle_event, mutex))
+    {
+      TSContDataSet(io, &io_state);
+    }
+    template <typename... Args>
+    explicit promise_type(Args &...) : mutex(TSMutexCreate()), io(TSContCreate(&IOState::handle_event, mutex))
+    {
+      TSContDataSet(io, &io_state);
+    }
+    ~promise_type() { TSContDestroy(io); }
+
+    Task
+    get_return_object() noexcept
+    {
+      return {};
+    }
+    std::suspend_never
+    initial_suspend() noexcept
+    {
+      return {};
+    }
+    std::suspend_never
+    final_suspend() noexcept
+    {
+      return {};
+    }
+    void
+    return_void() noexcept
+    {
+    }
+    void
+    unhandled_exception() noexcept
+    {
+      std::terminate();
+    }
+
+    // Plugins have no access to the per thread free lists of the core.
+    static void *
+    operator new(size_t size)
+    {
+      return TSmalloc(size);
+    }
+    static void
+    operator delete(void *p)
+    {
+      TSfree(p);
+    }
+  };
+};
+
+/// Awaits one callback to a TSCont of its own, which @a start passes on.
+template <typename F> class Callback
+{
+public:
+  explicit Callback(F start) : _start(std::move(start)) {}
+
+  bool
+  await_ready() const noexcept
+  {
+    return false;
+  }
+
+  void
+  await_suspend(std::coroutine_handle<Task::promise_type> h)
+  {
+    _handle   = h;
+    TSCont cb = TSContCreate(&Callback::handle_event, h.promise().mutex);
+    TSContDataSet(cb, this);
+    // The frame may be gone once this returns.
+    _start(cb);
+  }
+
+  Result
+  await_resume() const noexcept
+  {
+    return _result;
+  }
+
+private:
+  static int
+  handle_event(TSCont cont, TSEvent event, void *data)
+  {
+    auto *self    = static_cast<Callback *>(TSContDataGet(cont));
+    self->_result = {event, data};
+    TSContDestroy(cont);
+    self->_handle.resume();
+    return 0;
+  }
+
+  F                       _start;
+  Result                  _result;
+  std::coroutine_handle<> _handle;
+};
+
+/// Call @a start with a TSCont and resume with what it is called back with.
+template <typename F>
+Callback<F>
+call(F start)
+{
+  return Callback<F>{std::move(start)};
+}
+
+/// Resume after @a timeout milliseconds, on this thread.
+inline auto
+schedule_in(TSHRTime timeout)
+{
+  return call([timeout](TSCont c) { TSContScheduleOnThread(c, timeout, TSEventThreadSelf()); });
+}
+
+/// Resume in the next pass of the event loop of this thread.
+inline auto
+schedule_imm()
+{
+  return schedule_in(0);
+}
+
+/// Open @a key for reading, resumes with TS_EVENT_CACHE_OPEN_READ and the TSVConn or the failure.
+inline auto
+cache_read(TSCacheKey key)
+{
+  return call([key](TSCont c) { TSCacheRead(c, key); });
+}
+
+/// Awaits the next event of the VIO that @a start returns, see Task::IOState.
+template <typename F> class IO
+{
+public:
+  explicit IO(F start) : _start(std::move(start)) {}
+
+  bool
+  await_ready() const noexcept
+  {
+    return false;
+  }
+
+  bool
+  await_suspend(std::coroutine_handle<Task::promise_type> h)
+  {
+    _io  = &h.promise().io_state;
+    _vio = _start(h.promise().io);
+    if (_io->take(_vio)) {
+      return false;
+    }
+    _io->awaiting = _vio;
+    _io->handle   = h;
+    return true;
+  }
+
+  IOEvent
+  await_resume() const noexcept
+  {
+    return {_io->event, _vio};
+  }
+
+private:
+  F              _start;
+  Task::IOState *_io  = nullptr;
+  TSVIO          _vio = nullptr;
+};
+
+/// Start reading @a nbytes from @a vc into @a buf and resume with the first event.
+inline auto
+vio_read(TSVConn vc, TSIOBuffer buf, int64_t nbytes)
+{
+  return IO{[=](TSCont c) { return TSVConnRead(vc, c, buf, nbytes); }};
+}
+
+/// Start writing @a nbytes from @a reader to @a vc and resume with the first event.
+inline auto
+vio_write(TSVConn vc, TSIOBufferReader reader, int64_t nbytes)
+{
+  return IO{[=](TSCont c) { return TSVConnWrite(vc, c, reader, nbytes); }};
+}
+
+/// Reenable @a vio and resume with its next event.
+inline auto
+vio_next(TSVIO vio)
+{
+  return IO{[vio](TSCont) {
+    TSVIOReenable(vio);
+    return vio;
+  }};
+}
+} // namespace atscppapi::coro
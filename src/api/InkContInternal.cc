@@ -86,6 +86,13 @@ INKContInternal::init(TSEventFunc funcp, TSMutex mutexp, void *context)
   m_context    = context;
 }
 
+void const *
+INKContInternal::profile_target() const
+{
+  // Charge the time to the plugin rather than to the API.
+  return reinterpret_cast<void const *>(m_event_func);
+}
+
 void
 INKContInternal::clear()
 {
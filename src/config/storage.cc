@@ -63,6 +63,7 @@ constexpr char KEY_RAM_CACHE_SIZE[]   = "ram_cache_size";
 constexpr char KEY_RAM_CACHE_CUTOFF[] = "ram_cache_cutoff";
 constexpr char KEY_AVG_OBJ_SIZE[]     = "avg_obj_size";
 constexpr char KEY_FRAGMENT_SIZE[]    = "fragment_size";
+constexpr char KEY_LOWER_TIER[]       = "lower_tier";
 
 // YAML key names - volume span refs
 constexpr char KEY_USE[] = "use";
@@ -73,7 +74,8 @@ std::set<std::string> const valid_cache_keys   = {KEY_SPANS, KEY_VOLUMES};
 std::set<std::string> const valid_span_keys    = {KEY_NAME, KEY_PATH, KEY_SIZE, KEY_HASH_SEED};
 std::set<std::string> const valid_volume_keys  = {KEY_ID,           KEY_SCHEME,         KEY_SIZE,
                                                   KEY_RAM_CACHE,    KEY_RAM_CACHE_SIZE, KEY_RAM_CACHE_CUTOFF,
-                                                  KEY_AVG_OBJ_SIZE, KEY_FRAGMENT_SIZE,  KEY_SPANS};
+                                                  KEY_AVG_OBJ_SIZE, KEY_FRAGMENT_SIZE,  KEY_LOWER_TIER,
+                                                  KEY_SPANS};
 std::set<std::string> const valid_spanref_keys = {KEY_USE, KEY_SIZE};
 
 /**
@@ -567,6 +569,13 @@ template <> struct convert<config::StorageVolumeEntry> {
       vol.fragment_size = static_cast<int>(v);
     }
 
+    if (node[KEY_LOWER_TIER]) {
+      vol.lower_tier = node[KEY_LOWER_TIER].as<int>();
+      if (vol.lower_tier < 1 || MAX_VOLUME_IDX < vol.lower_tier || vol.lower_tier == vol.id) {
+        throw ParserException(node.Mark(), "invalid 'lower_tier' volume id: " + node[KEY_LOWER_TIER].as<std::string>());
+      }
+    }
+
     if (node[KEY_SPANS]) {
       YAML::Node spans_node = node[KEY_SPANS];
       if (!spans_node.IsSequence()) {
@@ -689,6 +698,22 @@ StorageParser::parse_content(std::string_view content)
 
         result.volumes.push_back(std::move(vol));
       }
+
+      // A lower tier must be another volume, which does not have a lower tier itself.
+      for (auto const &vol : result.volumes) {
+        if (vol.lower_tier == 0) {
+          continue;
+        }
+        auto lower = std::find_if(result.volumes.begin(), result.volumes.end(),
+                                  [&vol](StorageVolumeEntry const &v) { return v.id == vol.lower_tier; });
+        if (lower == result.volumes.end()) {
+          return {result, swoc::Errata(ERRATA_ERROR_SEV, "volume {} has undefined lower_tier volume {}", vol.id, vol.lower_tier)};
+        }
+        if (lower->lower_tier != 0) {
+          return {result, swoc::Errata(ERRATA_ERROR_SEV, "lower_tier volume {} of volume {} has a lower_tier itself", lower->id,
+                                       vol.id)};
+        }
+      }
     }
 
   } catch (std::exception const &ex) {
@@ -802,6 +827,9 @@ StorageMarshaller::to_yaml(StorageConfig const &config)
       if (vol.fragment_size >= 0) {
         out << YAML::Key << KEY_FRAGMENT_SIZE << YAML::Value << std::to_string(vol.fragment_size);
       }
+      if (vol.lower_tier > 0) {
+        out << YAML::Key << KEY_LOWER_TIER << YAML::Value << vol.lower_tier;
+      }
       if (!vol.spans.empty()) {
         out << YAML::Key << KEY_SPANS << YAML::Value << YAML::BeginSeq;
         for (auto const &sr : vol.spans) {
@@ -872,6 +900,9 @@ StorageMarshaller::to_json(StorageConfig const &config)
       if (vol.fragment_size >= 0) {
         out << YAML::Key << KEY_FRAGMENT_SIZE << YAML::Value << std::to_string(vol.fragment_size);
       }
+      if (vol.lower_tier > 0) {
+        out << YAML::Key << KEY_LOWER_TIER << YAML::Value << vol.lower_tier;
+      }
       if (!vol.spans.empty()) {
         out << YAML::Key << KEY_SPANS << YAML::Value << YAML::BeginSeq;
         for (auto const &sr : vol.spans) {
@@ -171,6 +171,7 @@ static constexpr char FULL_YAML[] = R"(cache:
       ram_cache_cutoff: 256K
       avg_obj_size: 8K
       fragment_size: 512K
+      lower_tier: 2
     - id: 2
       spans:
         - use: span-1
@@ -202,12 +203,14 @@ TEST_CASE("StorageParser parses full spans+volumes config", "[storage][parser][f
     CHECK(vol.ram_cache_cutoff == 256LL * 1024);
     CHECK(vol.avg_obj_size == 8 * 1024);
     CHECK(vol.fragment_size == 512 * 1024);
+    CHECK(vol.lower_tier == 2);
   }
 
   SECTION("Volume 2 with span refs")
   {
     auto const &vol = result.value.volumes[1];
     CHECK(vol.id == 2);
+    CHECK(vol.lower_tier == 0);
     REQUIRE(vol.spans.size() == 2);
     CHECK(vol.spans[0].use == "span-1");
     CHECK(vol.spans[0].size.in_percent);
@@ -250,6 +253,28 @@ TEST_CASE("StorageParser returns error when percent total exceeds 100", "[storag
   CHECK_FALSE(result.ok());
 }
 
+TEST_CASE("StorageParser returns error for invalid lower_tier", "[storage][parser][error]")
+{
+  SECTION("Undefined volume")
+  {
+    auto result = parse_file("cache:\n  volumes:\n    - id: 1\n      lower_tier: 2\n");
+    CHECK_FALSE(result.ok());
+  }
+
+  SECTION("Itself")
+  {
+    auto result = parse_file("cache:\n  volumes:\n    - id: 1\n      lower_tier: 1\n");
+    CHECK_FALSE(result.ok());
+  }
+
+  SECTION("Chained tiers")
+  {
+    auto result = parse_file("cache:\n  volumes:\n    - id: 1\n      lower_tier: 2\n    - id: 2\n      lower_tier: 3\n"
+                             "    - id: 3\n");
+    CHECK_FALSE(result.ok());
+  }
+}
+
 TEST_CASE("StorageParser returns error for missing file", "[storage][parser][error]")
 {
   StorageParser parser;
@@ -866,5 +891,6 @@ TEST_CASE("Round-trip: parse -> marshal -> parse", "[storage][roundtrip]")
   for (size_t i = 0; i < initial.value.volumes.size(); ++i) {
     CHECK(initial.value.volumes[i].id == round_trip.value.volumes[i].id);
     CHECK(initial.value.volumes[i].scheme == round_trip.value.volumes[i].scheme);
+    CHECK(initial.value.volumes[i].lower_tier == round_trip.value.volumes[i].lower_tier);
   }
 }
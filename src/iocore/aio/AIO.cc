@@ -142,6 +142,7 @@ struct AIOStatsBlock {
   ts::Metrics::Counter::AtomicType *kb_read;
   ts::Metrics::Counter::AtomicType *write_count;
   ts::Metrics::Counter::AtomicType *kb_write;
+  ts::Metrics::Counter::AtomicType *fixed_count;
 };
 
 AIOStatsBlock aio_rsb;
@@ -192,6 +193,7 @@ ink_aio_init(ts::ModuleVersion v, [[maybe_unused]] AIOBackend backend)
   aio_rsb.write_count = ts::Metrics::Counter::createPtr("proxy.process.cache.aio.write_count");
   aio_rsb.kb_read     = ts::Metrics::Counter::createPtr("proxy.process.cache.aio.KB_read");
   aio_rsb.kb_write    = ts::Metrics::Counter::createPtr("proxy.process.cache.aio.KB_write");
+  aio_rsb.fixed_count = ts::Metrics::Counter::createPtr("proxy.process.cache.aio.fixed_count");
 
   memset(&aio_reqs, 0, MAX_DISKS_POSSIBLE * sizeof(AIO_Reqs *));
   ink_mutex_init(&insert_mutex);
@@ -601,6 +603,32 @@ setup_prep_ops(IOUringContext *ur)
   }
 }
 
+/*
+ * Use the ring's registered file and buffer for the op when it has them. A registered buffer
+ * saves pinning the pages for each I/O, a registered file saves the fd lookup.
+ */
+void
+prep_fixed_op(IOUringContext *ur, io_uring_sqe *sqe, AIOCallback *op, int op_type)
+{
+  int file = ur->fixed_file(op->aiocb.aio_fildes);
+  int buf  = file < 0 ? -1 : ur->fixed_buffer(op->aiocb.aio_buf, op->aiocb.aio_nbytes);
+
+  if (buf < 0) {
+    prep_ops[op_type](sqe, op);
+  } else if (op_type == LIO_READ) {
+    io_uring_prep_read_fixed(sqe, file, op->aiocb.aio_buf, op->aiocb.aio_nbytes, op->aiocb.aio_offset, buf);
+  } else {
+    io_uring_prep_write_fixed(sqe, file, op->aiocb.aio_buf, op->aiocb.aio_nbytes, op->aiocb.aio_offset, buf);
+  }
+  if (buf >= 0) {
+    ts::Metrics::Counter::increment(aio_rsb.fixed_count);
+  }
+  if (file >= 0) {
+    sqe->fd     = file;
+    sqe->flags |= IOSQE_FIXED_FILE;
+  }
+}
+
 void
 io_uring_prep_ops_internal(AIOCallback *op_in, int op_type)
 {
@@ -612,7 +640,7 @@ io_uring_prep_ops_internal(AIOCallback *op_in, int op_type)
 
     ink_release_assert(sqe != nullptr);
 
-    prep_ops[op_type](sqe, op);
+    prep_fixed_op(ur, sqe, op, op_type);
 
     op->aiocb.aio_lio_opcode = op_type;
     if (op->then) {
@@ -676,6 +704,34 @@ AIOCallback::handle_complete(io_uring_cqe *cqe)
 
 #endif
 
+void
+ink_aio_register_fd([[maybe_unused]] int fd)
+{
+#if TS_USE_LINUX_IO_URING
+  if (use_io_uring) {
+    IOUringContext::register_file(fd);
+  }
+#endif
+}
+
+void
+ink_aio_register_buffer([[maybe_unused]] void *buf, [[maybe_unused]] size_t len)
+{
+#if TS_USE_LINUX_IO_URING
+  if (use_io_uring) {
+    IOUringContext::register_buffer(buf, len);
+  }
+#endif
+}
+
+void
+ink_aio_unregister_buffer([[maybe_unused]] void *buf)
+{
+#if TS_USE_LINUX_IO_URING
+  IOUringContext::unregister_buffer(buf);
+#endif
+}
+
 int
 ink_aio_read(AIOCallback *op_in, int fromAPI)
 {
@@ -0,0 +1,78 @@
+/** @file
+
+  Adaptive flushing of a stripe's aggregation buffer
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "AggregateFlushPolicy.h"
+
+#include <algorithm>
+
+// Weight of the newest sample in the latency average, 1/2^N.
+#define LATENCY_AVERAGE_SHIFT 3
+// Data waits at most this many average write times before it is flushed.
+#define FLUSH_DELAY_WRITES 2
+
+void
+AggregateFlushPolicy::configure(ink_hrtime target_latency, ink_hrtime max_delay)
+{
+  this->_target_latency = std::max<ink_hrtime>(target_latency, 0);
+  this->_max_delay      = std::max(max_delay, MIN_DELAY);
+  this->_flush_size     = AGG_HIGH_WATER;
+}
+
+void
+AggregateFlushPolicy::write_done(ink_hrtime latency, int backlog)
+{
+  if (this->_latency == 0) {
+    this->_latency = latency;
+  } else {
+    this->_latency += (latency - this->_latency) >> LATENCY_AVERAGE_SHIFT;
+  }
+  if (!this->is_adaptive()) {
+    return;
+  }
+
+  // Shrink quickly when over the target, grow slowly and only when there is
+  // enough queued to fill a larger write.
+  if (this->_latency > this->_target_latency) {
+    this->_flush_size = std::max(this->_flush_size / 2, MIN_FLUSH_SIZE);
+  } else if (this->_latency < this->_target_latency / 2 && backlog >= this->_flush_size) {
+    this->_flush_size = std::min(this->_flush_size + this->_flush_size / 4, AGG_HIGH_WATER);
+  }
+}
+
+ink_hrtime
+AggregateFlushPolicy::flush_delay() const
+{
+  if (this->_latency == 0) {
+    return this->_max_delay;
+  }
+  return std::clamp(FLUSH_DELAY_WRITES * this->_latency, MIN_DELAY, this->_max_delay);
+}
+
+bool
+AggregateFlushPolicy::should_flush(int bytes, ink_hrtime filled_at, ink_hrtime now) const
+{
+  if (bytes >= this->_flush_size) {
+    return true;
+  }
+  return this->is_adaptive() && bytes > 0 && now - filled_at >= this->flush_delay();
+}
@@ -0,0 +1,125 @@
+/** @file
+
+  Adaptive flushing of a stripe's aggregation buffer
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#pragma once
+
+#include "AggregateWriteBuffer.h"
+
+#include "tscore/ink_hrtime.h"
+
+#include <algorithm>
+
+/**
+ * Decide when an aggregation buffer is written to disk.
+ *
+ * Without a latency target the buffer is written once it holds
+ * AGG_HIGH_WATER bytes, or sooner if a writer is waiting for a sync or the
+ * pending writes do not fit.
+ *
+ * With a target the flush size follows the observed write latency: a
+ * moving average above the target shrinks it, so a large write does not
+ * hold up reads on the same device, and a fast write with more data queued
+ * behind it grows it back. A buffer that fills slowly is written once its
+ * oldest data has waited a few write times, bounded by the maximum delay,
+ * rather than sitting in memory until the next directory sync.
+ *
+ * Like the aggregation buffer this is protected by the stripe mutex.
+ */
+class AggregateFlushPolicy
+{
+public:
+  static constexpr int        MIN_FLUSH_SIZE = 256 * 1024;
+  static constexpr ink_hrtime MIN_DELAY      = HRTIME_MSECONDS(1);
+
+  /**
+   * Set the latency target and the longest a buffer may wait.
+   *
+   * @param target_latency Target time for one aggregation write, 0 for the
+   *   fixed AGG_HIGH_WATER policy.
+   * @param max_delay The longest data may wait in a buffer that is not full.
+   */
+  void configure(ink_hrtime target_latency, ink_hrtime max_delay);
+
+  bool
+  is_adaptive() const
+  {
+    return this->_target_latency > 0;
+  }
+
+  /**
+   * Account for a completed aggregation write.
+   *
+   * @param latency Time from issuing the write to its completion.
+   * @param backlog Bytes still waiting to be aggregated.
+   */
+  void write_done(ink_hrtime latency, int backlog);
+
+  /**
+   * @return The buffer size at which a write is issued.
+   */
+  int
+  flush_size() const
+  {
+    return this->_flush_size;
+  }
+
+  /**
+   * @return The most bytes to aggregate into one write, twice the flush size
+   *   like AGG_SIZE is to AGG_HIGH_WATER.
+   */
+  int
+  write_limit() const
+  {
+    return std::min(2 * this->_flush_size, AGG_SIZE);
+  }
+
+  /**
+   * @return How long the oldest data in a buffer may wait before the buffer
+   *   is written regardless of its size.
+   */
+  ink_hrtime flush_delay() const;
+
+  /**
+   * Check whether a buffer should be written now.
+   *
+   * @param bytes Bytes in the buffer.
+   * @param filled_at When the first of those bytes were added.
+   * @param now The current time.
+   */
+  bool should_flush(int bytes, ink_hrtime filled_at, ink_hrtime now) const;
+
+  /**
+   * @return The moving average of the write latency, 0 before the first write.
+   */
+  ink_hrtime
+  write_latency() const
+  {
+    return this->_latency;
+  }
+
+private:
+  ink_hrtime _target_latency = 0;
+  ink_hrtime _max_delay      = 0;
+  ink_hrtime _latency        = 0;
+  int        _flush_size     = AGG_HIGH_WATER;
+};
@@ -25,6 +25,7 @@
 
 #include "P_CacheDoc.h"
 
+#include "iocore/aio/AIO.h"
 #include "iocore/eventsystem/Continuation.h"
 
 #include "tscore/ink_memory.h"
@@ -44,9 +45,14 @@ public:
   {
     this->_buffer = static_cast<char *>(ats_memalign(ats_pagesize(), AGG_SIZE));
     memset(this->_buffer, 0, AGG_SIZE);
+    ink_aio_register_buffer(this->_buffer, AGG_SIZE);
   }
 
-  ~AggregateWriteBuffer() { ats_free(this->_buffer); }
+  ~AggregateWriteBuffer()
+  {
+    ink_aio_unregister_buffer(this->_buffer);
+    ats_free(this->_buffer);
+  }
 
   AggregateWriteBuffer(AggregateWriteBuffer const &)            = delete;
   AggregateWriteBuffer &operator=(AggregateWriteBuffer const &) = delete;
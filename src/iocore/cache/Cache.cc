@@ -57,6 +57,8 @@ constexpr ts::VersionNumber CACHE_DB_VERSION(CACHE_DB_MAJOR_VERSION, CACHE_DB_MI
 
 int64_t cache_config_ram_cache_size                = AUTO_SIZE_RAM_CACHE;
 int     cache_config_ram_cache_algorithm           = 1;
+int     cache_config_ram_cache_admission           = 0;
+int     cache_config_ram_cache_shards              = 0;
 int     cache_config_ram_cache_compress            = 0;
 int     cache_config_ram_cache_compress_percent    = 90;
 int     cache_config_ram_cache_use_seen_filter     = 1;
@@ -66,6 +68,7 @@ int     cache_config_dir_sync_frequency            = 60;
 int     cache_config_dir_sync_delay                = 500;
 int     cache_config_dir_sync_max_write            = (2 * 1024 * 1024);
 int     cache_config_dir_sync_parallel_tasks       = 1;
+int     cache_config_dir_sync_incremental          = 1;
 int     cache_config_permit_pinning                = 0;
 int     cache_config_select_alternate              = 1;
 int     cache_config_max_doc_size                  = 0;
@@ -83,7 +86,12 @@ int     cache_config_read_while_writer             = 0;
 int     cache_config_mutex_retry_delay             = 2;
 int     cache_read_while_writer_retry_delay        = 50;
 int     cache_config_read_while_writer_max_retries = 10;
+int     cache_config_read_while_writer_fanout      = 4;
 int     cache_config_persist_bad_disks             = false;
+int     cache_config_tier_promote_hits             = 2;
+int     cache_config_tier_demote_hits              = 1;
+int     cache_config_agg_write_target_latency      = 0;
+int     cache_config_agg_write_max_delay           = 100;
 
 // Globals
 
@@ -157,6 +165,41 @@ update_cache_config(const char * /* name ATS_UNUSED */, RecDataT /* data_type AT
   return 0;
 }
 
+static void
+init_tier_frequency(CacheVol *cp)
+{
+  for (int i = 0; i < cp->num_vols; i++) {
+    cp->stripes[i]->tier_frequency.init(cp->stripes[i]->directory.entries());
+  }
+}
+
+// Link each volume with a lower_tier to the stripes of that volume.
+static void
+init_cache_tiers()
+{
+  for (ConfigVol *config_vol = config_volumes.cp_queue.head; config_vol; config_vol = config_vol->link.next) {
+    if (config_vol->lower_tier <= 0 || !config_vol->cachep || config_vol->cachep->lower_tier) {
+      continue;
+    }
+
+    char             errbuf[256];
+    std::string      lower = std::to_string(config_vol->lower_tier);
+    CacheHostRecord *rec   = createCacheHostRecord(lower.c_str(), errbuf, sizeof(errbuf));
+    if (rec == nullptr || rec->num_vols == 0) {
+      Warning("volume %d: lower tier volume %d has no stripes, tiering disabled", config_vol->number, config_vol->lower_tier);
+      delete rec;
+      continue;
+    }
+
+    config_vol->cachep->lower_tier = rec;
+    init_tier_frequency(config_vol->cachep);
+    for (int i = 0; i < rec->num_cachevols; i++) {
+      init_tier_frequency(rec->cp[i]);
+    }
+    Dbg(dbg_ctl_cache_init, "volume %d demotes to volume %d", config_vol->number, config_vol->lower_tier);
+  }
+}
+
 static_assert(static_cast<int>(TS_EVENT_CACHE_OPEN_READ) == static_cast<int>(CACHE_EVENT_OPEN_READ));
 static_assert(static_cast<int>(TS_EVENT_CACHE_OPEN_READ_FAILED) == static_cast<int>(CACHE_EVENT_OPEN_READ_FAILED));
 static_assert(static_cast<int>(TS_EVENT_CACHE_OPEN_WRITE) == static_cast<int>(CACHE_EVENT_OPEN_WRITE));
@@ -279,6 +322,10 @@ Cache::open_done()
     }
   }
 
+  if (ready == CacheInitState::INITIALIZED) {
+    init_cache_tiers();
+  }
+
   cacheProcessor.cacheInitialized();
 
   return 0;
@@ -379,7 +426,10 @@ Cache::open_read(Continuation *cont, const CacheKey *key, CacheFragType type, st
   CacheVC      *c     = nullptr;
   {
     CACHE_TRY_LOCK(lock, stripe->mutex, mutex->thread_holding);
-    if (!lock.is_locked() || (od = stripe->open_read(key)) || stripe->directory.probe(key, stripe, &result, &last_collision)) {
+    // a miss on a tiered volume still needs a CacheVC to try the lower tier
+    int hit = 0;
+    if (!lock.is_locked() || (od = stripe->open_read(key)) ||
+        (hit = stripe->directory.probe(key, stripe, &result, &last_collision)) || stripe->cache_vol->lower_tier) {
       c = new_CacheVC(cont);
       SET_CONTINUATION_HANDLER(c, &CacheVC::openReadStartHead);
       c->vio.op  = VIO::READ;
@@ -401,6 +451,10 @@ Cache::open_read(Continuation *cont, const CacheKey *key, CacheFragType type, st
     if (c->od) {
       goto Lwriter;
     }
+    if (!hit) {
+      c->fall_back_to_lower_tier();
+      goto Ltier;
+    }
     c->dir            = result;
     c->last_collision = last_collision;
     switch (c->do_read_call(&c->key)) {
@@ -428,6 +482,12 @@ Lcallreturn:
     return ACTION_RESULT_DONE;
   }
   return &c->_action;
+Ltier:
+  SET_CONTINUATION_HANDLER(c, &CacheVC::openReadStartHead);
+  if (c->handleEvent(EVENT_IMMEDIATE, nullptr) == EVENT_DONE) {
+    return ACTION_RESULT_DONE;
+  }
+  return &c->_action;
 }
 
 // main entry point for writing of non-http documents
@@ -449,6 +509,7 @@ Cache::open_write(Continuation *cont, const CacheKey *key, CacheFragType frag_ty
   c->op_type       = static_cast<int>(CacheOpType::Write);
   c->stripe        = key_to_stripe(key, hostname);
   StripeSM *stripe = c->stripe;
+  tier_remove(key, frag_type, stripe);
   ts::Metrics::Gauge::increment(cache_rsb.status[c->op_type].active);
   ts::Metrics::Gauge::increment(stripe->cache_vol->vol_rsb.status[c->op_type].active);
   c->first_key = c->key = *key;
@@ -508,6 +569,14 @@ Cache::remove(Continuation *cont, const CacheKey *key, CacheFragType type, std::
     return ACTION_RESULT_DONE;
   }
 
+  StripeSM *stripe = key_to_stripe(key, hostname);
+  tier_remove(key, type, stripe);
+  return remove_from(cont, key, type, stripe);
+}
+
+Action *
+Cache::remove_from(Continuation *cont, const CacheKey *key, CacheFragType type, StripeSM *stripe) const
+{
   Ptr<ProxyMutex> mutex;
   if (!cont) {
     cont = new_CacheRemoveCont();
@@ -515,7 +584,6 @@ Cache::remove(Continuation *cont, const CacheKey *key, CacheFragType type, std::
 
   CACHE_TRY_LOCK(lock, cont->mutex, this_ethread());
   ink_assert(lock.is_locked());
-  StripeSM *stripe = key_to_stripe(key, hostname);
   // coverity[var_decl]
   Dir result;
   dir_clear(&result); // initialized here, set result empty so we can recognize missed lock
@@ -582,7 +650,10 @@ Cache::open_read(Continuation *cont, const CacheKey *key, CacheHTTPHdr *request,
 
   {
     CACHE_TRY_LOCK(lock, stripe->mutex, mutex->thread_holding);
-    if (!lock.is_locked() || (od = stripe->open_read(key)) || stripe->directory.probe(key, stripe, &result, &last_collision)) {
+    // a miss on a tiered volume still needs a CacheVC to try the lower tier
+    int hit = 0;
+    if (!lock.is_locked() || (od = stripe->open_read(key)) ||
+        (hit = stripe->directory.probe(key, stripe, &result, &last_collision)) || stripe->cache_vol->lower_tier) {
       c            = new_CacheVC(cont);
       c->first_key = c->key = c->earliest_key = *key;
       c->stripe                               = stripe;
@@ -606,6 +677,10 @@ Cache::open_read(Continuation *cont, const CacheKey *key, CacheHTTPHdr *request,
     if (c->od) {
       goto Lwriter;
     }
+    if (!hit) {
+      c->fall_back_to_lower_tier();
+      goto Ltier;
+    }
     // hit
     c->dir = c->first_dir = result;
     c->last_collision     = last_collision;
@@ -636,6 +711,12 @@ Lcallreturn:
     return ACTION_RESULT_DONE;
   }
   return &c->_action;
+Ltier:
+  SET_CONTINUATION_HANDLER(c, &CacheVC::openReadStartHead);
+  if (c->handleEvent(EVENT_IMMEDIATE, nullptr) == EVENT_DONE) {
+    return ACTION_RESULT_DONE;
+  }
+  return &c->_action;
 }
 
 // main entry point for writing of http documents
@@ -668,6 +749,7 @@ Cache::open_write(Continuation *cont, const CacheKey *key, CacheHTTPInfo *old_in
   c->frag_type     = CACHE_FRAG_TYPE_HTTP;
   c->stripe        = key_to_stripe(key, hostname, volume_host_rec);
   StripeSM *stripe = c->stripe;
+  tier_remove(key, type, stripe);
   c->info          = old_info;
   if (c->info && reinterpret_cast<uintptr_t>(old_info) != CACHE_ALLOW_MULTIPLE_WRITES) {
     /*
@@ -777,6 +859,25 @@ Lcallreturn:
   return &c->_action;
 }
 
+void
+Cache::tier_remove(const CacheKey *key, CacheFragType type, StripeSM *stripe) const
+{
+  // A write or remove makes any copy in the lower tier stale.
+  if (StripeSM *lower = tier_stripe(key, stripe); lower) {
+    remove_from(nullptr, key, type, lower);
+  }
+}
+
+StripeSM *
+Cache::tier_stripe(const CacheKey *key, const StripeSM *stripe)
+{
+  CacheHostRecord *rec = stripe->cache_vol->lower_tier;
+  if (!rec || !rec->vol_hash_table) {
+    return nullptr;
+  }
+  return rec->stripes[rec->vol_hash_table[(key->slice32(2) >> DIR_TAG_WIDTH) % STRIPE_HASH_TABLE_SIZE]];
+}
+
 // CacheVConnection
 CacheVConnection::CacheVConnection() : VConnection(nullptr) {}
 
@@ -860,6 +961,8 @@ ink_cache_init(ts::ModuleVersion v)
       cache_config_ram_cache_size / (1024 * 1024));
 
   RecEstablishStaticConfigInt32(cache_config_ram_cache_algorithm, "proxy.config.cache.ram_cache.algorithm");
+  RecEstablishStaticConfigInt32(cache_config_ram_cache_admission, "proxy.config.cache.ram_cache.admission");
+  RecEstablishStaticConfigInt32(cache_config_ram_cache_shards, "proxy.config.cache.ram_cache.shards");
   RecEstablishStaticConfigInt32(cache_config_ram_cache_compress, "proxy.config.cache.ram_cache.compress");
   RecEstablishStaticConfigInt32(cache_config_ram_cache_compress_percent, "proxy.config.cache.ram_cache.compress_percent");
   cache_config_ram_cache_use_seen_filter = RecGetRecordInt("proxy.config.cache.ram_cache.use_seen_filter").value_or(0);
@@ -886,6 +989,9 @@ ink_cache_init(ts::ModuleVersion v)
   RecEstablishStaticConfigInt32(cache_config_dir_sync_max_write, "proxy.config.cache.dir.sync_max_write");
   Dbg(dbg_ctl_cache_init, "proxy.config.cache.dir.sync_max_write = %d", cache_config_dir_sync_max_write);
 
+  RecEstablishStaticConfigInt32(cache_config_dir_sync_incremental, "proxy.config.cache.dir.sync_incremental");
+  Dbg(dbg_ctl_cache_init, "proxy.config.cache.dir.sync_incremental = %d", cache_config_dir_sync_incremental);
+
   RecEstablishStaticConfigInt32(cache_config_select_alternate, "proxy.config.cache.select_alternate");
   Dbg(dbg_ctl_cache_init, "proxy.config.cache.select_alternate = %d", cache_config_select_alternate);
 
@@ -902,12 +1008,27 @@ ink_cache_init(ts::ModuleVersion v)
   RecEstablishStaticConfigInt32(cache_read_while_writer_retry_delay, "proxy.config.cache.read_while_writer_retry.delay");
   Dbg(dbg_ctl_cache_init, "proxy.config.cache.read_while_writer_retry.delay = %dms", cache_read_while_writer_retry_delay);
 
+  RecEstablishStaticConfigInt32(cache_config_read_while_writer_fanout, "proxy.config.cache.read_while_writer.fanout_fragments");
+  Dbg(dbg_ctl_cache_init, "proxy.config.cache.read_while_writer.fanout_fragments = %d", cache_config_read_while_writer_fanout);
+
   RecEstablishStaticConfigInt32(cache_config_hit_evacuate_percent, "proxy.config.cache.hit_evacuate_percent");
   Dbg(dbg_ctl_cache_init, "proxy.config.cache.hit_evacuate_percent = %d", cache_config_hit_evacuate_percent);
 
   RecEstablishStaticConfigInt32(cache_config_hit_evacuate_size_limit, "proxy.config.cache.hit_evacuate_size_limit");
   Dbg(dbg_ctl_cache_init, "proxy.config.cache.hit_evacuate_size_limit = %d", cache_config_hit_evacuate_size_limit);
 
+  RecEstablishStaticConfigInt32(cache_config_tier_promote_hits, "proxy.config.cache.tier.promote_hits");
+  Dbg(dbg_ctl_cache_init, "proxy.config.cache.tier.promote_hits = %d", cache_config_tier_promote_hits);
+
+  RecEstablishStaticConfigInt32(cache_config_tier_demote_hits, "proxy.config.cache.tier.demote_hits");
+  Dbg(dbg_ctl_cache_init, "proxy.config.cache.tier.demote_hits = %d", cache_config_tier_demote_hits);
+
+  RecEstablishStaticConfigInt32(cache_config_agg_write_target_latency, "proxy.config.cache.agg_write.target_latency");
+  Dbg(dbg_ctl_cache_init, "proxy.config.cache.agg_write.target_latency = %d", cache_config_agg_write_target_latency);
+
+  RecEstablishStaticConfigInt32(cache_config_agg_write_max_delay, "proxy.config.cache.agg_write.max_delay");
+  Dbg(dbg_ctl_cache_init, "proxy.config.cache.agg_write.max_delay = %d", cache_config_agg_write_max_delay);
+
   RecEstablishStaticConfigInt32(cache_config_force_sector_size, "proxy.config.cache.force_sector_size");
 
   ink_assert(RecRegisterConfigUpdateCb("proxy.config.cache.target_fragment_size", FragmentSizeUpdateCb, nullptr) != REC_ERR_FAIL);
@@ -938,6 +1059,7 @@ ink_cache_init(ts::ModuleVersion v)
   Dbg(dbg_ctl_cache_init, "proxy.config.cache.enable_read_while_writer = %d", cache_config_read_while_writer);
 
   register_cache_stats(&cache_rsb, "proxy.process.cache");
+  ram_cache_compression_init();
 
   cacheProcessor.wait_for_cache = RecGetRecordInt("proxy.config.http.wait_for_cache").value_or(0);
 
@@ -28,6 +28,7 @@
 #include "PreservationTable.h"
 #include "Stripe.h"
 
+#include "tscore/HashSip.h"
 #include "tscore/hugepages.h"
 #include "tscore/Random.h"
 #include "ts/ats_probe.h"
@@ -107,6 +108,7 @@ OpenDir::open_write(CacheVC *cont, int allow_if_writers, int max_writers)
   od->move_resident_alt     = false;
   od->reading_vec           = false;
   od->writing_vec           = false;
+  od->fanout_next           = 0;
   dir_clear(&od->first_dir);
   cont->od           = od;
   cont->write_vector = &od->vector;
@@ -152,6 +154,7 @@ OpenDir::close_write(CacheVC *cont)
     delayed_readers.append(cont->od->readers);
     signal_readers(0, nullptr);
     cont->od->vector.clear();
+    cont->od->fanout_clear();
     THREAD_FREE(cont->od, openDirEntryAllocator, cont->mutex->thread_holding);
   }
   cont->od = nullptr;
@@ -171,6 +174,40 @@ OpenDir::open_read(const CryptoHash *key) const
   return nullptr;
 }
 
+void
+OpenDirEntry::fanout_add(const CacheKey &key, IOBufferBlock *data, int64_t len)
+{
+  int n = std::min(cache_config_read_while_writer_fanout, OPEN_DIR_FANOUT_MAX);
+  if (n <= 0) {
+    return;
+  }
+  Fragment &frag = fanout[fanout_next % n];
+  frag.key       = key;
+  frag.data      = data;
+  frag.len       = len;
+  fanout_next    = (fanout_next + 1) % n;
+}
+
+const OpenDirEntry::Fragment *
+OpenDirEntry::fanout_find(const CacheKey &key) const
+{
+  for (const auto &frag : fanout) {
+    if (frag.data && frag.key == key) {
+      return &frag;
+    }
+  }
+  return nullptr;
+}
+
+void
+OpenDirEntry::fanout_clear()
+{
+  for (auto &frag : fanout) {
+    frag.data.clear();
+  }
+  fanout_next = 0;
+}
+
 //
 // Cache Directory
 //
@@ -215,6 +252,7 @@ dir_init_segment(int s, Directory *directory)
   Dir *seg                       = directory->get_segment(s);
   int  l, b;
   memset(static_cast<void *>(seg), 0, SIZEOF_DIR * DIR_DEPTH * directory->buckets);
+  directory->mark_dirty(s);
   for (l = 1; l < DIR_DEPTH; l++) {
     for (b = 0; b < directory->buckets; b++) {
       Dir *bucket = dir_bucket(b, seg);
@@ -314,9 +352,9 @@ unlink_from_freelist(Dir *e, int s, Directory *directory)
 inline Dir *
 dir_delete_entry(Dir *e, Dir *p, int s, Directory *directory)
 {
-  Dir *seg                 = directory->get_segment(s);
-  int  no                  = dir_next(e);
-  directory->header->dirty = 1;
+  Dir *seg = directory->get_segment(s);
+  int  no  = dir_next(e);
+  directory->mark_dirty(s);
   if (p) {
     unsigned int fo = directory->header->freelist[s];
     unsigned int eo = dir_to_offset(e, seg);
@@ -618,7 +656,7 @@ Lfill:
   ATS_PROBE7(cache_dir_insert, stripe->fd, s, dir_to_offset(e, seg), dir_offset(e), dir_approx_size(e), key->slice64(0),
              key->slice64(1));
   CHECK_DIR(d);
-  stripe->directory.header->dirty = 1;
+  this->mark_dirty(s);
   ts::Metrics::Gauge::increment(cache_rsb.direntries_used);
   ts::Metrics::Gauge::increment(stripe->cache_vol->vol_rsb.direntries_used);
 
@@ -709,7 +747,7 @@ Lfill:
   DDbg(dbg_ctl_dir_overwrite, "overwrite %p %X into vol %d bucket %d at %p tag %X %X boffset %" PRId64 "", e, key->slice32(0),
        stripe->fd, bi, e, t, dir_tag(e), dir_offset(e));
   CHECK_DIR(d);
-  this->header->dirty = 1;
+  this->mark_dirty(s);
   return res;
 }
 
@@ -928,6 +966,50 @@ CacheSync::aio_write(int fd, char *b, int n, off_t o)
   ink_assert(ink_aio_write(&io) >= 0);
 }
 
+/* Skip the blocks of the snapshot which copy B already holds and return the
+   length of the run of changed blocks starting at writepos, remembering their
+   hashes. Returns 0 if nothing changed within sync_max_write bytes of blocks
+   or once all the ranges are done.
+ */
+off_t
+CacheSync::changed_run(Directory *directory, size_t B)
+{
+  std::vector<uint64_t> &hashes  = directory->synced_hash[B];
+  off_t                  scanned = 0;
+  off_t                  run     = 0;
+
+  for (; next_range < ranges.size(); next_range++) {
+    auto [rstart, rend] = ranges[next_range];
+    writepos            = std::max(writepos, rstart);
+    while (writepos + run < rend) {
+      off_t          block = writepos + run;
+      ATSHash64Sip24 h;
+      h.update(buf + block, STORE_BLOCK_SIZE);
+      h.final();
+      uint64_t hash = h.get() ? h.get() : 1;
+      if (hashes[block / STORE_BLOCK_SIZE] == hash) {
+        if (run) {
+          return run;
+        }
+        writepos += STORE_BLOCK_SIZE;
+        if ((scanned += STORE_BLOCK_SIZE) >= cache_config_dir_sync_max_write) {
+          return 0;
+        }
+        continue;
+      }
+      hashes[block / STORE_BLOCK_SIZE]  = hash;
+      run                              += STORE_BLOCK_SIZE;
+      if (run >= cache_config_dir_sync_max_write) {
+        return run;
+      }
+    }
+    if (run) {
+      return run;
+    }
+  }
+  return 0;
+}
+
 uint64_t
 Directory::entries_used()
 {
@@ -956,6 +1038,41 @@ Directory::entries_used()
   return full;
 }
 
+bool
+Directory::dirty_ranges(uint32_t serial, std::vector<std::pair<off_t, off_t>> &ranges) const
+{
+  // The copy being overwritten holds snapshot serial - 2, so only the
+  // segments changed after that snapshot was taken need to be written.
+  uint32_t synced = this->synced_serial[serial & 1];
+  if (this->segment_serial.empty() || !synced || synced + 2 != serial) {
+    return false;
+  }
+
+  off_t headerlen   = ROUND_TO_STORE_BLOCK(sizeof(StripeHeaderFooter));
+  off_t dir_start   = reinterpret_cast<char *>(this->dir) - this->raw_dir;
+  off_t segment_len = this->buckets * DIR_DEPTH * SIZEOF_DIR;
+
+  ranges.clear();
+  // freelist heads which do not fit in the first header block
+  if (dir_start > headerlen) {
+    ranges.emplace_back(headerlen, dir_start);
+  }
+  for (int s = 0; s < this->segments; s++) {
+    if (this->segment_serial[s] + 1 < serial) {
+      continue;
+    }
+    off_t start = dir_start + s * segment_len;
+    off_t end   = ROUND_TO_STORE_BLOCK(start + segment_len);
+    start      -= start % STORE_BLOCK_SIZE;
+    if (!ranges.empty() && start <= ranges.back().second) {
+      ranges.back().second = end;
+    } else {
+      ranges.emplace_back(start, end);
+    }
+  }
+  return true;
+}
+
 /*
  * this function flushes the cache meta data to disk when
  * the cache is shutdown. Must *NOT* be used during regular
@@ -1082,8 +1199,26 @@ Lrestart:
       stripe->directory.header->sync_serial++;
       stripe->directory.footer->sync_serial = stripe->directory.header->sync_serial;
       CHECK_DIR(d);
-      memcpy(buf, stripe->directory.raw_dir, dirlen);
-      stripe->dir_sync_in_progress = true;
+      Directory &directory = stripe->directory;
+      uint32_t   serial    = directory.header->sync_serial;
+      if (cache_config_dir_sync_incremental && directory.dirty_ranges(serial, ranges)) {
+        // only the segments changed since this copy was last written are compared and written
+        memcpy(buf, directory.raw_dir, headerlen);
+        for (auto const &[rstart, rend] : ranges) {
+          memcpy(buf + rstart, directory.raw_dir + rstart, rend - rstart);
+        }
+        memcpy(buf + dirlen - headerlen, directory.raw_dir + dirlen - headerlen, headerlen);
+        ts::Metrics::Counter::increment(cache_rsb.directory_sync_partial);
+        ts::Metrics::Counter::increment(stripe->cache_vol->vol_rsb.directory_sync_partial);
+      } else {
+        ranges.assign(1, {headerlen, static_cast<off_t>(dirlen) - headerlen});
+        directory.synced_hash[serial & 1].assign(dirlen / STORE_BLOCK_SIZE, 0);
+        memcpy(buf, directory.raw_dir, dirlen);
+      }
+      // the copy is not a base for incremental syncs until its footer is written
+      directory.synced_serial[serial & 1] = 0;
+      next_range                          = 0;
+      stripe->dir_sync_in_progress        = true;
     }
     size_t B     = stripe->directory.header->sync_serial & 1;
     off_t  start = stripe->skip + (B ? dirlen : 0);
@@ -1092,21 +1227,30 @@ Lrestart:
       // write header
       aio_write(stripe->fd, buf + writepos, headerlen, start + writepos);
       writepos += headerlen;
-    } else if (writepos < static_cast<off_t>(dirlen) - headerlen) {
-      // write part of body
-      int l = cache_config_dir_sync_max_write;
-      if (writepos + l > static_cast<off_t>(dirlen) - headerlen) {
-        l = dirlen - headerlen - writepos;
+      return EVENT_CONT;
+    }
+    if (next_range < ranges.size()) {
+      // write the next run of body blocks which differ from the copy on disk
+      off_t l = changed_run(&stripe->directory, B);
+      if (l) {
+        aio_write(stripe->fd, buf + writepos, l, start + writepos);
+        writepos += l;
+        return EVENT_CONT;
       }
-      aio_write(stripe->fd, buf + writepos, l, start + writepos);
-      writepos += l;
-    } else if (writepos < static_cast<off_t>(dirlen)) {
-      ink_assert(writepos == (off_t)dirlen - headerlen);
+      if (next_range < ranges.size()) {
+        // nothing to write yet, release the stripe before comparing further
+        trigger = eventProcessor.schedule_imm(this, ET_TASK);
+        return EVENT_CONT;
+      }
+    }
+    if (writepos < static_cast<off_t>(dirlen)) {
       // write footer
+      writepos = dirlen - headerlen;
       aio_write(stripe->fd, buf + writepos, headerlen, start + writepos);
       writepos += headerlen;
     } else {
-      stripe->dir_sync_in_progress = false;
+      stripe->directory.synced_serial[B] = stripe->directory.header->sync_serial;
+      stripe->dir_sync_in_progress       = false;
       ts::Metrics::Counter::increment(cache_rsb.directory_sync_count);
       ts::Metrics::Counter::increment(stripe->cache_vol->vol_rsb.directory_sync_count);
       ts::Metrics::Counter::increment(cache_rsb.directory_sync_time, ink_get_hrtime() - start_time);
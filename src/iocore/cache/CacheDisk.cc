@@ -66,6 +66,7 @@ CacheDisk::open(char *s, off_t blocks, off_t askip, int ahw_sector_size, int fil
   len                 = blocks;
   io.aiocb.aio_fildes = fd;
   io.action           = this;
+  ink_aio_register_fd(fd);
   // determine header size and hence start point by successive approximation
   uint64_t l;
   for (int i = 0; i < 3; i++) {
@@ -201,6 +202,22 @@ CacheDisk::openStart(int event, void * /* data ATS_UNUSED */)
     }
   }
 
+  // Stripes allocated by a build with wider directory offsets may be too large for this one.
+  for (unsigned int i = 0; i < header->num_diskvol_blks; i++) {
+    if (!header->vol_info[i].free && header->vol_info[i].len > static_cast<uint64_t>(MAX_STRIPE_SIZE >> STORE_BLOCK_SHIFT)) {
+      if (read_only_p) {
+        fprintf(stderr, "Disk %s has stripes larger than %" PRId64 " bytes", path, static_cast<int64_t>(MAX_STRIPE_SIZE));
+        SET_DISK_BAD(this);
+        SET_HANDLER(&CacheDisk::openDone);
+        return EVENT_DONE;
+      }
+      Warning("disk %s has stripes larger than %" PRId64 " bytes: clearing the disk", path, static_cast<int64_t>(MAX_STRIPE_SIZE));
+      SET_HANDLER(&CacheDisk::clearDone);
+      clearDisk();
+      return EVENT_DONE;
+    }
+  }
+
   cleared = 0;
   /* populate disk_vols */
   update_header();
@@ -35,16 +35,23 @@
 #include "CacheEvacuateDocVC.h"
 #include "PreservationTable.h"
 
+// eventsystem
+#include "iocore/eventsystem/EventProcessor.h"
+
 // tscore
 #include "tscore/Diags.h"
 #include "tscore/ink_assert.h"
 
 // ts
 #include "tsutil/DbgCtl.h"
+#include "tsutil/Metrics.h"
+
+#include <cstring>
 
 namespace
 {
 DbgCtl dbg_ctl_cache_evac{"cache_evac"};
+DbgCtl dbg_ctl_cache_tier{"cache_tier"};
 } // end anonymous namespace
 
 int
@@ -199,3 +206,136 @@ Ldone:
   dir_lookaside_remove(&earliest_key, this->stripe);
   return free_CacheEvacuateDocVC(this);
 }
+
+void
+tier_promote(CacheVC *reader, StripeSM *to)
+{
+  StripeSM           *from = reader->stripe;
+  CacheEvacuateDocVC *c    = new_CacheEvacuateDocVC(reader);
+  c->op_type               = static_cast<int>(CacheOpType::Evacuate);
+  ts::Metrics::Gauge::increment(cache_rsb.status[c->op_type].active);
+  ts::Metrics::Gauge::increment(from->cache_vol->vol_rsb.status[c->op_type].active);
+  c->_action       = from;
+  c->mutex         = from->mutex;
+  c->stripe        = from;
+  c->upper_stripe  = to;
+  c->first_key     = reader->first_key;
+  c->overwrite_dir = reader->dir;
+  c->f.evacuator   = 1;
+  c->earliest_key.clear();
+
+  c->io.aiocb.aio_fildes = from->fd;
+  c->io.aiocb.aio_nbytes = dir_approx_size(&c->overwrite_dir);
+  c->io.aiocb.aio_offset = from->vol_offset(&c->overwrite_dir);
+  if (static_cast<off_t>(c->io.aiocb.aio_offset + c->io.aiocb.aio_nbytes) > static_cast<off_t>(from->skip + from->len)) {
+    c->io.aiocb.aio_nbytes = from->skip + from->len - c->io.aiocb.aio_offset;
+  }
+  c->buf              = new_IOBufferData(iobuffer_size_to_index(c->io.aiocb.aio_nbytes, MAX_BUFFER_SIZE_INDEX), MEMALIGNED);
+  c->io.aiocb.aio_buf = c->buf->data();
+  c->io.action        = c;
+  c->io.thread        = AIO_CALLBACK_THREAD_ANY;
+  DDbg(dbg_ctl_cache_tier, "promoting %X %" PRId64, c->first_key.slice32(0), dir_offset(&c->overwrite_dir));
+  SET_CONTINUATION_HANDLER(c, &CacheEvacuateDocVC::tierReadDone);
+  ink_assert(ink_aio_read(&c->io) >= 0);
+}
+
+void
+CacheEvacuateDocVC::tier_move(StripeSM *to)
+{
+  // The active gauge follows the stripe, free_CacheVCCommon decrements it there.
+  ts::Metrics::Gauge::decrement(this->stripe->cache_vol->vol_rsb.status[op_type].active);
+  ts::Metrics::Gauge::increment(to->cache_vol->vol_rsb.status[op_type].active);
+  this->stripe = to;
+  mutex        = to->mutex;
+  SET_HANDLER(&CacheEvacuateDocVC::tierWrite);
+  eventProcessor.schedule_imm(this, ET_CALL);
+}
+
+int
+CacheEvacuateDocVC::tierReadDone(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+{
+  ink_assert(this->stripe->mutex->thread_holding == this_ethread());
+  cancel_trigger();
+  set_io_not_in_progress();
+  Doc *doc = reinterpret_cast<Doc *>(this->buf->data());
+  // a directory entry which is no longer valid may have been overwritten while it was read
+  if (!io.ok() || !this->stripe->dir_valid(&this->overwrite_dir) || doc->magic != DOC_MAGIC || !(doc->first_key == first_key)) {
+    return free_CacheEvacuateDocVC(this);
+  }
+  tier_move(this->upper_stripe);
+  return EVENT_DONE;
+}
+
+int
+CacheEvacuateDocVC::tierWrite(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+{
+  ink_assert(this->stripe->mutex->thread_holding == this_ethread());
+  Doc *doc = reinterpret_cast<Doc *>(this->buf->data());
+  Dir  dir;
+
+  // A copy that is already there, from an earlier promotion or a newer write, wins.
+  last_collision = nullptr;
+  if (this->stripe->open_read(&first_key) || this->stripe->directory.probe(&first_key, this->stripe, &dir, &last_collision)) {
+    return free_CacheEvacuateDocVC(this);
+  }
+  if (!tier_movable(doc)) {
+    ts::Metrics::Counter::increment(cache_rsb.tier_skipped);
+    ts::Metrics::Counter::increment(this->stripe->cache_vol->vol_rsb.tier_skipped);
+    return free_CacheEvacuateDocVC(this);
+  }
+  DDbg(dbg_ctl_cache_tier, "tierWrite %X to %s", first_key.slice32(0), this->stripe->hash_text.get());
+  SET_HANDLER(&CacheEvacuateDocVC::tierWriteDone);
+  if (!this->stripe->tier_write(this)) {
+    ts::Metrics::Counter::increment(cache_rsb.tier_skipped);
+    ts::Metrics::Counter::increment(this->stripe->cache_vol->vol_rsb.tier_skipped);
+    return free_CacheEvacuateDocVC(this);
+  }
+  // this may already have been freed by tierWriteDone
+  return EVENT_DONE;
+}
+
+int
+CacheEvacuateDocVC::tierWriteDone(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+{
+  ink_assert(this->stripe->mutex->thread_holding == this_ethread());
+  Dir dir;
+
+  // the aggregation buffer was flushed without this document
+  if (!dir_offset(&this->dir)) {
+    return free_CacheEvacuateDocVC(this);
+  }
+  last_collision = nullptr;
+  if (this->stripe->open_read(&first_key) || this->stripe->directory.probe(&first_key, this->stripe, &dir, &last_collision)) {
+    return free_CacheEvacuateDocVC(this);
+  }
+  DDbg(dbg_ctl_cache_tier, "tierWriteDone %X offset %" PRId64, first_key.slice32(0), dir_offset(&this->dir));
+  this->stripe->directory.insert(&first_key, this->stripe, &this->dir);
+  if (this->stripe->cache_vol->lower_tier) {
+    ts::Metrics::Counter::increment(cache_rsb.tier_promoted);
+    ts::Metrics::Counter::increment(this->stripe->cache_vol->vol_rsb.tier_promoted);
+  } else {
+    ts::Metrics::Counter::increment(cache_rsb.tier_demoted);
+    ts::Metrics::Counter::increment(this->stripe->cache_vol->vol_rsb.tier_demoted);
+  }
+  return free_CacheEvacuateDocVC(this);
+}
+
+bool
+CacheEvacuateDocVC::tier_movable(Doc *doc)
+{
+  if (!doc->single_fragment() || !doc->data_len()) {
+    return false;
+  }
+  if (doc->doc_type != CACHE_FRAG_TYPE_HTTP || !doc->hlen) {
+    return true;
+  }
+  // The data in the head belongs to one alternate, the others would be left
+  // behind. Count them in a copy, unmarshalling rewrites the header in place.
+  Ptr<IOBufferData> hdr(new_IOBufferData(iobuffer_size_to_index(doc->hlen, MAX_BUFFER_SIZE_INDEX), MEMALIGNED));
+  memcpy(hdr->data(), doc->hdr(), doc->hlen);
+  CacheHTTPInfoVector alternates;
+  if (alternates.unmarshal(hdr->data(), doc->hlen, hdr.get()) != static_cast<int>(doc->hlen)) {
+    return false;
+  }
+  return alternates.count() == 1;
+}
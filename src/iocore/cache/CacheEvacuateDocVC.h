@@ -46,6 +46,19 @@ class CacheEvacuateDocVC : public CacheVC
 public:
   int evacuateDocDone(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */);
   int evacuateReadHead(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */);
+
+  /* Moving documents between cache tiers. The document with first_key is in
+     buf, it is handed to the stripe of the other tier with tier_move and
+     written there like an evacuated document. Only whole objects that fit in
+     a single fragment are moved.
+   */
+  void tier_move(StripeSM *to);
+  int  tierReadDone(int event, Event *e);
+  int  tierWrite(int event, Event *e);
+  int  tierWriteDone(int event, Event *e);
+
+private:
+  bool tier_movable(Doc *doc);
 };
 
 extern ClassAllocator<CacheEvacuateDocVC, false> cacheEvacuateDocVConnectionAllocator;
@@ -67,3 +80,11 @@ new_CacheEvacuateDocVC(Continuation *cont)
 
   return c;
 }
+
+/**
+ * Copy the object @a reader just read from the lower tier to @a to.
+ *
+ * The reader's stripe must be locked. The copy is read again from disk, the
+ * reader's buffer has already been unmarshalled in place.
+ */
+void tier_promote(CacheVC *reader, StripeSM *to);
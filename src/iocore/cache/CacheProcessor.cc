@@ -76,6 +76,8 @@ static size_t DEFAULT_RAM_CACHE_MULTIPLIER = 10; // I.e. 10x 1MB per 1GB of disk
 // Configuration
 extern int64_t cache_config_ram_cache_size;
 extern int     cache_config_ram_cache_algorithm;
+extern int     cache_config_ram_cache_admission;
+extern int     cache_config_ram_cache_shards;
 extern int64_t cache_config_ram_cache_cutoff;
 extern int     cache_config_persist_bad_disks;
 
@@ -1179,6 +1181,9 @@ register_cache_stats(CacheStatsBlock *rsb, const std::string &prefix)
   rsb->last_open_read_hits    = ts::Metrics::Counter::createPtr(prefix + ".last_open_read.hits");
   rsb->agg_buffer_hits        = ts::Metrics::Counter::createPtr(prefix + ".aggregation_buffer.hits");
   rsb->ram_cache_misses       = ts::Metrics::Counter::createPtr(prefix + ".ram_cache.misses");
+  rsb->ram_cache_admitted     = ts::Metrics::Counter::createPtr(prefix + ".ram_cache.admission.admitted");
+  rsb->ram_cache_rejected     = ts::Metrics::Counter::createPtr(prefix + ".ram_cache.admission.rejected");
+  rsb->ram_cache_nolock_hits  = ts::Metrics::Counter::createPtr(prefix + ".ram_cache.unlocked_hits");
   rsb->all_mem_misses         = ts::Metrics::Counter::createPtr(prefix + ".all_memory_caches.misses");
   rsb->pread_count            = ts::Metrics::Counter::createPtr(prefix + ".pread_count");
   rsb->percent_full           = ts::Metrics::Gauge::createPtr(prefix + ".percent_full");
@@ -1190,6 +1195,7 @@ register_cache_stats(CacheStatsBlock *rsb, const std::string &prefix)
   rsb->directory_collision    = ts::Metrics::Counter::createPtr(prefix + ".directory_collision");
   rsb->read_busy_success      = ts::Metrics::Counter::createPtr(prefix + ".read_busy.success");
   rsb->read_busy_failure      = ts::Metrics::Counter::createPtr(prefix + ".read_busy.failure");
+  rsb->read_busy_fanout_hits  = ts::Metrics::Counter::createPtr(prefix + ".read_busy.fanout_hits");
   rsb->write_bytes            = ts::Metrics::Counter::createPtr(prefix + ".write_bytes_stat");
   rsb->hdr_vector_marshal     = ts::Metrics::Counter::createPtr(prefix + ".vector_marshals");
   rsb->hdr_marshal            = ts::Metrics::Counter::createPtr(prefix + ".hdr_marshals");
@@ -1200,6 +1206,7 @@ register_cache_stats(CacheStatsBlock *rsb, const std::string &prefix)
   rsb->directory_sync_count   = ts::Metrics::Counter::createPtr(prefix + ".sync.count");
   rsb->directory_sync_bytes   = ts::Metrics::Counter::createPtr(prefix + ".sync.bytes");
   rsb->directory_sync_time    = ts::Metrics::Counter::createPtr(prefix + ".sync.time");
+  rsb->directory_sync_partial = ts::Metrics::Counter::createPtr(prefix + ".sync.partial");
   rsb->span_errors_read       = ts::Metrics::Counter::createPtr(prefix + ".span.errors.read");
   rsb->span_errors_write      = ts::Metrics::Counter::createPtr(prefix + ".span.errors.write");
   rsb->span_failing           = ts::Metrics::Gauge::createPtr(prefix + ".span.failing");
@@ -1207,6 +1214,16 @@ register_cache_stats(CacheStatsBlock *rsb, const std::string &prefix)
   rsb->span_online            = ts::Metrics::Gauge::createPtr(prefix + ".span.online");
   rsb->stripe_lock_contention = ts::Metrics::Counter::createPtr(prefix + ".stripe.lock_contention");
   rsb->writer_lock_contention = ts::Metrics::Counter::createPtr(prefix + ".writer.lock_contention");
+  rsb->tier_lower_hits        = ts::Metrics::Counter::createPtr(prefix + ".tier.lower_hits");
+  rsb->tier_promoted          = ts::Metrics::Counter::createPtr(prefix + ".tier.promoted");
+  rsb->tier_demoted           = ts::Metrics::Counter::createPtr(prefix + ".tier.demoted");
+  rsb->tier_skipped           = ts::Metrics::Counter::createPtr(prefix + ".tier.skipped");
+
+  for (int i = 0; i < CACHE_AGG_HISTOGRAM_BUCKETS; i++) {
+    std::string bound = i < CACHE_AGG_HISTOGRAM_BUCKETS - 1 ? std::to_string(CACHE_AGG_HISTOGRAM_MS[i]) + "ms" : "inf";
+    rsb->agg_write_wait[i]    = ts::Metrics::Counter::createPtr(prefix + ".agg_write.wait_" + bound);
+    rsb->agg_write_latency[i] = ts::Metrics::Counter::createPtr(prefix + ".agg_write.latency_" + bound);
+  }
 }
 
 void
@@ -1484,8 +1501,15 @@ CacheProcessor::cacheInitialized()
         gnstripes.load());
 
     if (gnstripes) {
+      if (cache_config_ram_cache_shards > 0 && cache_config_ram_cache_admission != RAM_CACHE_ADMISSION_NONE) {
+        Warning("proxy.config.cache.ram_cache.admission is not supported with a sharded RAM cache, ignoring it");
+      }
       // new ram_caches, with algorithm from the config
       for (int i = 0; i < gnstripes; i++) {
+        if (cache_config_ram_cache_shards > 0) {
+          gstripes[i]->ram_cache = new_RamCacheSharded(cache_config_ram_cache_shards);
+          continue;
+        }
         switch (cache_config_ram_cache_algorithm) {
         default:
         case RAM_CACHE_ALGORITHM_CLFUS:
@@ -1495,6 +1519,9 @@ CacheProcessor::cacheInitialized()
           gstripes[i]->ram_cache = new_RamCacheLRU();
           break;
         }
+        if (cache_config_ram_cache_admission == RAM_CACHE_ADMISSION_TINYLFU) {
+          gstripes[i]->ram_cache = new_RamCacheTinyLFU(gstripes[i]->ram_cache);
+        }
       }
 
       // Calculate total private RAM allocations from per-volume configurations
@@ -1647,6 +1674,16 @@ CacheProcessor::cacheInitialized()
       case CACHE_COMPRESSION_LIBLZMA:
 #ifndef HAVE_LZMA_H
         Fatal("lzma not available for RAM cache compression");
+#endif
+        break;
+      case CACHE_COMPRESSION_ZSTD:
+#ifndef HAVE_ZSTD_H
+        Fatal("zstd not available for RAM cache compression");
+#endif
+        break;
+      case CACHE_COMPRESSION_LZ4:
+#ifndef HAVE_LZ4_H
+        Fatal("lz4 not available for RAM cache compression");
 #endif
         break;
       }
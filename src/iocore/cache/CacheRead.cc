@@ -24,6 +24,7 @@
 #include "P_CacheDoc.h"
 #include "P_CacheHttp.h"
 #include "P_CacheInternal.h"
+#include "CacheEvacuateDocVC.h"
 #include "CacheVC.h"
 #include "iocore/cache/HttpTransactCache.h"
 #include "tscore/InkErrno.h"
@@ -111,7 +112,8 @@ CacheVC::openReadChooseWriter(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSE
     // check if all the writers who came before this reader have
     // set the http_info.
     for (w = static_cast<CacheVC *>(od->writers.head); w; w = static_cast<CacheVC *>(w->opendir_link.next)) {
-      if (w->start_time > start_time || w->closed < 0) {
+      // a fill of a sparse object is not readable until it is in the vector
+      if (w->start_time > start_time || w->closed < 0 || w->f.sparse) {
         continue;
       }
       if (!w->closed && !cache_config_read_while_writer) {
@@ -413,6 +415,42 @@ CacheVC::openReadFromWriterMain(int /* event ATS_UNUSED */, Event * /* e ATS_UNU
   }
 }
 
+/*
+  Hand the reader a fragment shared by the writer it follows, see
+  OpenDirEntry::fanout, then go back to openReadMain for the next one.
+*/
+int
+CacheVC::openReadFromFanout(int event, Event *e)
+{
+  cancel_trigger();
+  while (length > 0) {
+    int64_t ntodo = vio.ntodo();
+    if (ntodo <= 0) {
+      return EVENT_CONT;
+    }
+    if (vio.get_writer()->max_read_avail() > vio.get_writer()->water_mark && vio.ndone) {
+      return EVENT_CONT;
+    }
+    int64_t        bytes = std::min(length, ntodo);
+    IOBufferBlock *b     = iobufferblock_clone(writer_buf.get(), writer_offset, bytes);
+    writer_buf           = iobufferblock_skip(writer_buf.get(), &writer_offset, &length, bytes);
+    vio.get_writer()->append_block(b);
+    vio.ndone += bytes;
+    if (vio.ntodo() <= 0) {
+      return calluser(VC_EVENT_READ_COMPLETE);
+    }
+    if (calluser(VC_EVENT_READ_READY) == EVENT_DONE) {
+      return EVENT_DONE;
+    }
+    if (vio.get_writer()->high_water()) {
+      return EVENT_CONT;
+    }
+  }
+  writer_buf.clear();
+  SET_HANDLER(&CacheVC::openReadMain);
+  return openReadMain(event, e);
+}
+
 int
 CacheVC::openReadClose(int event, Event * /* e ATS_UNUSED */)
 {
@@ -517,7 +555,7 @@ CacheVC::openReadReadDone(int event, Event *e)
     } else {
       Warning("Document %s truncated .. clearing", earliest_key.toHexStr(tmpstring));
     }
-    stripe->directory.remove(&earliest_key, stripe, &earliest_dir);
+    remove_truncated();
   }
   }
   return calluser(VC_EVENT_ERROR);
@@ -534,7 +572,7 @@ LreadMain:
 }
 
 int
-CacheVC::openReadMain(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+CacheVC::openReadMain(int event, Event *e)
 {
   cancel_trigger();
   Doc           *doc   = reinterpret_cast<Doc *>(buf->data());
@@ -568,7 +606,7 @@ CacheVC::openReadMain(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
          more than the fragment table length, the start of the last
          fragment being the last offset in the table.
       */
-      if (fragment == 0 || seek_to < frags[fragment - 1] || (fragment <= lfi && frags[fragment] <= seek_to)) {
+      if (fragment <= 0 || seek_to < frags[fragment - 1] || (fragment <= lfi && frags[fragment] <= seek_to)) {
         // search from frag 0 on to find the proper frag
         while (seek_to >= next_off && target < lfi) {
           next_off = frags[++target];
@@ -692,6 +730,12 @@ Lread: {
     // reached the end of the document and the user still wants more
     return calluser(VC_EVENT_EOS);
   }
+  if (!alternate.is_frag_present(fragment + 1)) {
+    // a sparse object without the fragment, the range was checked when the
+    // alternate was selected so it has been evicted since
+    Dbg(dbg_ctl_cache_seek, "fragment %d of %X is not present", fragment + 1, first_key.slice32(1));
+    return calluser(VC_EVENT_ERROR);
+  }
   last_collision    = nullptr;
   writer_lock_retry = 0;
   // if the state machine calls reenable on the callback from the cache,
@@ -699,11 +743,43 @@ Lread: {
   // EVENT_IMMEDIATE events. So, we have to cancel that trigger and set
   // a new EVENT_INTERVAL event.
   cancel_trigger();
+  // Every fragment after the first is keyed off the random earliest key of the write that stored it, so its
+  // contents never change under that key. A RAM cache that is safe to share across threads can therefore
+  // serve it by key alone without the stripe lock.
+  Ptr<IOBufferData> ram_buf;
+  if (stripe->ram_cache->get_unlocked(&key, &ram_buf)) {
+    doc = reinterpret_cast<Doc *>(ram_buf->data());
+    if (doc->magic == DOC_MAGIC && doc->key == key) {
+      buf = ram_buf;
+      fragment++;
+      doc_pos = doc->prefix_len();
+      next_CacheKey(&key, &key);
+      return openReadMain(event, e);
+    }
+  }
   CACHE_TRY_LOCK(lock, stripe->mutex, mutex->thread_holding);
   if (!lock.is_locked()) {
     SET_HANDLER(&CacheVC::openReadMain);
     VC_SCHED_LOCK_RETRY();
   }
+  if (write_vc && !seek_to) {
+    // a fragment the writer has just written is still in its buffers
+    OpenDirEntry                 *wod  = stripe->open_read(&first_key);
+    const OpenDirEntry::Fragment *frag = wod ? wod->fanout_find(key) : nullptr;
+    if (frag) {
+      writer_buf    = frag->data;
+      writer_offset = 0;
+      length        = std::min(frag->len, static_cast<int64_t>(doc_len - vio.ndone));
+      doc_pos       = doc->len;
+      fragment++;
+      next_CacheKey(&key, &key);
+      MUTEX_RELEASE(lock);
+      ts::Metrics::Counter::increment(cache_rsb.read_busy_fanout_hits);
+      ts::Metrics::Counter::increment(stripe->cache_vol->vol_rsb.read_busy_fanout_hits);
+      SET_HANDLER(&CacheVC::openReadFromFanout);
+      return openReadFromFanout(event, e);
+    }
+  }
   if (stripe->directory.probe(&key, stripe, &dir, &last_collision)) {
     SET_HANDLER(&CacheVC::openReadReadDone);
     int ret = do_read_call(&key);
@@ -734,7 +810,7 @@ Lread: {
   Warning("Document %X truncated at %" PRId64 " of %" PRIu64 ", missing fragment %X", first_key.slice32(1), vio.ndone, doc_len,
           key.slice32(1));
   // remove the directory entry
-  stripe->directory.remove(&earliest_key, stripe, &earliest_dir);
+  remove_truncated();
 }
 Lerror:
   return calluser(VC_EVENT_ERROR);
@@ -968,6 +1044,43 @@ Lrestart:
   return openReadStartHead(EVENT_IMMEDIATE, nullptr);
 }
 
+/*
+  Retry a read that missed on a stripe of a volume with a lower tier on the
+  stripe of the lower tier that holds the key. The caller holds the stripe
+  lock and restarts the read from the directory probe.
+ */
+bool
+CacheVC::fall_back_to_lower_tier()
+{
+  StripeSM *lower = upper_stripe ? nullptr : Cache::tier_stripe(&first_key, stripe);
+  if (!lower) {
+    return false;
+  }
+  // The active gauge follows the stripe, free_CacheVC decrements it there.
+  ts::Metrics::Gauge::decrement(stripe->cache_vol->vol_rsb.status[op_type].active);
+  ts::Metrics::Gauge::increment(lower->cache_vol->vol_rsb.status[op_type].active);
+  upper_stripe   = stripe;
+  stripe         = lower;
+  last_collision = nullptr;
+  buf.clear();
+  return true;
+}
+
+/*
+  Remove the directory entry of an object found to be missing a fragment,
+  the caller holds the stripe lock. A sparse object has no earliest
+  fragment that is always read, so its vector goes instead.
+ */
+void
+CacheVC::remove_truncated()
+{
+  if (alternate.valid() && alternate.is_sparse()) {
+    stripe->directory.remove(&first_key, stripe, &first_dir);
+  } else {
+    stripe->directory.remove(&earliest_key, stripe, &earliest_dir);
+  }
+}
+
 /*
   This code follows CacheVC::openReadStartEarliest closely,
   if you change this you might have to change that.
@@ -1028,6 +1141,14 @@ CacheVC::openReadStartHead(int event, Event *e)
     if (f.lookup) {
       goto Lookup;
     }
+    stripe->record_access(&first_key);
+    if (upper_stripe) {
+      ts::Metrics::Counter::increment(cache_rsb.tier_lower_hits);
+      ts::Metrics::Counter::increment(stripe->cache_vol->vol_rsb.tier_lower_hits);
+      if (cache_config_tier_promote_hits > 0 && stripe->access_frequency(&first_key) >= cache_config_tier_promote_hits) {
+        tier_promote(this, upper_stripe);
+      }
+    }
     earliest_dir = dir;
     CacheHTTPInfo *alternate_tmp;
     if (frag_type == CACHE_FRAG_TYPE_HTTP) {
@@ -1127,6 +1248,17 @@ CacheVC::openReadStartHead(int event, Event *e)
     if (doc_len == 0 && !f.single_fragment) {
       f.single_fragment = true;
     }
+    if (alternate.is_sparse()) {
+      // Not every fragment of a sparse object is present, the first one
+      // included, so each is read when the seek gets to it. The head is
+      // treated as fragment -1 with nothing left in it to read.
+      first_buf    = buf;
+      earliest_key = key;
+      fragment     = -1;
+      doc_pos      = doc->len;
+      dir_clear(&earliest_dir);
+      goto Lsuccess;
+    }
     if (!f.single_fragment) {
       goto Learliest;
     }
@@ -1168,6 +1300,10 @@ CacheVC::openReadStartHead(int event, Event *e)
       }
       return ret;
     }
+    if (fall_back_to_lower_tier()) {
+      MUTEX_RELEASE(lock);
+      return handleEvent(EVENT_IMMEDIATE, nullptr);
+    }
   }
 Ldone:
   if (!f.lookup) {
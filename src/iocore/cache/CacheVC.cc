@@ -314,8 +314,11 @@ unmarshal_helper(Doc *doc, Ptr<IOBufferData> &buf, int &okay)
 
   // introduced by https://github.com/apache/trafficserver/pull/4874, this is used to distinguish the doc version
   // before and after #4847
-  if (version < CACHE_DB_VERSION) {
+  if (version < ts::VersionNumber(24, 2)) {
     unmarshal_func = &HTTPInfo::unmarshal_v24_1;
+  } else if (version < CACHE_DB_VERSION) {
+    // 24.3 added sparse objects, the flag for which was padding before.
+    unmarshal_func = &HTTPInfo::unmarshal_v24_2;
   }
 
   char *tmp = doc->hdr();
@@ -410,6 +413,7 @@ CacheVC::handleReadDone(int event, Event * /* e ATS_UNUSED */)
       if (!http_copy_hdr && doc->doc_type == CACHE_FRAG_TYPE_HTTP && doc->hlen && okay) {
         unmarshal_helper(doc, buf, okay);
       }
+      bool in_ram_cache = false;
       // Put the request in the ram cache only if its a open_read or lookup
       if (vio.op == VIO::READ && okay) {
         bool cutoff_check;
@@ -426,7 +430,7 @@ CacheVC::handleReadDone(int event, Event * /* e ATS_UNUSED */)
                         (doc_len && static_cast<int64_t>(doc_len) < effective_cutoff) || !effective_cutoff);
         if (cutoff_check && !f.doc_from_ram_cache) {
           uint64_t o = dir_offset(&dir);
-          stripe->ram_cache->put(read_key, buf.get(), doc->len, http_copy_hdr, o);
+          in_ram_cache = stripe->ram_cache->put(read_key, buf.get(), doc->len, http_copy_hdr, o);
         }
         if (!doc_len) {
           // keep a pointer to it. In case the state machine decides to
@@ -441,6 +445,18 @@ CacheVC::handleReadDone(int event, Event * /* e ATS_UNUSED */)
       if (http_copy_hdr && doc->doc_type == CACHE_FRAG_TYPE_HTTP && doc->hlen && okay) {
         unmarshal_helper(doc, buf, okay);
       }
+      // Now that the headers are available, let the RAM cache choose the compression from the response
+      if (in_ram_cache && cache_config_ram_cache_compress && doc->doc_type == CACHE_FRAG_TYPE_HTTP && okay) {
+        CacheHTTPInfo  first_alt;
+        CacheHTTPInfo *info = &alternate;
+        if (doc->hlen) {
+          first_alt.m_alt = reinterpret_cast<HTTPCacheAlt *>(doc->hdr());
+          info            = &first_alt;
+        }
+        if (info->valid()) {
+          stripe->ram_cache->set_compression(read_key, dir_offset(&dir), ram_cache_compression_for(info->response_get()));
+        }
+      }
     } // end io.ok() check
   }
 Ldone:
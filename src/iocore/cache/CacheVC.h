@@ -151,10 +151,14 @@ struct CacheVC : public CacheVConnection {
   int openReadStartHead(int event, Event *e);
   int openReadFromWriter(int event, Event *e);
   int openReadFromWriterMain(int event, Event *e);
+  int openReadFromFanout(int event, Event *e);
   int openReadFromWriterFailure(int event, Event *);
   int openReadChooseWriter(int event, Event *e);
   int openReadDirDelete(int event, Event *e);
 
+  bool fall_back_to_lower_tier();
+  void remove_truncated();
+
   int openWriteCloseDir(int event, Event *e);
   int openWriteCloseHeadDone(int event, Event *e);
   int openWriteCloseHead(int event, Event *e);
@@ -196,6 +200,7 @@ struct CacheVC : public CacheVConnection {
   int64_t get_object_size() override;
   void    set_http_info(CacheHTTPInfo *info) override;
   void    get_http_info(CacheHTTPInfo **info) override;
+  bool    set_sparse_fill(int64_t offset, int64_t object_size) override;
   /** Get the fragment table.
       @return The address of the start of the fragment table,
       or @c nullptr if there is no fragment table.
@@ -260,11 +265,13 @@ struct CacheVC : public CacheVConnection {
   uint32_t                  agg_len;      // for communicating with aggWrite
   uint32_t                  write_serial; // serial of the final write for SYNC
   StripeSM                 *stripe;
+  StripeSM                 *upper_stripe; // stripe a read fell back to the lower tier from
   Dir                      *last_collision;
   Event                    *trigger;
   CacheKey                 *read_key;
   ContinuationHandler       save_handler;
   uint32_t                  pin_in_cache;
+  ink_hrtime                agg_queue_time; // when queued for aggregation, for the wait histogram
   ink_hrtime                start_time;
   int                       op_type; // Index into the metrics array for this operation, rather than a CacheOpType (fewer casts)
   int                       recursive;
@@ -279,6 +286,7 @@ struct CacheVC : public CacheVConnection {
   uint64_t                  total_len;     // total length written and available to write
   uint64_t                  doc_len;       // total_length (of the selected alternate for HTTP)
   uint64_t                  update_len;
+  int64_t                   sparse_skip; // bytes to drop before the first whole fragment of a sparse fill
   int                       fragment;
   int                       scan_msec_delay;
   CacheVC                  *write_vc;
@@ -309,6 +317,7 @@ struct CacheVC : public CacheVConnection {
       unsigned int hit_evacuate             : 1;
       unsigned int compressed_in_ram        : 1; // compressed state in ram cache
       unsigned int allow_empty_doc          : 1; // used for cache empty http document
+      unsigned int sparse                   : 1; // fill of part of a sparse object
     } f;
   };
   // BTF optimization used to skip reading stuff in cache partition that doesn't contain any
@@ -162,6 +162,15 @@ CacheVC::updateVector(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
           ((total_len == 0 && alternate.get_frag_offset_count() == 0) && !(f.allow_empty_doc && this->vio.nbytes == 0))) {
         alternate.copy_frag_offsets_from(write_vector->get(alternate_index));
       }
+      // keep the fragments of any other fill that closed since this one started
+      if (f.sparse && alternate_index >= 0 && write_vector->get(alternate_index)->is_sparse()) {
+        CacheHTTPInfo *old = write_vector->get(alternate_index);
+        for (int i = 0; i <= old->get_frag_offset_count(); ++i) {
+          if (old->is_frag_present(i)) {
+            alternate.mark_frag_present(i);
+          }
+        }
+      }
       alternate_index = write_vector->insert(&alternate, alternate_index);
     }
 
@@ -278,7 +287,8 @@ CacheVC::openWriteCloseDir(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED *
       VC_SCHED_LOCK_RETRY();
     }
     stripe->close_write(this);
-    if (closed < 0 && fragment) {
+    // the earliest fragment of a sparse object may belong to another fill
+    if (closed < 0 && fragment && !f.sparse) {
       stripe->directory.remove(&earliest_key, stripe, &earliest_dir);
     }
   }
@@ -371,7 +381,7 @@ CacheVC::openWriteCloseHead(int event, Event *e)
   cancel_trigger();
   f.use_first_key = 1;
   if (io.ok()) {
-    ink_assert(fragment || (length == static_cast<int64_t>(total_len)));
+    ink_assert(fragment || f.sparse || (length == static_cast<int64_t>(total_len)));
   } else {
     return openWriteCloseDir(event, e);
   }
@@ -409,7 +419,10 @@ CacheVC::openWriteCloseDataDone(int event, Event *e)
     if (!lock.is_locked()) {
       VC_LOCK_RETRY_EVENT();
     }
-    if (!fragment) {
+    if (f.sparse) {
+      // The table of a sparse object is complete, just note the fragment.
+      alternate.mark_frag_present(fragment);
+    } else if (!fragment) {
       ink_assert(key == earliest_key);
       earliest_dir = dir;
     } else {
@@ -429,10 +442,16 @@ CacheVC::openWriteCloseDataDone(int event, Event *e)
       if (write_len > MAX_FRAG_SIZE) {
         write_len = MAX_FRAG_SIZE;
       }
-      if ((ret = do_write_call()) == EVENT_RETURN) {
-        goto Lcallreturn;
+      if (f.sparse) {
+        // only whole fragments are stored
+        write_len = alternate.get_frag_length(fragment);
+      }
+      if (write_len && static_cast<int64_t>(write_len) <= length) {
+        if ((ret = do_write_call()) == EVENT_RETURN) {
+          goto Lcallreturn;
+        }
+        return ret;
       }
-      return ret;
     }
     f.data_done = 1;
     return openWriteCloseHead(event, e); // must be called under vol lock from here
@@ -455,6 +474,21 @@ CacheVC::openWriteClose(int event, Event *e)
     }
   }
   if (closed > 0 || f.allow_empty_doc) {
+    if (f.sparse) {
+      // Only whole fragments of a sparse object are stored, the rest is dropped.
+      write_len = alternate.get_frag_length(fragment);
+      if (write_len && static_cast<int64_t>(write_len) <= length) {
+        SET_HANDLER(&CacheVC::openWriteCloseDataDone);
+        return do_write_lock_call();
+      }
+      if (!write_pos) {
+        // nothing was stored, so there is nothing to add to the vector
+        closed = -1;
+        return openWriteCloseDir(event, e);
+      }
+      f.data_done = 1;
+      return openWriteCloseHead(event, e);
+    }
     if (total_len == 0) {
       if (f.update || f.allow_empty_doc) {
         return updateVector(event, e);
@@ -505,7 +539,9 @@ CacheVC::openWriteWriteDone(int event, Event *e)
     }
     // store the earliest directory. Need to remove the earliest dir
     // in case the writer aborts.
-    if (!fragment) {
+    if (f.sparse) {
+      alternate.mark_frag_present(fragment);
+    } else if (!fragment) {
       ink_assert(key == earliest_key);
       earliest_dir = dir;
     } else {
@@ -514,6 +550,11 @@ CacheVC::openWriteWriteDone(int event, Event *e)
       if (alternate.valid()) {
         alternate.push_frag_offset(write_pos);
       }
+      // Readers following this write can take the fragment from here
+      // rather than read it back.
+      if (od && f.readers && cache_config_read_while_writer_fanout > 0) {
+        od->fanout_add(key, iobufferblock_clone(blocks.get(), offset, write_len), write_len);
+      }
     }
     ++fragment;
     write_pos += write_len;
@@ -538,6 +579,72 @@ target_fragment_size(int target_frag_size)
   return value;
 }
 
+// A fill is merged into a sparse object only if the responses are known to
+// have the same body, by a strong ETag or a Last-Modified time.
+static bool
+same_validators(HTTPHdr *a, HTTPHdr *b)
+{
+  std::string_view a_etag = a->value_get(static_cast<std::string_view>(MIME_FIELD_ETAG));
+  std::string_view b_etag = b->value_get(static_cast<std::string_view>(MIME_FIELD_ETAG));
+  time_t           a_lm   = a->get_last_modified();
+
+  if (a_etag.starts_with("W/") || (a_etag.empty() && !a_lm)) {
+    return false;
+  }
+  return a_etag == b_etag && a_lm == b->get_last_modified();
+}
+
+bool
+CacheVC::set_sparse_fill(int64_t fill_offset, int64_t object_size)
+{
+  if (frag_type != CACHE_FRAG_TYPE_HTTP || !alternate.valid() || f.update || total_len || fill_offset < 0 ||
+      fill_offset >= object_size) {
+    return false;
+  }
+  CACHE_TRY_LOCK(lock, stripe->mutex, mutex->thread_holding);
+  if (!lock.is_locked()) {
+    return false;
+  }
+
+  int64_t        frag_size = target_fragment_size(stripe->frag_size);
+  CacheHTTPInfo *sparse    = nullptr;
+  for (int i = 0; i < write_vector->count() && !sparse; ++i) {
+    CacheHTTPInfo *obj = write_vector->get(i);
+    if (obj->is_sparse() && obj->object_size_get() == object_size &&
+        same_validators(obj->response_get(), alternate.response_get())) {
+      sparse = obj;
+    }
+  }
+  if (sparse) {
+    // Fill in the object already cached, as an update of its alternate.
+    // The fragment size is the one it was created with.
+    f.update = 1;
+    sparse->object_key_get(&update_key);
+    earliest_key = update_key;
+    alternate.object_key_set(update_key);
+    alternate.copy_frag_offsets_from(sparse);
+    alternate.object_size_set(object_size);
+    frag_size = alternate.get_frag_table()[0];
+  } else if (object_size > frag_size) {
+    alternate.init_sparse_frags(object_size, frag_size);
+  } else {
+    // a single fragment, there is nothing to gain from storing a part of it
+    return false;
+  }
+
+  fragment    = (fill_offset + frag_size - 1) / frag_size;
+  sparse_skip = fragment * frag_size - fill_offset;
+  key         = earliest_key;
+  for (int i = 0; i < fragment; ++i) {
+    next_CacheKey(&key, &key);
+  }
+  f.allow_empty_doc = 0;
+  f.sparse          = 1;
+  DDbg(dbg_ctl_cache_write, "sparse fill of %X from fragment %d, %s", first_key.slice32(1), fragment,
+       f.update ? "merged" : "new");
+  return true;
+}
+
 int
 CacheVC::openWriteMain(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
 {
@@ -563,6 +670,13 @@ Lagain:
       return EVENT_CONT;
     }
   }
+  if (sparse_skip > 0) {
+    // drop the bytes before the first whole fragment of a fill
+    int64_t skip = std::min({sparse_skip, vio.ntodo(), vio.get_reader()->read_avail()});
+    vio.get_reader()->consume(skip);
+    vio.ndone   += skip;
+    sparse_skip -= skip;
+  }
   int64_t ntodo       = static_cast<int64_t>(vio.ntodo() + length);
   int64_t total_avail = vio.get_reader()->read_avail();
   int64_t avail       = total_avail;
@@ -587,12 +701,21 @@ Lagain:
     total_len += avail;
   }
   length = static_cast<uint64_t>(towrite);
-  if (length > frag_size && (length < frag_size + frag_size / 4)) {
+  if (f.sparse) {
+    // The fragments of a sparse object have fixed sizes, wait for a whole
+    // one. Anything past the end of the object is never written.
+    int64_t want = alternate.get_frag_length(fragment);
+    if (!want) {
+      blocks = nullptr;
+      length = 0;
+    }
+    write_len = want && length >= want ? want : 0;
+  } else if (length > frag_size && (length < frag_size + frag_size / 4)) {
     write_len = frag_size;
   } else {
     write_len = length;
   }
-  bool not_writing = towrite != ntodo && towrite < frag_size;
+  bool not_writing = f.sparse ? !write_len && towrite != ntodo : towrite != ntodo && towrite < frag_size;
   if (!called_user) {
     if (not_writing) {
       called_user = 1;
@@ -612,6 +735,9 @@ Lagain:
     SET_HANDLER(&CacheVC::openWriteClose);
     return openWriteClose(EVENT_NONE, nullptr);
   }
+  if (!write_len) {
+    return EVENT_CONT;
+  }
   SET_HANDLER(&CacheVC::openWriteWriteDone);
   return do_write_lock_call();
 }
@@ -0,0 +1,98 @@
+/** @file
+
+  A brief file description
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "FrequencySketch.h"
+
+#include <algorithm>
+
+#define SKETCH_COUNTERS_PER_WORD 16
+#define SKETCH_MIN_ENTRIES       1024
+#define SKETCH_SAMPLE_FACTOR     10
+
+void
+FrequencySketch::init(uint64_t expected_entries)
+{
+  uint64_t n = 1;
+  while (n < std::max<uint64_t>(expected_entries, SKETCH_MIN_ENTRIES)) {
+    n <<= 1;
+  }
+  // One word of counters per expected key, shared by all the hash functions.
+  uint64_t ncounters = n * SKETCH_COUNTERS_PER_WORD;
+  this->_table.assign(n, 0);
+  this->_mask        = ncounters - 1;
+  this->_sample_size = n * SKETCH_SAMPLE_FACTOR;
+  this->_additions   = 0;
+}
+
+// Double hashing over the two independent halves of the key.
+uint64_t
+FrequencySketch::_index(const CryptoHash &key, int row) const
+{
+  return (key.u64[0] + row * (key.u64[1] | 1)) & this->_mask;
+}
+
+void
+FrequencySketch::increment(const CryptoHash &key)
+{
+  if (this->_table.empty()) {
+    return;
+  }
+  bool added = false;
+  for (int row = 0; row < DEPTH; ++row) {
+    uint64_t  i     = this->_index(key, row);
+    uint64_t &word  = this->_table[i / SKETCH_COUNTERS_PER_WORD];
+    int       shift = (i % SKETCH_COUNTERS_PER_WORD) * 4;
+    if (((word >> shift) & 0xF) < MAX_FREQUENCY) {
+      word  += uint64_t{1} << shift;
+      added  = true;
+    }
+  }
+  if (added && ++this->_additions >= this->_sample_size) {
+    this->_age();
+  }
+}
+
+int
+FrequencySketch::frequency(const CryptoHash &key) const
+{
+  if (this->_table.empty()) {
+    return 0;
+  }
+  int freq = MAX_FREQUENCY;
+  for (int row = 0; row < DEPTH; ++row) {
+    uint64_t i     = this->_index(key, row);
+    int      shift = (i % SKETCH_COUNTERS_PER_WORD) * 4;
+    freq           = std::min(freq, static_cast<int>((this->_table[i / SKETCH_COUNTERS_PER_WORD] >> shift) & 0xF));
+  }
+  return freq;
+}
+
+// Halve every counter, dropping the low bit of each nibble.
+void
+FrequencySketch::_age()
+{
+  for (auto &word : this->_table) {
+    word = (word >> 1) & 0x7777777777777777ULL;
+  }
+  this->_additions /= 2;
+}
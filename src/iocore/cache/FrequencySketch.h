@@ -0,0 +1,90 @@
+/** @file
+
+  A brief file description
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#pragma once
+
+#include "tscore/CryptoHash.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Approximate access frequency of cache keys.
+ *
+ * This is a count-min sketch of 4-bit saturating counters, packed 16 to a
+ * word, with four hash functions derived from the key. The counters are aged
+ * by halving every one of them once the number of recorded accesses reaches
+ * ten times the sketch width, so that the estimates track recent popularity
+ * rather than all-time popularity.
+ *
+ * This is used as the frequency history for TinyLFU admission in front of a
+ * RamCache. It is not thread safe; like the RamCache it is protected by the
+ * stripe mutex.
+ */
+class FrequencySketch
+{
+public:
+  static constexpr int MAX_FREQUENCY = 15;
+
+  /**
+   * Size the sketch for the given number of distinct keys.
+   *
+   * All counters are cleared.
+   *
+   * @param expected_entries The number of keys expected to be resident in
+   *   the cache this sketch is filtering.
+   */
+  void init(uint64_t expected_entries);
+
+  /**
+   * Record one access to @a key.
+   */
+  void increment(const CryptoHash &key);
+
+  /**
+   * Estimate the number of recent accesses to @a key.
+   *
+   * @return A value between 0 and MAX_FREQUENCY.
+   */
+  int frequency(const CryptoHash &key) const;
+
+  /**
+   * @return The number of bytes used by the counter table.
+   */
+  uint64_t
+  size_in_bytes() const
+  {
+    return this->_table.size() * sizeof(uint64_t);
+  }
+
+private:
+  static constexpr int DEPTH = 4;
+
+  std::vector<uint64_t> _table;
+  uint64_t              _mask        = 0; // counter index mask, the table holds _mask + 1 counters
+  uint64_t              _sample_size = 0;
+  uint64_t              _additions   = 0;
+
+  uint64_t _index(const CryptoHash &key, int row) const;
+  void     _age();
+};
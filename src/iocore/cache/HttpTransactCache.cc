@@ -31,6 +31,8 @@
 #include "proxy/hdrs/HttpCompat.h"
 #include "tscore/ink_time.h"
 
+#include "swoc/TextView.h"
+
 #include <ctime>
 
 namespace
@@ -207,6 +209,12 @@ HttpTransactCache::SelectFromAlternates(CacheHTTPInfoVector *cache_vector, HTTPH
     HTTPHdr       *cached_request  = obj->request_get();
     HTTPHdr       *cached_response = obj->response_get();
 
+    // a partly cached object is only a match for a range it has
+    if (obj->is_sparse() && !HttpTransactCache::is_range_cached(client_request, obj)) {
+      Dbg(dbg_ctl_http_match, "[SelectFromAlternates] sparse alternate %d does not have the range", i);
+      continue;
+    }
+
     if (!(obj->object_key_get().is_zero())) {
       ink_assert(cached_request->valid());
       ink_assert(cached_response->valid());
@@ -1454,3 +1462,50 @@ HttpTransactCache::validate_ifrange_header_if_any(HTTPHdr *request, HTTPHdr *res
   // condition fails if Last-modified not exists
   return (request->get_if_range_date() == lm_value) && (lm_value != 0);
 }
+
+bool
+HttpTransactCache::is_range_cached(HTTPHdr *client_request, HTTPInfo *obj)
+{
+  if (!client_request->presence(MIME_PRESENCE_RANGE) || !validate_ifrange_header_if_any(client_request, obj->response_get())) {
+    return false;
+  }
+
+  swoc::TextView spec{client_request->value_get(static_cast<std::string_view>(MIME_FIELD_RANGE))};
+  spec.trim_if(&isspace);
+  if (!spec.starts_with_nocase("bytes=")) {
+    return false;
+  }
+  spec.remove_prefix(6).trim_if(&isspace);
+  // a multiple range response reads the whole object
+  if (spec.find(',') != swoc::TextView::npos || spec.find('-') == swoc::TextView::npos) {
+    return false;
+  }
+
+  int64_t        size  = obj->object_size_get();
+  swoc::TextView first = spec.take_prefix_at('-').rtrim_if(&isspace);
+  swoc::TextView last  = spec.ltrim_if(&isspace);
+  swoc::TextView parsed;
+  int64_t        start, end;
+
+  if (first.empty()) { // suffix, the last N bytes
+    int64_t n = swoc::svtoi(last, &parsed);
+    if (parsed.size() != last.size() || n <= 0) {
+      return false;
+    }
+    start = std::max<int64_t>(size - n, 0);
+    end   = size - 1;
+  } else {
+    start = swoc::svtoi(first, &parsed);
+    if (parsed.size() != first.size()) {
+      return false;
+    }
+    end = size - 1;
+    if (!last.empty()) {
+      end = std::min<int64_t>(swoc::svtoi(last, &parsed), end);
+      if (parsed.size() != last.size()) {
+        return false;
+      }
+    }
+  }
+  return start <= end && obj->is_range_present(start, end);
+}
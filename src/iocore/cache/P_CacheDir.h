@@ -29,15 +29,19 @@
 #include "iocore/aio/AIO.h"
 #include "tscore/Version.h"
 #include "tscore/hugepages.h"
+#include "tscore/ink_config.h"
 
 #include <cstdint>
 #include <ctime>
+#include <utility>
+#include <vector>
 
 class Stripe;
 class StripeSM;
 struct InterimCacheVol;
 struct CacheVC;
 class CacheEvacuateDocVC;
+struct Directory;
 
 // #define LOOP_CHECK_MODE 1
 
@@ -47,9 +51,16 @@ class CacheEvacuateDocVC;
 
 // Constants
 
-#define DIR_TAG_WIDTH         12
-#define DIR_MASK_TAG(_t)      ((_t) & ((1 << DIR_TAG_WIDTH) - 1))
-#define SIZEOF_DIR            10
+#define DIR_TAG_WIDTH    12
+#define DIR_MASK_TAG(_t) ((_t) & ((1 << DIR_TAG_WIDTH) - 1))
+#if TS_USE_COMPACT_CACHE_DIR
+// Without offset_high, offsets reach 2^24 blocks and stripes are limited to 8GB.
+#define SIZEOF_DIR      8
+#define DIR_OFFSET_BITS 24
+#else
+#define SIZEOF_DIR      10
+#define DIR_OFFSET_BITS 40
+#endif
 #define ESTIMATED_OBJECT_SIZE 8000
 
 #define MAX_DIR_SEGMENTS        (32 * (1 << 16))
@@ -61,7 +72,6 @@ class CacheEvacuateDocVC;
 #define DIR_BLOCK_SHIFT(_i)     (3 * (_i))
 #define DIR_BLOCK_SIZE(_i)      (CACHE_BLOCK_SIZE << DIR_BLOCK_SHIFT(_i))
 #define DIR_SIZE_WITH_BLOCK(_i) ((1 << DIR_SIZE_WIDTH) * DIR_BLOCK_SIZE(_i))
-#define DIR_OFFSET_BITS         40
 #define DIR_OFFSET_MAX          ((((off_t)1) << DIR_OFFSET_BITS) - 1)
 
 #define DO_NOT_REMOVE_THIS 0
@@ -80,6 +90,15 @@ class CacheEvacuateDocVC;
 #endif
 
 #define dir_index(_e, _i) ((Dir *)((char *)(_e)->directory.dir + (SIZEOF_DIR * (_i))))
+#if TS_USE_COMPACT_CACHE_DIR
+#define dir_assign(_e, _x)   \
+  do {                       \
+    (_e)->w[0] = (_x)->w[0]; \
+    (_e)->w[1] = (_x)->w[1]; \
+    (_e)->w[2] = (_x)->w[2]; \
+    (_e)->w[3] = (_x)->w[3]; \
+  } while (0)
+#else
 #define dir_assign(_e, _x)   \
   do {                       \
     (_e)->w[0] = (_x)->w[0]; \
@@ -88,6 +107,7 @@ class CacheEvacuateDocVC;
     (_e)->w[3] = (_x)->w[3]; \
     (_e)->w[4] = (_x)->w[4]; \
   } while (0)
+#endif
 #define dir_assign_data(_e, _x)         \
   do {                                  \
     unsigned short next = dir_next(_e); \
@@ -95,6 +115,15 @@ class CacheEvacuateDocVC;
     dir_set_next(_e, next);             \
   } while (0)
 #define dir_is_empty(_e) (!dir_offset(_e))
+#if TS_USE_COMPACT_CACHE_DIR
+#define dir_clear(_e) \
+  do {                \
+    (_e)->w[0] = 0;   \
+    (_e)->w[1] = 0;   \
+    (_e)->w[2] = 0;   \
+    (_e)->w[3] = 0;   \
+  } while (0)
+#else
 #define dir_clear(_e) \
   do {                \
     (_e)->w[0] = 0;   \
@@ -103,11 +132,13 @@ class CacheEvacuateDocVC;
     (_e)->w[3] = 0;   \
     (_e)->w[4] = 0;   \
   } while (0)
+#endif
 #define dir_clean(_e) dir_set_offset(_e, 0)
 
 // OpenDir
 
-#define OPEN_DIR_BUCKETS 256
+#define OPEN_DIR_BUCKETS    256
+#define OPEN_DIR_FANOUT_MAX 16 // most fragments kept for readers of an object being written
 
 struct EvacuationBlock;
 
@@ -134,13 +165,21 @@ struct Dir {
   unsigned int pinned      : 1;  // (2:14)
   unsigned int token       : 1;  // (2:15)
   unsigned int next        : 16; // (3)
-  unsigned int offset_high : 16; // 8GB * 65k = 0.5PB (4)
+  unsigned int offset_high : 16; // 8GB * 65k = 0.5PB (4), not in TS_USE_COMPACT_CACHE_DIR builds
 #else
-  uint16_t w[5];
+  uint16_t w[SIZEOF_DIR / 2];
   Dir() { dir_clear(this); }
 #endif
 };
 
+#if TS_USE_COMPACT_CACHE_DIR
+#define dir_offset(_e) ((int64_t)(((uint64_t)(_e)->w[0]) | (((uint64_t)((_e)->w[1] & 0xFF)) << 16)))
+#define dir_set_offset(_e, _o)                                              \
+  do {                                                                      \
+    (_e)->w[0] = (uint16_t)_o;                                              \
+    (_e)->w[1] = (uint16_t)((((_o) >> 16) & 0xFF) | ((_e)->w[1] & 0xFF00)); \
+  } while (0)
+#else
 #define dir_offset(_e) \
   ((int64_t)(((uint64_t)(_e)->w[0]) | (((uint64_t)((_e)->w[1] & 0xFF)) << 16) | (((uint64_t)(_e)->w[4]) << 24)))
 #define dir_set_offset(_e, _o)                                              \
@@ -149,6 +188,7 @@ struct Dir {
     (_e)->w[1] = (uint16_t)((((_o) >> 16) & 0xFF) | ((_e)->w[1] & 0xFF00)); \
     (_e)->w[4] = (uint16_t)((_o) >> 24);                                    \
   } while (0)
+#endif
 #define dir_bit(_e, _w, _b)         ((uint32_t)(((_e)->w[_w] >> (_b)) & 1))
 #define dir_set_bit(_e, _w, _b, _v) (_e)->w[_w] = (uint16_t)(((_e)->w[_w] & ~(1 << (_b))) | (((_v) ? 1 : 0) << (_b)))
 #define dir_big(_e)                 ((uint32_t)((((_e)->w[1]) >> 8) & 0x3))
@@ -217,6 +257,21 @@ struct OpenDirEntry {
   bool     reading_vec;                            // somebody is currently reading the vector
   bool     writing_vec;                            // somebody is currently writing the vector
 
+  // The last fragments written while readers were attached. They share the
+  // writer's buffers, so the readers can take them without reading them
+  // back from the stripe.
+  struct Fragment {
+    CacheKey           key;
+    Ptr<IOBufferBlock> data;
+    int64_t            len;
+  };
+  Fragment fanout[OPEN_DIR_FANOUT_MAX];
+  int      fanout_next; // slot the next fragment goes into
+
+  void            fanout_add(const CacheKey &key, IOBufferBlock *data, int64_t len);
+  const Fragment *fanout_find(const CacheKey &key) const;
+  void            fanout_clear();
+
   LINK(OpenDirEntry, link);
 
   bool
@@ -251,8 +306,12 @@ struct CacheSync : public Continuation {
   std::vector<int> stripe_indices;
   int              current_index{0};
 
-  int  mainEvent(int event, Event *e);
-  void aio_write(int fd, char *b, int n, off_t o);
+  std::vector<std::pair<off_t, off_t>> ranges; // parts of the body to compare and write
+  size_t                               next_range{0};
+
+  int   mainEvent(int event, Event *e);
+  void  aio_write(int fd, char *b, int n, off_t o);
+  off_t changed_run(Directory *directory, size_t B);
 
   CacheSync() : Continuation(new_ProxyMutex()) { SET_HANDLER(&CacheSync::mainEvent); }
 
@@ -282,7 +341,7 @@ struct StripeHeaderFooter {
   uint32_t          write_serial;
   uint32_t          dirty;
   uint32_t          sector_size;
-  uint32_t          unused; // pad out to 8 byte boundary
+  uint32_t          dir_entry_size; // SIZEOF_DIR of the writer, 0 if written before it was recorded
   uint16_t          freelist[1];
 };
 
@@ -296,6 +355,19 @@ struct Directory {
   size_t              raw_dir_size{0};     // size of raw_dir allocation (for freeing hugepages)
   bool                raw_dir_huge{false}; // true if raw_dir was allocated with hugepages
 
+  /* The first sync_serial whose snapshot has to include segment s, i.e. the
+     sync_serial following the most recent change to the segment.
+   */
+  std::vector<uint32_t> segment_serial;
+  /* The sync_serial last completely written to copy A and B, 0 if the
+     contents of the copy are unknown and it must be written in full.
+   */
+  uint32_t synced_serial[2]{0, 0};
+  /* Hash of each STORE_BLOCK_SIZE block of the directory as last written
+     to copy A and B, 0 if unknown.
+   */
+  std::vector<uint64_t> synced_hash[2];
+
   /* Total number of dir entries.
    */
   int entries() const;
@@ -304,6 +376,16 @@ struct Directory {
    */
   Dir *get_segment(int s) const;
 
+  /* Record a change to segment @a s for the next directory sync.
+   */
+  void mark_dirty(int s);
+
+  /* Collect the byte ranges of segments changed since the copy that the
+     snapshot with sync_serial @a serial overwrites, relative to raw_dir.
+     Returns false if that copy has to be written in full.
+   */
+  bool dirty_ranges(uint32_t serial, std::vector<std::pair<off_t, off_t>> &ranges) const;
+
   int      probe(const CacheKey *, StripeSM *, Dir *, Dir **);
   int      insert(const CacheKey *key, StripeSM *stripe, Dir *to_part);
   int      overwrite(const CacheKey *key, StripeSM *stripe, Dir *to_part, Dir *overwrite, bool must_overwrite = true);
@@ -330,6 +412,15 @@ Directory::get_segment(int s) const
   return reinterpret_cast<Dir *>((reinterpret_cast<char *>(this->dir)) + (s * this->buckets) * DIR_DEPTH * SIZEOF_DIR);
 }
 
+inline void
+Directory::mark_dirty(int s)
+{
+  this->header->dirty = 1;
+  if (!this->segment_serial.empty()) {
+    this->segment_serial[s] = this->header->sync_serial + 1;
+  }
+}
+
 // Global Functions
 
 int  dir_lookaside_probe(const CacheKey *key, StripeSM *stripe, Dir *result, EvacuationBlock **eblock);
@@ -311,6 +311,7 @@ struct ConfigVol {
   int     fragment_size    = -1;
   int64_t ram_cache_size   = -1; // Per-volume RAM cache size (-1 = use shared allocation)
   int64_t ram_cache_cutoff = -1; // Per-volume RAM cache cutoff (-1 = use global cutoff)
+  int     lower_tier       = 0;  // Volume objects are demoted to (0 = none)
 
   CacheVol *cachep = nullptr;
   LINK(ConfigVol, link);
@@ -116,6 +116,7 @@ extern int cache_config_dir_sync_frequency;
 extern int cache_config_dir_sync_delay;
 extern int cache_config_dir_sync_max_write;
 extern int cache_config_dir_sync_parallel_tasks;
+extern int cache_config_dir_sync_incremental;
 extern int cache_config_http_max_alts;
 extern int cache_config_log_alternate_eviction;
 extern int cache_config_permit_pinning;
@@ -137,6 +138,11 @@ extern int cache_config_target_fragment_size;
 extern int cache_config_mutex_retry_delay;
 extern int cache_read_while_writer_retry_delay;
 extern int cache_config_read_while_writer_max_retries;
+extern int cache_config_read_while_writer_fanout;
+extern int cache_config_tier_promote_hits;
+extern int cache_config_tier_demote_hits;
+extern int cache_config_agg_write_target_latency;
+extern int cache_config_agg_write_max_delay;
 
 #define PUSH_HANDLER(_x)                                          \
   do {                                                            \
@@ -507,7 +513,18 @@ struct Cache {
 
   StripeSM *key_to_stripe(const CacheKey *key, std::string_view hostname, const CacheHostRecord *volume_host_rec = nullptr) const;
 
+  /**
+   * Find the stripe of the lower tier of @a stripe's volume that holds @a key.
+   *
+   * @return The stripe, or @c nullptr if the volume has no lower tier.
+   */
+  static StripeSM *tier_stripe(const CacheKey *key, const StripeSM *stripe);
+
   Cache() {}
+
+private:
+  Action *remove_from(Continuation *cont, const CacheKey *key, CacheFragType type, StripeSM *stripe) const;
+  void    tier_remove(const CacheKey *key, CacheFragType type, StripeSM *stripe) const;
 };
 
 extern Cache *theCache;
@@ -25,9 +25,15 @@
 
 #include "tsutil/Metrics.h"
 
+#include <iterator>
+
 // cache stats definitions, for both global cache metrics, as well as per volume metrics.
 enum class CacheOpType { Lookup = 0, Read, Write, Update, Remove, Evacuate, Scan, Last };
 
+// Upper bounds of the aggregation write histogram buckets, the last bucket counts everything above.
+inline constexpr int CACHE_AGG_HISTOGRAM_MS[]    = {1, 4, 16, 64, 256};
+inline constexpr int CACHE_AGG_HISTOGRAM_BUCKETS = std::size(CACHE_AGG_HISTOGRAM_MS) + 1;
+
 struct CacheStatsBlock {
   struct {
     ts::Metrics::Gauge::AtomicType   *active  = nullptr;
@@ -48,6 +54,9 @@ struct CacheStatsBlock {
   ts::Metrics::Counter::AtomicType *last_open_read_hits    = nullptr;
   ts::Metrics::Counter::AtomicType *agg_buffer_hits        = nullptr;
   ts::Metrics::Counter::AtomicType *ram_cache_misses       = nullptr;
+  ts::Metrics::Counter::AtomicType *ram_cache_admitted     = nullptr;
+  ts::Metrics::Counter::AtomicType *ram_cache_rejected     = nullptr;
+  ts::Metrics::Counter::AtomicType *ram_cache_nolock_hits  = nullptr;
   ts::Metrics::Counter::AtomicType *all_mem_misses         = nullptr;
   ts::Metrics::Counter::AtomicType *pread_count            = nullptr;
   ts::Metrics::Gauge::AtomicType   *percent_full           = nullptr;
@@ -57,6 +66,7 @@ struct CacheStatsBlock {
   ts::Metrics::Counter::AtomicType *directory_collision    = nullptr;
   ts::Metrics::Counter::AtomicType *read_busy_success      = nullptr;
   ts::Metrics::Counter::AtomicType *read_busy_failure      = nullptr;
+  ts::Metrics::Counter::AtomicType *read_busy_fanout_hits  = nullptr;
   ts::Metrics::Counter::AtomicType *gc_bytes_evacuated     = nullptr;
   ts::Metrics::Counter::AtomicType *gc_frags_evacuated     = nullptr;
   ts::Metrics::Counter::AtomicType *write_bytes            = nullptr;
@@ -67,6 +77,7 @@ struct CacheStatsBlock {
   ts::Metrics::Counter::AtomicType *directory_sync_count   = nullptr;
   ts::Metrics::Counter::AtomicType *directory_sync_time    = nullptr;
   ts::Metrics::Counter::AtomicType *directory_sync_bytes   = nullptr;
+  ts::Metrics::Counter::AtomicType *directory_sync_partial = nullptr;
   ts::Metrics::Counter::AtomicType *span_errors_read       = nullptr;
   ts::Metrics::Counter::AtomicType *span_errors_write      = nullptr;
   ts::Metrics::Gauge::AtomicType   *span_offline           = nullptr;
@@ -74,4 +85,12 @@ struct CacheStatsBlock {
   ts::Metrics::Gauge::AtomicType   *span_failing           = nullptr;
   ts::Metrics::Counter::AtomicType *stripe_lock_contention = nullptr;
   ts::Metrics::Counter::AtomicType *writer_lock_contention = nullptr;
+  ts::Metrics::Counter::AtomicType *tier_lower_hits        = nullptr;
+  ts::Metrics::Counter::AtomicType *tier_promoted          = nullptr;
+  ts::Metrics::Counter::AtomicType *tier_demoted           = nullptr;
+  ts::Metrics::Counter::AtomicType *tier_skipped           = nullptr;
+
+  // Time writers wait to be copied into the aggregation buffer, and time the aggregation writes take.
+  ts::Metrics::Counter::AtomicType *agg_write_wait[CACHE_AGG_HISTOGRAM_BUCKETS]    = {};
+  ts::Metrics::Counter::AtomicType *agg_write_latency[CACHE_AGG_HISTOGRAM_BUCKETS] = {};
 };
@@ -28,6 +28,7 @@
 #include "iocore/eventsystem/IOBuffer.h"
 #include "tscore/CryptoHash.h"
 
+class HTTPHdr;
 class StripeSM;
 
 class RamCache
@@ -39,9 +40,37 @@ public:
   virtual int     fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey)                         = 0;
   virtual int64_t size() const                                                                                   = 0;
 
+  // returns 1 on found, 0 on not found or not supported. Looks up by key alone and may be called without the stripe
+  // lock, so it is only implemented by caches which are safe to share across threads.
+  virtual int
+  get_unlocked(CryptoHash * /* key ATS_UNUSED */, Ptr<IOBufferData> * /* ret_data ATS_UNUSED */)
+  {
+    return 0;
+  }
+
+  // returns true if storing len bytes under key would evict, with victim set to the key that would be evicted first
+  virtual bool
+  would_evict(const CryptoHash * /* key ATS_UNUSED */, uint32_t /* len ATS_UNUSED */, CryptoHash * /* victim ATS_UNUSED */) const
+  {
+    return false;
+  }
+
+  // selects the compression algorithm (CACHE_COMPRESSION_*) for an object already stored under key and auxkey,
+  // CACHE_COMPRESSION_NONE keeps it from being compressed at all
+  virtual void
+  set_compression(const CryptoHash * /* key ATS_UNUSED */, uint64_t /* auxkey ATS_UNUSED */, int /* ctype ATS_UNUSED */)
+  {
+  }
+
   virtual void init(int64_t max_bytes, StripeSM *stripe) = 0;
   virtual ~RamCache(){};
 };
 
 RamCache *new_RamCacheLRU();
 RamCache *new_RamCacheCLFUS();
+RamCache *new_RamCacheTinyLFU(RamCache *cache);
+RamCache *new_RamCacheSharded(int nshards);
+
+// RAM cache compression setup, see proxy.config.cache.ram_cache.compress_types
+void ram_cache_compression_init();
+int  ram_cache_compression_for(HTTPHdr *response);
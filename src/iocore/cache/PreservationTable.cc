@@ -120,6 +120,18 @@ PreservationTable::force_evacuate_head(Dir const *evac_dir, int pinned)
   b->readers = 0;            // ensure that the block does not disappear
 }
 
+void
+PreservationTable::force_demote_head(Dir const *evac_dir)
+{
+  if (this->find(*evac_dir)) {
+    return;
+  }
+  this->force_evacuate_head(evac_dir, 0);
+  if (EvacuationBlock *b{this->find(*evac_dir)}; nullptr != b) {
+    b->f.demote = 1;
+  }
+}
+
 int
 PreservationTable::acquire(Dir const &dir, CacheKey const &key)
 {
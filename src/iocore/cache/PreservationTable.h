@@ -61,7 +61,8 @@ struct EvacuationBlock {
       unsigned int done          : 1; // has been evacuated
       unsigned int pinned        : 1; // check pinning timeout
       unsigned int evacuate_head : 1; // check pinning timeout
-      unsigned int unused        : 29;
+      unsigned int demote        : 1; // move to the lower tier instead
+      unsigned int unused        : 28;
     } f;
   };
 
@@ -136,6 +137,15 @@ public:
    */
   void force_evacuate_head(Dir const *evac_dir, int pinned);
 
+  /**
+   * Move the given document to the lower cache tier when it is evacuated.
+   *
+   * Documents that are already preserved for another reason are left alone.
+   *
+   * @param dir The directory entry for the head of the document.
+   */
+  void force_demote_head(Dir const *evac_dir);
+
   /**
    * Find the evacuation block corresponding to @a dir.
    *
@@ -30,11 +30,30 @@
 #include "iocore/eventsystem/IOBuffer.h"
 #include "iocore/eventsystem/Tasks.h"
 #include "fastlz/fastlz.h"
+#include "proxy/hdrs/HTTP.h"
+#include "proxy/hdrs/MIME.h"
+#include "records/RecCore.h"
 #include "tscore/CryptoHash.h"
+#include "tscore/ink_hrtime.h"
+#include "tsutil/Metrics.h"
+#include "swoc/TextView.h"
 #include <zlib.h>
 #ifdef HAVE_LZMA_H
 #include <lzma.h>
 #endif
+#ifdef HAVE_ZSTD_H
+#include <zstd.h>
+#endif
+#ifdef HAVE_LZ4_H
+#include <lz4.h>
+#endif
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #define REQUIRED_COMPRESSION 0.9 // must get to this size or declared incompressible
 #define REQUIRED_SHRINK      0.8 // must get to this size or keep original buffer (with padding)
@@ -62,6 +81,121 @@ DbgCtl dbg_ctl_ram_cache_compare{"ram_cache_compare"};
 
 #endif
 
+namespace
+{
+
+const char *compression_names[] = {"none", "fastlz", "libz", "liblzma", "zstd", "lz4"};
+
+// Compression histograms, per algorithm. A ratio bucket counts entries which compressed to at most that percentage of
+// their original size, a cost bucket counts entries which took at most that many nanoseconds per input byte.
+constexpr int RATIO_BUCKETS[]     = {25, 50, 75, 100};
+constexpr int COST_BUCKETS[]      = {1, 4, 16, 64};
+constexpr int NUM_RATIO_BUCKETS   = std::size(RATIO_BUCKETS);
+constexpr int NUM_COST_BUCKETS    = std::size(COST_BUCKETS);
+constexpr int NUM_COMPRESSION_ALG = std::size(compression_names);
+
+struct {
+  ts::Metrics::Counter::AtomicType *bytes_in                 = nullptr;
+  ts::Metrics::Counter::AtomicType *bytes_out                = nullptr;
+  ts::Metrics::Counter::AtomicType *time                     = nullptr;
+  ts::Metrics::Counter::AtomicType *decompress_time          = nullptr;
+  ts::Metrics::Counter::AtomicType *ratio[NUM_RATIO_BUCKETS] = {};
+  ts::Metrics::Counter::AtomicType *cost[NUM_COST_BUCKETS]   = {};
+} compress_rsb[NUM_COMPRESSION_ALG];
+
+// Content-Type prefixes and the compression to use for them, first match wins.
+std::vector<std::pair<std::string, int>> compress_types;
+
+#ifdef HAVE_ZSTD_H
+int         zstd_level = ZSTD_CLEVEL_DEFAULT;
+ZSTD_CDict *zstd_cdict = nullptr;
+ZSTD_DDict *zstd_ddict = nullptr;
+
+// zstd contexts are reusable but not thread safe, keep one per thread.
+ZSTD_CCtx *
+zstd_cctx()
+{
+  thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> ctx{ZSTD_createCCtx(), &ZSTD_freeCCtx};
+  return ctx.get();
+}
+
+ZSTD_DCtx *
+zstd_dctx()
+{
+  thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> ctx{ZSTD_createDCtx(), &ZSTD_freeDCtx};
+  return ctx.get();
+}
+#endif
+
+int
+compression_by_name(swoc::TextView name)
+{
+  if (0 == strcasecmp(name, swoc::TextView{"default"})) {
+    return -1;
+  }
+  for (int i = 0; i < NUM_COMPRESSION_ALG; i++) {
+    if (0 == strcasecmp(name, swoc::TextView{compression_names[i]})) {
+      return i;
+    }
+  }
+  return -2;
+}
+
+bool
+compression_available(int ctype)
+{
+  switch (ctype) {
+  case CACHE_COMPRESSION_LIBLZMA:
+#ifdef HAVE_LZMA_H
+    return true;
+#else
+    return false;
+#endif
+  case CACHE_COMPRESSION_ZSTD:
+#ifdef HAVE_ZSTD_H
+    return true;
+#else
+    return false;
+#endif
+  case CACHE_COMPRESSION_LZ4:
+#ifdef HAVE_LZ4_H
+    return true;
+#else
+    return false;
+#endif
+  default:
+    return true;
+  }
+}
+
+void
+record_compression(int ctype, uint32_t len, uint32_t compressed_len, ink_hrtime elapsed)
+{
+  auto &rsb = compress_rsb[ctype];
+  if (!rsb.bytes_in) {
+    return;
+  }
+  ts::Metrics::Counter::increment(rsb.bytes_in, len);
+  ts::Metrics::Counter::increment(rsb.bytes_out, compressed_len);
+  ts::Metrics::Counter::increment(rsb.time, elapsed);
+
+  int64_t percent = len ? (static_cast<int64_t>(compressed_len) * 100) / len : 100;
+  int     i       = 0;
+  while (i < NUM_RATIO_BUCKETS - 1 && percent > RATIO_BUCKETS[i]) {
+    ++i;
+  }
+  ts::Metrics::Counter::increment(rsb.ratio[i]);
+
+  int64_t per_byte = len ? elapsed / len : 0;
+  i                = 0;
+  while (i < NUM_COST_BUCKETS - 1 && per_byte > COST_BUCKETS[i]) {
+    ++i;
+  }
+  ts::Metrics::Counter::increment(rsb.cost[i]);
+}
+
+} // end anonymous namespace
+
 struct RamCacheCLFUSEntry {
   CryptoHash key;
   uint64_t   auxkey;
@@ -73,6 +207,7 @@ struct RamCacheCLFUSEntry {
     struct {
       uint32_t compressed     : 3; // compression type
       uint32_t incompressible : 1;
+      uint32_t compress_type  : 3; // compression to use, 0 for proxy.config.cache.ram_cache.compress
       uint32_t lru            : 1;
       uint32_t copy           : 1; // copy-in-copy-out
     } flag_bits;
@@ -93,6 +228,8 @@ public:
   int     put(CryptoHash *key, IOBufferData *data, uint32_t len, bool copy = false, uint64_t auxkey = 0) override;
   int     fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey) override;
   int64_t size() const override;
+  bool    would_evict(const CryptoHash *key, uint32_t len, CryptoHash *victim) const override;
+  void    set_compression(const CryptoHash *key, uint64_t auxkey, int ctype) override;
 
   void init(int64_t max_bytes, StripeSM *stripe) override;
 
@@ -164,6 +301,16 @@ RamCacheCLFUSCompressor::mainEvent(int /* event ATS_UNUSED */, Event *e)
   case CACHE_COMPRESSION_LIBLZMA:
 #ifndef HAVE_LZMA_H
     Warning("lzma not available for RAM cache compression");
+#endif
+    break;
+  case CACHE_COMPRESSION_ZSTD:
+#ifndef HAVE_ZSTD_H
+    Warning("zstd not available for RAM cache compression");
+#endif
+    break;
+  case CACHE_COMPRESSION_LZ4:
+#ifndef HAVE_LZ4_H
+    Warning("lz4 not available for RAM cache compression");
 #endif
     break;
   }
@@ -266,7 +413,8 @@ RamCacheCLFUS::get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey
         e->hits++;
         uint32_t ram_hit_state = RAM_HIT_COMPRESS_NONE;
         if (e->flag_bits.compressed) {
-          b = static_cast<char *>(ats_malloc(e->len));
+          b                = static_cast<char *>(ats_malloc(e->len));
+          ink_hrtime start = ink_get_hrtime();
           switch (e->flag_bits.compressed) {
           default:
             goto Lfailed;
@@ -298,8 +446,32 @@ RamCacheCLFUS::get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey
             ram_hit_state = RAM_HIT_COMPRESS_LIBLZMA;
             break;
           }
+#endif
+#ifdef HAVE_ZSTD_H
+          case CACHE_COMPRESSION_ZSTD: {
+            char  *cdata = e->data->data();
+            size_t l     = zstd_ddict ? ZSTD_decompress_usingDDict(zstd_dctx(), b, e->len, cdata, e->compressed_len, zstd_ddict) :
+                                        ZSTD_decompressDCtx(zstd_dctx(), b, e->len, cdata, e->compressed_len);
+            if (ZSTD_isError(l) || l != e->len) {
+              goto Lfailed;
+            }
+            ram_hit_state = RAM_HIT_COMPRESS_ZSTD;
+            break;
+          }
+#endif
+#ifdef HAVE_LZ4_H
+          case CACHE_COMPRESSION_LZ4: {
+            if (static_cast<int>(e->len) != LZ4_decompress_safe(e->data->data(), b, e->compressed_len, e->len)) {
+              goto Lfailed;
+            }
+            ram_hit_state = RAM_HIT_COMPRESS_LZ4;
+            break;
+          }
 #endif
           }
+          if (compress_rsb[e->flag_bits.compressed].decompress_time) {
+            ts::Metrics::Counter::increment(compress_rsb[e->flag_bits.compressed].decompress_time, ink_get_hrtime() - start);
+          }
           IOBufferData *data = new_xmalloc_IOBufferData(b, e->len);
           data->_mem_type    = DEFAULT_ALLOC;
           if (!e->flag_bits.copy) { // don't bother if we have to copy anyway
@@ -451,7 +623,7 @@ RamCacheCLFUS::compress_entries(EThread *thread, int do_at_most)
     {
       e->compressed_len = e->size;
       uint32_t l        = 0;
-      int      ctype    = cache_config_ram_cache_compress;
+      int      ctype    = e->flag_bits.compress_type ? e->flag_bits.compress_type : cache_config_ram_cache_compress;
       switch (ctype) {
       default:
         goto Lcontinue;
@@ -465,6 +637,16 @@ RamCacheCLFUS::compress_entries(EThread *thread, int do_at_most)
       case CACHE_COMPRESSION_LIBLZMA:
         l = e->len;
         break;
+#endif
+#ifdef HAVE_ZSTD_H
+      case CACHE_COMPRESSION_ZSTD:
+        l = static_cast<uint32_t>(ZSTD_compressBound(e->len));
+        break;
+#endif
+#ifdef HAVE_LZ4_H
+      case CACHE_COMPRESSION_LZ4:
+        l = static_cast<uint32_t>(LZ4_compressBound(e->len));
+        break;
 #endif
       }
       // store transient data for lock release
@@ -472,8 +654,9 @@ RamCacheCLFUS::compress_entries(EThread *thread, int do_at_most)
       uint32_t          elen  = e->len;
       CryptoHash        key   = e->key;
       MUTEX_UNTAKE_LOCK(stripe->mutex, thread);
-      b           = static_cast<char *>(ats_malloc(l));
-      bool failed = false;
+      b                = static_cast<char *>(ats_malloc(l));
+      bool       failed = false;
+      ink_hrtime start  = ink_get_hrtime();
       switch (ctype) {
       default:
         goto Lfailed;
@@ -505,6 +688,30 @@ RamCacheCLFUS::compress_entries(EThread *thread, int do_at_most)
         break;
       }
 #endif
+#ifdef HAVE_ZSTD_H
+      case CACHE_COMPRESSION_ZSTD: {
+        size_t ll = zstd_cdict ? ZSTD_compress_usingCDict(zstd_cctx(), b, l, edata->data(), elen, zstd_cdict) :
+                                 ZSTD_compressCCtx(zstd_cctx(), b, l, edata->data(), elen, zstd_level);
+        if (ZSTD_isError(ll)) {
+          failed = true;
+        }
+        l = static_cast<uint32_t>(ll);
+        break;
+      }
+#endif
+#ifdef HAVE_LZ4_H
+      case CACHE_COMPRESSION_LZ4: {
+        int ll = LZ4_compress_default(edata->data(), b, elen, l);
+        if (ll <= 0) {
+          failed = true;
+        }
+        l = static_cast<uint32_t>(ll);
+        break;
+      }
+#endif
+      }
+      if (!failed) {
+        record_compression(ctype, elen, l, ink_get_hrtime() - start);
       }
       MUTEX_TAKE_LOCK(stripe->mutex, thread);
       // see if the entry is till around
@@ -533,7 +740,7 @@ RamCacheCLFUS::compress_entries(EThread *thread, int do_at_most)
         goto Lfailed;
       }
       if (l < e->len) {
-        e->flag_bits.compressed = cache_config_ram_cache_compress;
+        e->flag_bits.compressed = ctype;
         bb                      = static_cast<char *>(ats_malloc(l));
         memcpy(bb, b, l);
         ats_free(b);
@@ -786,9 +993,134 @@ RamCacheCLFUS::fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_au
   return 0;
 }
 
+bool
+RamCacheCLFUS::would_evict(const CryptoHash *key, uint32_t len, CryptoHash *victim) const
+{
+  if (!this->_max_bytes || this->_bytes + len + ENTRY_OVERHEAD <= this->_max_bytes || !this->_lru[0].head) {
+    return false;
+  }
+  uint32_t i = key->slice32(3) % this->_nbuckets;
+  for (RamCacheCLFUSEntry *e = this->_bucket[i].head; e; e = e->hash_link.next) {
+    if (e->key == *key && !e->flag_bits.lru) { // already resident, put() only refreshes it
+      return false;
+    }
+  }
+  *victim = this->_lru[0].head->key;
+  return true;
+}
+
+void
+RamCacheCLFUS::set_compression(const CryptoHash *key, uint64_t auxkey, int ctype)
+{
+  if (!this->_max_bytes) {
+    return;
+  }
+  uint32_t i = key->slice32(3) % this->_nbuckets;
+  for (RamCacheCLFUSEntry *e = this->_bucket[i].head; e; e = e->hash_link.next) {
+    if (e->key == *key && e->auxkey == auxkey) {
+      if (!e->flag_bits.lru && !e->flag_bits.compressed) {
+        if (ctype == CACHE_COMPRESSION_NONE) {
+          e->flag_bits.incompressible = 1;
+        } else {
+          e->flag_bits.compress_type = ctype;
+        }
+      }
+      return;
+    }
+  }
+}
+
 RamCache *
 new_RamCacheCLFUS()
 {
   RamCacheCLFUS *r = new RamCacheCLFUS;
   return r;
 }
+
+void
+ram_cache_compression_init()
+{
+  for (int i = CACHE_COMPRESSION_FASTLZ; i < NUM_COMPRESSION_ALG; i++) {
+    std::string prefix = std::string("proxy.process.cache.ram_cache.compress.") + compression_names[i];
+    auto       &rsb    = compress_rsb[i];
+
+    rsb.bytes_in        = ts::Metrics::Counter::createPtr(prefix + ".bytes_in");
+    rsb.bytes_out       = ts::Metrics::Counter::createPtr(prefix + ".bytes_out");
+    rsb.time            = ts::Metrics::Counter::createPtr(prefix + ".time");
+    rsb.decompress_time = ts::Metrics::Counter::createPtr(prefix + ".decompress_time");
+    for (int j = 0; j < NUM_RATIO_BUCKETS; j++) {
+      rsb.ratio[j] = ts::Metrics::Counter::createPtr(prefix + ".ratio_" + std::to_string(RATIO_BUCKETS[j]));
+    }
+    for (int j = 0; j < NUM_COST_BUCKETS; j++) {
+      rsb.cost[j] = ts::Metrics::Counter::createPtr(prefix + ".cost_" + std::to_string(COST_BUCKETS[j]) + "ns");
+    }
+  }
+
+  compress_types.clear();
+  if (auto types = RecGetRecordStringAlloc("proxy.config.cache.ram_cache.compress_types"); types) {
+    swoc::TextView list{types.value()};
+    while (list) {
+      swoc::TextView item = list.take_prefix_at(',').trim_if(&isspace);
+      if (item.empty()) {
+        continue;
+      }
+      swoc::TextView type  = item.take_prefix_at(':').trim_if(&isspace);
+      int            ctype = compression_by_name(item.trim_if(&isspace));
+      if (type.empty() || ctype < -1) {
+        Warning("invalid entry '%.*s:%.*s' in proxy.config.cache.ram_cache.compress_types", static_cast<int>(type.size()),
+                type.data(), static_cast<int>(item.size()), item.data());
+        continue;
+      }
+      if (ctype >= 0 && !compression_available(ctype)) {
+        Warning("%s not available for RAM cache compression of '%.*s'", compression_names[ctype], static_cast<int>(type.size()),
+                type.data());
+        continue;
+      }
+      compress_types.emplace_back(std::string{type}, ctype);
+    }
+  }
+
+#ifdef HAVE_ZSTD_H
+  zstd_level = RecGetRecordInt("proxy.config.cache.ram_cache.zstd_level").value_or(ZSTD_CLEVEL_DEFAULT);
+  if (std::string path = RecConfigReadConfigPath("proxy.config.cache.ram_cache.zstd_dictionary"); !path.empty()) {
+    std::ifstream file{path, std::ios::binary};
+    std::string   dict{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    if (dict.empty()) {
+      Warning("unable to read RAM cache zstd dictionary '%s'", path.c_str());
+    } else {
+      zstd_cdict = ZSTD_createCDict(dict.data(), dict.size(), zstd_level);
+      zstd_ddict = ZSTD_createDDict(dict.data(), dict.size());
+      if (!zstd_cdict || !zstd_ddict) {
+        Warning("invalid RAM cache zstd dictionary '%s'", path.c_str());
+        ZSTD_freeCDict(zstd_cdict);
+        ZSTD_freeDDict(zstd_ddict);
+        zstd_cdict = nullptr;
+        zstd_ddict = nullptr;
+      } else {
+        Note("loaded RAM cache zstd dictionary '%s', %zu bytes, id %u", path.c_str(), dict.size(),
+             ZSTD_getDictID_fromDDict(zstd_ddict));
+      }
+    }
+  }
+#endif
+}
+
+// returns the compression to use for a response, based on its Content-Encoding and Content-Type
+int
+ram_cache_compression_for(HTTPHdr *response)
+{
+  if (!response || !response->valid()) {
+    return cache_config_ram_cache_compress;
+  }
+  swoc::TextView encoding{response->value_get(static_cast<std::string_view>(MIME_FIELD_CONTENT_ENCODING))};
+  if (!encoding.empty() && 0 != strcasecmp(encoding, swoc::TextView{"identity"})) {
+    return CACHE_COMPRESSION_NONE; // already compressed by the origin
+  }
+  swoc::TextView type{response->value_get(static_cast<std::string_view>(MIME_FIELD_CONTENT_TYPE))};
+  for (auto const &[prefix, ctype] : compress_types) {
+    if (type.starts_with_nocase(prefix)) {
+      return ctype < 0 ? cache_config_ram_cache_compress : ctype;
+    }
+  }
+  return cache_config_ram_cache_compress;
+}
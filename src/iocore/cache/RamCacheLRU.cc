@@ -50,6 +50,7 @@ struct RamCacheLRU : public RamCache {
   int     put(CryptoHash *key, IOBufferData *data, uint32_t len, bool copy = false, uint64_t auxkey = 0) override;
   int     fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey) override;
   int64_t size() const override;
+  bool    would_evict(const CryptoHash *key, uint32_t len, CryptoHash *victim) const override;
 
   void init(int64_t max_bytes, StripeSM *stripe) override;
 
@@ -262,6 +263,22 @@ RamCacheLRU::fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxk
   return 0;
 }
 
+bool
+RamCacheLRU::would_evict(const CryptoHash *key, uint32_t len, CryptoHash *victim) const
+{
+  if (!max_bytes || bytes + ENTRY_OVERHEAD + len <= max_bytes || !lru.head) {
+    return false;
+  }
+  uint32_t i = key->slice32(3) % nbuckets;
+  for (RamCacheLRUEntry *e = bucket[i].head; e; e = e->hash_link.next) {
+    if (e->key == *key) { // already resident, put() only refreshes it
+      return false;
+    }
+  }
+  *victim = lru.head->key;
+  return true;
+}
+
 RamCache *
 new_RamCacheLRU()
 {
@@ -0,0 +1,331 @@
+/** @file
+
+  A brief file description
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+// Sharded RAM cache which does not rely on the stripe mutex.
+//
+// Entries are spread over independent shards by key hash. Each shard has its own reader-writer lock, readers take it
+// shared and only set the entry's CLOCK reference bit, so RAM hits on different threads do not serialize. Inserts,
+// fixups and evictions take the shard lock exclusively. Every miss is followed by an insert, so a BRAVO lock would
+// pay for reader revocation far too often here.
+
+#include "P_RamCache.h"
+#include "P_CacheInternal.h"
+#include "StripeSM.h"
+#include "iocore/eventsystem/IOBuffer.h"
+#include "tscore/CryptoHash.h"
+#include "tscore/List.h"
+#include "tsutil/TsSharedMutex.h"
+
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+struct RamCacheShardedEntry {
+  CryptoHash        key;
+  uint64_t          auxkey;
+  std::atomic<bool> referenced{false};
+  LINK(RamCacheShardedEntry, clock_link);
+  LINK(RamCacheShardedEntry, hash_link);
+  Ptr<IOBufferData> data;
+};
+
+#define ENTRY_OVERHEAD 128 // per-entry overhead to consider when computing sizes
+
+struct RamCacheShard {
+  ts::shared_mutex mutex;
+
+  int64_t max_bytes = 0;
+  int64_t bytes     = 0;
+  int64_t objects   = 0;
+
+  Que(RamCacheShardedEntry, clock_link) clock; // the clock hand is at the head
+  DList(RamCacheShardedEntry, hash_link) *bucket = nullptr;
+  int nbuckets                                   = 0;
+  int ibuckets                                   = 0;
+
+  RamCacheShardedEntry *find(const CryptoHash *key) const;
+};
+
+class RamCacheSharded : public RamCache
+{
+public:
+  explicit RamCacheSharded(int nshards) : _nshards(nshards), _shards(new RamCacheShard[nshards]) {}
+  ~RamCacheSharded() override;
+
+  // returns 1 on found/stored, 0 on not found/stored, if provided auxkey must match
+  int     get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey = 0) override;
+  int     get_unlocked(CryptoHash *key, Ptr<IOBufferData> *ret_data) override;
+  int     put(CryptoHash *key, IOBufferData *data, uint32_t len, bool copy = false, uint64_t auxkey = 0) override;
+  int     fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey) override;
+  int64_t size() const override;
+
+  void init(int64_t max_bytes, StripeSM *stripe) override;
+
+private:
+  int                              _nshards = 0;
+  std::unique_ptr<RamCacheShard[]> _shards;
+  StripeSM                        *_stripe = nullptr; // for stats
+
+  RamCacheShard &
+  _shard(const CryptoHash *key) const
+  {
+    return this->_shards[key->slice32(1) % this->_nshards];
+  }
+
+  void                  _resize_hashtable(RamCacheShard &shard);
+  RamCacheShardedEntry *_remove(RamCacheShard &shard, RamCacheShardedEntry *e);
+  void                  _evict(RamCacheShard &shard);
+};
+
+#ifdef DEBUG
+
+namespace
+{
+
+DbgCtl dbg_ctl_ram_cache{"ram_cache"};
+
+} // end anonymous namespace
+
+#endif
+
+ClassAllocator<RamCacheShardedEntry, false> ramCacheShardedEntryAllocator("RamCacheShardedEntry");
+
+static const int bucket_sizes[] = {8191,    16381,   32749,    65521,    131071,   262139,    524287,    1048573,   2097143,
+                                   4194301, 8388593, 16777213, 33554393, 67108859, 134217689, 268435399, 536870909, 1073741827};
+
+RamCacheShardedEntry *
+RamCacheShard::find(const CryptoHash *key) const
+{
+  for (RamCacheShardedEntry *e = this->bucket[key->slice32(3) % this->nbuckets].head; e; e = e->hash_link.next) {
+    if (e->key == *key) {
+      return e;
+    }
+  }
+  return nullptr;
+}
+
+RamCacheSharded::~RamCacheSharded()
+{
+  for (int i = 0; i < this->_nshards; i++) {
+    ats_free(this->_shards[i].bucket);
+  }
+}
+
+int64_t
+RamCacheSharded::size() const
+{
+  int64_t s = 0;
+  for (int i = 0; i < this->_nshards; i++) {
+    RamCacheShard                           &shard = this->_shards[i];
+    std::lock_guard<ts::shared_mutex> lock(shard.mutex);
+    forl_LL(RamCacheShardedEntry, e, shard.clock)
+    {
+      s += sizeof(*e);
+      s += sizeof(*e->data);
+      s += e->data->block_size();
+    }
+  }
+  return s;
+}
+
+void
+RamCacheSharded::_resize_hashtable(RamCacheShard &shard)
+{
+  ink_release_assert(shard.ibuckets < static_cast<int>(std::size(bucket_sizes)));
+
+  int anbuckets = bucket_sizes[shard.ibuckets];
+  DDbg(dbg_ctl_ram_cache, "resize shard hashtable %d", anbuckets);
+  int64_t s                                          = anbuckets * sizeof(DList(RamCacheShardedEntry, hash_link));
+  DList(RamCacheShardedEntry, hash_link) *new_bucket = static_cast<DList(RamCacheShardedEntry, hash_link) *>(ats_malloc(s));
+  memset(static_cast<void *>(new_bucket), 0, s);
+  if (shard.bucket) {
+    for (int64_t i = 0; i < shard.nbuckets; i++) {
+      RamCacheShardedEntry *e = nullptr;
+      while ((e = shard.bucket[i].pop())) {
+        new_bucket[e->key.slice32(3) % anbuckets].push(e);
+      }
+    }
+    ats_free(shard.bucket);
+  }
+  shard.bucket   = new_bucket;
+  shard.nbuckets = anbuckets;
+}
+
+void
+RamCacheSharded::init(int64_t abytes, StripeSM *astripe)
+{
+  this->_stripe = astripe;
+  DDbg(dbg_ctl_ram_cache, "initializing ram_cache %" PRId64 " bytes in %d shards", abytes, this->_nshards);
+  for (int i = 0; i < this->_nshards; i++) {
+    RamCacheShard &shard = this->_shards[i];
+    shard.max_bytes      = abytes / this->_nshards;
+    if (shard.max_bytes) {
+      this->_resize_hashtable(shard);
+    }
+  }
+}
+
+int
+RamCacheSharded::get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey)
+{
+  RamCacheShard &shard = this->_shard(key);
+  if (!shard.max_bytes) {
+    return 0;
+  }
+  {
+    std::shared_lock<ts::shared_mutex> lock(shard.mutex);
+    RamCacheShardedEntry                           *e = shard.find(key);
+    if (e && e->auxkey == auxkey) {
+      e->referenced.store(true, std::memory_order_relaxed);
+      (*ret_data) = e->data;
+      DDbg(dbg_ctl_ram_cache, "get %X %" PRIu64 " HIT", key->slice32(3), auxkey);
+      ts::Metrics::Counter::increment(cache_rsb.ram_cache_hits);
+      ts::Metrics::Counter::increment(this->_stripe->cache_vol->vol_rsb.ram_cache_hits);
+      return 1;
+    }
+  }
+  DDbg(dbg_ctl_ram_cache, "get %X %" PRIu64 " MISS", key->slice32(3), auxkey);
+  ts::Metrics::Counter::increment(cache_rsb.ram_cache_misses);
+  ts::Metrics::Counter::increment(this->_stripe->cache_vol->vol_rsb.ram_cache_misses);
+  return 0;
+}
+
+// Misses are not counted here, the caller falls back to get() under the stripe lock.
+int
+RamCacheSharded::get_unlocked(CryptoHash *key, Ptr<IOBufferData> *ret_data)
+{
+  RamCacheShard &shard = this->_shard(key);
+  if (!shard.max_bytes) {
+    return 0;
+  }
+  std::shared_lock<ts::shared_mutex> lock(shard.mutex);
+  RamCacheShardedEntry                           *e = shard.find(key);
+  if (!e) {
+    return 0;
+  }
+  e->referenced.store(true, std::memory_order_relaxed);
+  (*ret_data) = e->data;
+  DDbg(dbg_ctl_ram_cache, "get %X UNLOCKED HIT", key->slice32(3));
+  ts::Metrics::Counter::increment(cache_rsb.ram_cache_hits);
+  ts::Metrics::Counter::increment(this->_stripe->cache_vol->vol_rsb.ram_cache_hits);
+  ts::Metrics::Counter::increment(cache_rsb.ram_cache_nolock_hits);
+  ts::Metrics::Counter::increment(this->_stripe->cache_vol->vol_rsb.ram_cache_nolock_hits);
+  return 1;
+}
+
+RamCacheShardedEntry *
+RamCacheSharded::_remove(RamCacheShard &shard, RamCacheShardedEntry *e)
+{
+  RamCacheShardedEntry *ret = e->hash_link.next;
+  shard.bucket[e->key.slice32(3) % shard.nbuckets].remove(e);
+  shard.clock.remove(e);
+  shard.bytes -= ENTRY_OVERHEAD + e->data->block_size();
+  ts::Metrics::Gauge::decrement(cache_rsb.ram_cache_bytes, ENTRY_OVERHEAD + e->data->block_size());
+  ts::Metrics::Gauge::decrement(this->_stripe->cache_vol->vol_rsb.ram_cache_bytes, ENTRY_OVERHEAD + e->data->block_size());
+
+  DDbg(dbg_ctl_ram_cache, "put %X %" PRIu64 " FREED", e->key.slice32(3), e->auxkey);
+  e->data = nullptr;
+  THREAD_FREE(e, ramCacheShardedEntryAllocator, this_thread());
+  shard.objects--;
+  return ret;
+}
+
+// CLOCK: referenced entries at the hand get a second chance, the first unreferenced one is evicted.
+void
+RamCacheSharded::_evict(RamCacheShard &shard)
+{
+  while (shard.bytes > shard.max_bytes) {
+    RamCacheShardedEntry *e = shard.clock.head;
+    if (!e) {
+      break;
+    }
+    if (e->referenced.exchange(false, std::memory_order_relaxed)) {
+      shard.clock.remove(e);
+      shard.clock.enqueue(e);
+      continue;
+    }
+    this->_remove(shard, e);
+  }
+}
+
+// ignore 'copy' since we don't touch the data
+int
+RamCacheSharded::put(CryptoHash *key, IOBufferData *data, [[maybe_unused]] uint32_t len, bool, uint64_t auxkey)
+{
+  RamCacheShard &shard = this->_shard(key);
+  if (!shard.max_bytes) {
+    return 0;
+  }
+  std::lock_guard<ts::shared_mutex> lock(shard.mutex);
+
+  RamCacheShardedEntry *e = shard.find(key);
+  if (e) {
+    if (e->auxkey == auxkey) {
+      e->referenced.store(true, std::memory_order_relaxed);
+      return 1;
+    }
+    this->_remove(shard, e); // discard when aux keys conflict
+  }
+  e         = THREAD_ALLOC(ramCacheShardedEntryAllocator, this_ethread());
+  e->key    = *key;
+  e->auxkey = auxkey;
+  e->data   = data;
+  e->referenced.store(false, std::memory_order_relaxed);
+  shard.bucket[key->slice32(3) % shard.nbuckets].push(e);
+  shard.clock.enqueue(e);
+  shard.bytes += ENTRY_OVERHEAD + data->block_size();
+  shard.objects++;
+  ts::Metrics::Gauge::increment(cache_rsb.ram_cache_bytes, ENTRY_OVERHEAD + data->block_size());
+  ts::Metrics::Gauge::increment(this->_stripe->cache_vol->vol_rsb.ram_cache_bytes, ENTRY_OVERHEAD + data->block_size());
+  this->_evict(shard);
+  DDbg(dbg_ctl_ram_cache, "put %X %" PRIu64 " INSERTED", key->slice32(3), auxkey);
+  if (shard.objects > shard.nbuckets * 0.75) { // Resize when 75% "full"
+    ++shard.ibuckets;
+    this->_resize_hashtable(shard);
+  }
+  return 1;
+}
+
+int
+RamCacheSharded::fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey)
+{
+  RamCacheShard &shard = this->_shard(key);
+  if (!shard.max_bytes) {
+    return 0;
+  }
+  std::lock_guard<ts::shared_mutex> lock(shard.mutex);
+  RamCacheShardedEntry                    *e = shard.find(key);
+  if (e && e->auxkey == old_auxkey) {
+    e->auxkey = new_auxkey;
+    return 1;
+  }
+  return 0;
+}
+
+RamCache *
+new_RamCacheSharded(int nshards)
+{
+  return new RamCacheSharded(nshards);
+}
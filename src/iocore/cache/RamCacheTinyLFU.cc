@@ -0,0 +1,137 @@
+/** @file
+
+  A brief file description
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+// TinyLFU admission filter, usable in front of any RamCache replacement policy.
+// See Einziger, Friedman and Manes, "TinyLFU: A Highly Efficient Cache Admission Policy".
+
+#include "P_RamCache.h"
+#include "P_CacheInternal.h"
+#include "FrequencySketch.h"
+#include "StripeSM.h"
+#include "iocore/eventsystem/IOBuffer.h"
+#include "tscore/CryptoHash.h"
+
+#define SKETCH_AVERAGE_ENTRY_SIZE (16 * 1024) // used to derive the number of keys to track from the RAM cache size
+
+#ifdef DEBUG
+
+namespace
+{
+
+DbgCtl dbg_ctl_ram_cache{"ram_cache"};
+
+} // end anonymous namespace
+
+#endif
+
+class RamCacheTinyLFU : public RamCache
+{
+public:
+  explicit RamCacheTinyLFU(RamCache *cache) : _cache(cache) {}
+  ~RamCacheTinyLFU() override { delete this->_cache; }
+
+  int     get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey = 0) override;
+  int     put(CryptoHash *key, IOBufferData *data, uint32_t len, bool copy = false, uint64_t auxkey = 0) override;
+  int     fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey) override;
+  int64_t size() const override;
+  bool    would_evict(const CryptoHash *key, uint32_t len, CryptoHash *victim) const override;
+  void    set_compression(const CryptoHash *key, uint64_t auxkey, int ctype) override;
+
+  void init(int64_t max_bytes, StripeSM *stripe) override;
+
+private:
+  RamCache       *_cache  = nullptr;
+  StripeSM       *_stripe = nullptr; // for stats
+  FrequencySketch _sketch;
+};
+
+void
+RamCacheTinyLFU::init(int64_t abytes, StripeSM *astripe)
+{
+  this->_stripe = astripe;
+  this->_cache->init(abytes, astripe);
+  if (abytes) {
+    this->_sketch.init(abytes / SKETCH_AVERAGE_ENTRY_SIZE);
+    DDbg(dbg_ctl_ram_cache, "initializing admission sketch %" PRIu64 " bytes", this->_sketch.size_in_bytes());
+  }
+}
+
+int
+RamCacheTinyLFU::get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey)
+{
+  // Every lookup counts towards the key's popularity, hit or miss.
+  this->_sketch.increment(*key);
+  return this->_cache->get(key, ret_data, auxkey);
+}
+
+int
+RamCacheTinyLFU::put(CryptoHash *key, IOBufferData *data, uint32_t len, bool copy, uint64_t auxkey)
+{
+  CryptoHash victim;
+  uint32_t   size = copy ? len : data->block_size();
+
+  if (this->_cache->would_evict(key, size, &victim)) {
+    int candidate_freq = this->_sketch.frequency(*key);
+    int victim_freq    = this->_sketch.frequency(victim);
+    if (candidate_freq <= victim_freq) {
+      DDbg(dbg_ctl_ram_cache, "put %X %" PRIu64 " freq %d victim freq %d REJECTED", key->slice32(3), auxkey, candidate_freq,
+           victim_freq);
+      ts::Metrics::Counter::increment(cache_rsb.ram_cache_rejected);
+      ts::Metrics::Counter::increment(this->_stripe->cache_vol->vol_rsb.ram_cache_rejected);
+      return 0;
+    }
+  }
+  ts::Metrics::Counter::increment(cache_rsb.ram_cache_admitted);
+  ts::Metrics::Counter::increment(this->_stripe->cache_vol->vol_rsb.ram_cache_admitted);
+  return this->_cache->put(key, data, len, copy, auxkey);
+}
+
+int
+RamCacheTinyLFU::fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey)
+{
+  return this->_cache->fixup(key, old_auxkey, new_auxkey);
+}
+
+int64_t
+RamCacheTinyLFU::size() const
+{
+  return this->_cache->size() + this->_sketch.size_in_bytes();
+}
+
+bool
+RamCacheTinyLFU::would_evict(const CryptoHash *key, uint32_t len, CryptoHash *victim) const
+{
+  return this->_cache->would_evict(key, len, victim);
+}
+
+void
+RamCacheTinyLFU::set_compression(const CryptoHash *key, uint64_t auxkey, int ctype)
+{
+  this->_cache->set_compression(key, auxkey, ctype);
+}
+
+RamCache *
+new_RamCacheTinyLFU(RamCache *cache)
+{
+  return new RamCacheTinyLFU(cache);
+}
@@ -91,7 +91,7 @@ Stripe::Stripe(CacheDisk *disk, off_t blocks, off_t dir_skip, int avg_obj_size,
     start{skip},
     len{blocks * STORE_BLOCK_SIZE}
 {
-  ink_assert(this->len < MAX_STRIPE_SIZE);
+  ink_assert(this->len <= MAX_STRIPE_SIZE);
 
   this->_init_hash_text(disk, blocks, dir_skip);
   this->_init_data(STORE_BLOCK_SIZE, avg_obj_size);
@@ -151,8 +151,8 @@ Stripe::_init_directory(std::size_t directory_size, int header_size, int footer_
   // footer.
   ink_release_assert(directory_size >= sizeof(Dir) + header_size + footer_size);
 
-  Dbg(dbg_ctl_cache_init, "Stripe %s: allocating %zu directory bytes for a %lld byte volume (%lf%%)", hash_text.get(),
-      directory_size, (long long)this->len, percent(directory_size, this->len));
+  Dbg(dbg_ctl_cache_init, "Stripe %s: allocating %zu directory bytes (%d byte entries) for a %lld byte volume (%lf%%)",
+      hash_text.get(), directory_size, SIZEOF_DIR, (long long)this->len, percent(directory_size, this->len));
   if (ats_hugepage_enabled()) {
     this->directory.raw_dir = static_cast<char *>(ats_alloc_hugepage(directory_size));
     if (this->directory.raw_dir != nullptr) {
@@ -168,6 +168,11 @@ Stripe::_init_directory(std::size_t directory_size, int header_size, int footer_
   this->directory.header       = reinterpret_cast<StripeHeaderFooter *>(this->directory.raw_dir);
   std::size_t const footer_offset{directory_size - static_cast<std::size_t>(footer_size)};
   this->directory.footer = reinterpret_cast<StripeHeaderFooter *>(this->directory.raw_dir + footer_offset);
+
+  this->directory.segment_serial.assign(this->directory.segments, 0);
+  for (auto &hashes : this->directory.synced_hash) {
+    hashes.assign(directory_size / STORE_BLOCK_SIZE, 0);
+  }
 }
 
 // coverity[exn_spec_violation] - ink_assert aborts (doesn't throw), Dbg is exception-safe
@@ -362,6 +367,7 @@ Stripe::_clear_init(std::uint32_t hw_sector_size)
   this->directory.header->magic          = STRIPE_MAGIC;
   this->directory.header->version._major = CACHE_DB_MAJOR_VERSION;
   this->directory.header->version._minor = CACHE_DB_MINOR_VERSION;
+  this->directory.header->dir_entry_size = SIZEOF_DIR;
   this->scan_pos = this->directory.header->agg_pos = this->directory.header->write_pos = this->start;
   this->directory.header->last_write_pos                                               = this->directory.header->write_pos;
   this->directory.header->phase                                                        = 0;
@@ -45,11 +45,17 @@
 
 #define STRIPE_BLOCK_SIZE (1024 * 1024 * 128) // 128MB
 #define MIN_STRIPE_SIZE   STRIPE_BLOCK_SIZE
-#define MAX_STRIPE_SIZE   ((off_t)512 * 1024 * 1024 * 1024 * 1024) // 512TB
+#if TS_USE_COMPACT_CACHE_DIR
+#define MAX_STRIPE_SIZE ((off_t)8 * 1024 * 1024 * 1024) // 8GB, (1 << DIR_OFFSET_BITS) * CACHE_BLOCK_SIZE
+#else
+#define MAX_STRIPE_SIZE ((off_t)512 * 1024 * 1024 * 1024 * 1024) // 512TB
+#endif
 
 // This is defined here so CacheVC can avoid including StripeSM.h.
 #define RECOVERY_SIZE EVACUATION_SIZE // 8MB
 
+struct CacheHostRecord;
+
 struct CacheVol {
   int          vol_number       = -1;
   CacheType    scheme           = CacheType::NONE;
@@ -62,6 +68,8 @@ struct CacheVol {
   int64_t      ram_cache_cutoff = -1; // Per-volume RAM cache cutoff (-1 = use global cutoff)
   StripeSM   **stripes          = nullptr;
   DiskStripe **disk_stripes     = nullptr;
+  // Stripes of the volume objects are demoted to, see Cache::tier_stripe
+  CacheHostRecord *lower_tier = nullptr;
   LINK(CacheVol, link);
   // per volume stats
   CacheStatsBlock vol_rsb;
@@ -72,6 +72,18 @@ DbgCtl dbg_ctl_cache_dir_sync{"dir_sync"};
 DbgCtl dbg_ctl_cache_disk_error{"cache_disk_error"};
 DbgCtl dbg_ctl_cache_evac{"cache_evac"};
 DbgCtl dbg_ctl_cache_init{"cache_init"};
+DbgCtl dbg_ctl_cache_agg_flush{"cache_agg_flush"};
+
+// Index of the aggregation histogram bucket for @a t.
+int
+agg_histogram_bucket(ink_hrtime t)
+{
+  int i = 0;
+  while (i < CACHE_AGG_HISTOGRAM_BUCKETS - 1 && t > HRTIME_MSECONDS(CACHE_AGG_HISTOGRAM_MS[i])) {
+    ++i;
+  }
+  return i;
+}
 
 #ifdef DEBUG
 
@@ -120,6 +132,8 @@ StripeSM::StripeSM(CacheDisk *disk, off_t blocks, off_t dir_skip, int avg_obj_si
     _preserved_dirs{len}
 {
   open_dir.mutex = this->mutex;
+  _flush_policy.configure(HRTIME_MSECONDS(cache_config_agg_write_target_latency),
+                          HRTIME_MSECONDS(cache_config_agg_write_max_delay));
   SET_HANDLER(&StripeSM::aggWrite);
 }
 
@@ -260,6 +274,14 @@ StripeSM::handle_dir_read(int event, void *data)
     clear_dir_aio();
     return EVENT_DONE;
   }
+  // Directories written before the entry size was recorded have 10 byte entries.
+  uint32_t dir_entry_size = directory.header->dir_entry_size ? directory.header->dir_entry_size : 10;
+  if (dir_entry_size != SIZEOF_DIR) {
+    Warning("cache directory for '%s' has %u byte entries, this build uses %d byte entries, clearing", hash_text.get(),
+            dir_entry_size, SIZEOF_DIR);
+    clear_dir_aio();
+    return EVENT_DONE;
+  }
   CHECK_DIR(this);
 
   sector_size = directory.header->sector_size;
@@ -580,6 +602,8 @@ Ldone: {
   init_info->vol_aio[2].aiocb.aio_buf    = directory.raw_dir + dirlen - footerlen;
   init_info->vol_aio[2].aiocb.aio_nbytes = footerlen;
   init_info->vol_aio[2].aiocb.aio_offset = ss + dirlen - footerlen;
+  // the whole directory goes to this copy, later syncs to it can be incremental
+  directory.synced_serial[B] = directory.header->sync_serial;
 
   SET_HANDLER(&StripeSM::handle_recover_write_dir);
   ink_assert(ink_aio_write(init_info->vol_aio));
@@ -717,6 +741,13 @@ StripeSM::aggWriteDone(int event, Event *e)
     return EVENT_CONT;
   }
   if (io.ok()) {
+    ink_hrtime latency = ink_get_hrtime() - _agg_write_start;
+    int        bucket  = agg_histogram_bucket(latency);
+    ts::Metrics::Counter::increment(cache_rsb.agg_write_latency[bucket]);
+    ts::Metrics::Counter::increment(cache_vol->vol_rsb.agg_write_latency[bucket]);
+    _flush_policy.write_done(latency, this->_write_buffer.get_bytes_pending_aggregation());
+    DDbg(dbg_ctl_cache_agg_flush, "Dir %s, write of %zu bytes took %" PRId64 "us, flush size %d", hash_text.get(),
+         io.aiocb.aio_nbytes, ink_hrtime_to_usec(latency), _flush_policy.flush_size());
     directory.header->last_write_pos  = directory.header->write_pos;
     directory.header->write_pos      += io.aiocb.aio_nbytes;
     ink_assert(directory.header->write_pos >= start);
@@ -725,6 +756,7 @@ StripeSM::aggWriteDone(int event, Event *e)
     ink_assert(directory.header->write_pos == directory.header->agg_pos);
     if (directory.header->write_pos + EVACUATION_SIZE > scan_pos) {
       ink_assert(this->mutex->thread_holding == this_ethread());
+      this->scan_for_demotion();
       this->_preserved_dirs.periodic_scan(this);
     }
     this->_write_buffer.reset_buffer_pos();
@@ -824,8 +856,8 @@ Lagain:
 
   // if write_buffer.get_pending_writers.head, then we are near the end of the disk, so
   // write down the aggregation in whatever size it is.
-  if (this->_write_buffer.get_buffer_pos() < AGG_HIGH_WATER && !this->_write_buffer.get_pending_writers().head && !sync.head &&
-      !dir_sync_waiting) {
+  if (!this->_flush_due() && !this->_write_buffer.get_pending_writers().head && !sync.head && !dir_sync_waiting) {
+    this->_schedule_flush();
     goto Lwait;
   }
 
@@ -857,6 +889,7 @@ Lagain:
    */
   io.thread = AIO_CALLBACK_THREAD_AIO;
   SET_HANDLER(&StripeSM::aggWriteDone);
+  _agg_write_start = ink_get_hrtime();
   ink_aio_write(&io);
 
 Lwait:
@@ -871,17 +904,46 @@ Lwait:
   return ret;
 }
 
+bool
+StripeSM::_flush_due() const
+{
+  return this->_flush_policy.should_flush(this->_write_buffer.get_buffer_pos(), this->_agg_filled_at, ink_get_hrtime());
+}
+
+// Write a buffer that is filling slowly once its oldest data has waited long enough.
+void
+StripeSM::_schedule_flush()
+{
+  if (!this->_flush_policy.is_adaptive() || this->_write_buffer.is_empty() || this->trigger) {
+    return;
+  }
+  ink_hrtime wait = this->_agg_filled_at + this->_flush_policy.flush_delay() - ink_get_hrtime();
+  // No write is in progress, so nothing else is waiting on aggWriteDone.
+  SET_HANDLER(&StripeSM::aggWrite);
+  this->trigger = eventProcessor.schedule_in(this, std::max(wait, AggregateFlushPolicy::MIN_DELAY));
+}
+
 void
 StripeSM::aggregate_pending_writes(Queue<CacheVC, Continuation::Link_link> &tocall)
 {
+  ink_hrtime now   = ink_get_hrtime();
+  int        limit = this->_flush_policy.write_limit();
   for (auto *c = static_cast<CacheVC *>(this->_write_buffer.get_pending_writers().head); c;) {
     int writelen = c->agg_len;
     // [amc] this is checked multiple places, on here was it strictly less.
     ink_assert(writelen <= AGG_SIZE);
+    // a document larger than the limit still goes into an empty buffer
     if (this->_write_buffer.get_buffer_pos() + writelen > AGG_SIZE ||
+        (!this->_write_buffer.is_empty() && this->_write_buffer.get_buffer_pos() + writelen > limit) ||
         this->directory.header->write_pos + this->_write_buffer.get_buffer_pos() + writelen > (this->skip + this->len)) {
       break;
     }
+    if (this->_write_buffer.is_empty()) {
+      this->_agg_filled_at = now;
+    }
+    int bucket = agg_histogram_bucket(now - c->agg_queue_time);
+    ts::Metrics::Counter::increment(cache_rsb.agg_write_wait[bucket]);
+    ts::Metrics::Counter::increment(this->cache_vol->vol_rsb.agg_write_wait[bucket]);
     DDbg(dbg_ctl_agg_read, "copying: %d, %" PRIu64 ", key: %d", this->_write_buffer.get_buffer_pos(),
          this->directory.header->write_pos + this->_write_buffer.get_buffer_pos(), c->first_key.slice32(0));
     [[maybe_unused]] int wrotelen = this->_agg_copy(c);
@@ -1048,14 +1110,15 @@ update_header_info(CacheVC *vc, Doc *doc)
 {
   if (vc->frag_type == CACHE_FRAG_TYPE_HTTP) {
     ink_assert(vc->write_vector->count() > 0);
-    if (!vc->f.update && !vc->f.evac_vector) {
+    // the size of a sparse object is set when it is created, not by what a fill wrote
+    if (!vc->f.update && !vc->f.evac_vector && !vc->f.sparse) {
       ink_assert(!(vc->first_key.is_zero()));
       CacheHTTPInfo *http_info = vc->write_vector->get(vc->alternate_index);
       http_info->object_size_set(vc->total_len);
     }
     // update + data_written =>  Update case (b)
     // need to change the old alternate's object length
-    if (vc->f.update && vc->total_len) {
+    if (vc->f.update && vc->total_len && !vc->f.sparse) {
       CacheHTTPInfo *http_info = vc->write_vector->get(vc->alternate_index);
       http_info->object_size_set(vc->total_len);
     }
@@ -1083,6 +1146,7 @@ StripeSM::agg_wrap()
     Note("Cache volume %d on disk '%s' wraps around", stripe->cache_vol->vol_number, stripe->hash_text.get());
   }
   ink_assert(this->mutex->thread_holding == this_ethread());
+  this->scan_for_demotion();
   this->_preserved_dirs.periodic_scan(this);
 }
 
@@ -1170,6 +1234,17 @@ StripeSM::evacuateDocReadDone(int event, Event *e)
   if ((b->f.pinned && !b->readers) && doc->pinned < static_cast<uint32_t>(ink_get_hrtime() / HRTIME_SECOND)) {
     goto Ldone;
   }
+  // a head being read right now is hot, keep it in this tier
+  if (b->f.demote && !b->readers) {
+    StripeSM *lower = Cache::tier_stripe(&doc->first_key, this);
+    if (lower && dir_compare_tag(&b->dir, &doc->first_key)) {
+      doc_evacuator->first_key = doc->first_key;
+      doc_evacuator->tier_move(lower);
+      doc_evacuator = nullptr;
+      return aggWrite(event, e);
+    }
+    goto Ldone;
+  }
 
   if (dir_head(&b->dir) && b->f.evacuate_head) {
     ink_assert(!b->evac_frags.key.fold());
@@ -1269,16 +1344,117 @@ StripeSM::evacuateWrite(CacheEvacuateDocVC *evacuator, int event, Event *e)
   // push to front of aggregation write list, so it is written first
 
   evacuator->agg_len = round_to_approx_size((reinterpret_cast<Doc *>(evacuator->buf->data()))->len);
+  ink_assert(evacuator->agg_len <= AGG_SIZE);
+  this->_queue_evacuator(evacuator);
+  return aggWrite(event, e);
+}
+
+void
+StripeSM::_queue_evacuator(CacheEvacuateDocVC *evacuator)
+{
   this->_write_buffer.add_bytes_pending_aggregation(evacuator->agg_len);
+  evacuator->agg_queue_time = ink_get_hrtime();
   /* insert the evacuator after all the other evacuators */
   CacheVC *cur   = static_cast<CacheVC *>(this->_write_buffer.get_pending_writers().head);
   CacheVC *after = nullptr;
   for (; cur && cur->f.evacuator; cur = static_cast<CacheVC *>(cur->link.next)) {
     after = cur;
   }
-  ink_assert(evacuator->agg_len <= AGG_SIZE);
   this->_write_buffer.get_pending_writers().insert(evacuator, after);
-  return aggWrite(event, e);
+}
+
+bool
+StripeSM::tier_write(CacheEvacuateDocVC *vc)
+{
+  ink_assert(this->mutex->thread_holding == this_ethread());
+  vc->agg_len = round_to_approx_size((reinterpret_cast<Doc *>(vc->buf->data()))->len);
+  // unlike evacuation, copies between tiers are optional and must not crowd out regular writes
+  if (vc->agg_len > AGG_SIZE || this->_write_buffer.get_bytes_pending_aggregation() > cache_config_agg_write_backlog) {
+    return false;
+  }
+  this->_queue_evacuator(vc);
+  if (!this->is_io_in_progress()) {
+    this->aggWrite(EVENT_IMMEDIATE, nullptr);
+  }
+  return true;
+}
+
+CryptoHash
+StripeSM::_access_key(int s, int64_t b, uint32_t tag) const
+{
+  // Spread the directory position of the key, which is all that is known
+  // when scanning the directory, over the sketch.
+  uint64_t   v = (static_cast<uint64_t>(s) << 40) ^ (static_cast<uint64_t>(b) << DIR_TAG_WIDTH) ^ tag;
+  CryptoHash key;
+  ink_zero(key);
+  for (auto &word : key.u64) {
+    v    += 0x9e3779b97f4a7c15ULL;
+    word  = v;
+    word  = (word ^ (word >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    word  = (word ^ (word >> 27)) * 0x94d049bb133111ebULL;
+    word ^= word >> 31;
+  }
+  return key;
+}
+
+void
+StripeSM::record_access(const CacheKey *key)
+{
+  ink_assert(this->mutex->thread_holding == this_ethread());
+  if (this->tier_frequency.size_in_bytes()) {
+    this->tier_frequency.increment(this->_access_key(key->slice32(0) % this->directory.segments,
+                                                     key->slice32(1) % this->directory.buckets, DIR_MASK_TAG(key->slice32(2))));
+  }
+}
+
+int
+StripeSM::access_frequency(const CacheKey *key) const
+{
+  return this->tier_frequency.frequency(this->_access_key(key->slice32(0) % this->directory.segments,
+                                                          key->slice32(1) % this->directory.buckets, DIR_MASK_TAG(key->slice32(2))));
+}
+
+void
+StripeSM::scan_for_demotion()
+{
+  if (!this->cache_vol->lower_tier || cache_config_tier_demote_hits <= 0 || !this->tier_frequency.size_in_bytes()) {
+    return;
+  }
+  // The same region scan_for_pinned_documents looks at, just past the next
+  // aggregation write. evac_range reads the heads found here before they are
+  // overwritten and evacuateDocReadDone hands them to the lower tier.
+  off_t ps                = this->offset_to_vol_offset(this->directory.header->write_pos + AGG_SIZE);
+  off_t pe =
+    this->offset_to_vol_offset(this->directory.header->write_pos + 2 * EVACUATION_SIZE + (this->len / PIN_SCAN_EVERY));
+  off_t vol_end_offset    = this->offset_to_vol_offset(this->len + this->skip);
+  bool  before_end_of_vol = pe < vol_end_offset;
+
+  // Walk the chains rather than the entries, the frequency is keyed by bucket.
+  for (int s = 0; s < this->directory.segments; s++) {
+    Dir *seg = this->directory.get_segment(s);
+    for (int64_t b = 0; b < this->directory.buckets; b++) {
+      Dir *e = dir_bucket(b, seg);
+      if (!dir_offset(e)) {
+        continue;
+      }
+      do {
+        if (!dir_head(e) || dir_pinned(e)) {
+          continue;
+        }
+        off_t o = dir_offset(e);
+        if (dir_phase(e) == this->directory.header->phase) {
+          if (before_end_of_vol || o >= (pe - vol_end_offset)) {
+            continue;
+          }
+        } else if (o < ps || o >= pe) {
+          continue;
+        }
+        if (this->tier_frequency.frequency(this->_access_key(s, b, dir_tag(e))) >= cache_config_tier_demote_hits) {
+          this->_preserved_dirs.force_demote_head(e);
+        }
+      } while ((e = next_dir(e, seg)));
+    }
+  }
 }
 
 bool
@@ -1307,6 +1483,7 @@ StripeSM::add_writer(CacheVC *vc)
     this->_write_buffer.add_bytes_pending_aggregation(-vc->agg_len);
   } else {
     ink_assert(vc->agg_len <= AGG_SIZE);
+    vc->agg_queue_time = ink_get_hrtime();
     if (vc->f.evac_vector) {
       this->get_pending_writers().push(vc);
     } else {
@@ -26,7 +26,9 @@
 #include "P_CacheDir.h"
 #include "P_CacheDisk.h"
 #include "P_RamCache.h"
+#include "AggregateFlushPolicy.h"
 #include "AggregateWriteBuffer.h"
+#include "FrequencySketch.h"
 #include "PreservationTable.h"
 #include "Stripe.h"
 
@@ -148,6 +150,10 @@ public:
   int64_t           first_fragment_offset = 0;
   Ptr<IOBufferData> first_fragment_data;
 
+  // Recent reads of the objects in this stripe, for moving them between cache
+  // tiers. Only sized for the stripes of tiered volumes.
+  FrequencySketch tier_frequency;
+
   void cancel_trigger();
 
   int recover_data();
@@ -205,6 +211,31 @@ public:
   int evacuateWrite(CacheEvacuateDocVC *evacuator, int event, Event *e);
   int evacuateDocReadDone(int event, Event *e);
 
+  /**
+   * Record a read of the object with @a key, for moving objects between tiers.
+   */
+  void record_access(const CacheKey *key);
+
+  /**
+   * @return The estimated number of recent reads of the object with @a key.
+   */
+  int access_frequency(const CacheKey *key) const;
+
+  /**
+   * Queue the heads that are about to be overwritten and were read at least
+   * proxy.config.cache.tier.demote_hits times for demotion to the lower tier.
+   */
+  void scan_for_demotion();
+
+  /**
+   * Queue a document copied from another stripe to be written to this one.
+   *
+   * @a vc is called back once the document is in the aggregation buffer.
+   *
+   * @return false if the write backlog is full, and @a vc was not queued.
+   */
+  bool tier_write(CacheEvacuateDocVC *vc);
+
   int evac_range(off_t start, off_t end, int evac_phase);
 
   /**
@@ -291,6 +322,16 @@ public:
 private:
   mutable PreservationTable _preserved_dirs;
 
+  AggregateFlushPolicy _flush_policy;
+  ink_hrtime           _agg_filled_at   = 0; // when the first document was copied into the aggregation buffer
+  ink_hrtime           _agg_write_start = 0; // when the aggregation write in progress was issued
+
+  bool _flush_due() const;
+  void _schedule_flush();
+
+  void       _queue_evacuator(CacheEvacuateDocVC *evacuator);
+  CryptoHash _access_key(int s, int64_t b, uint32_t tag) const;
+
   int _agg_copy(CacheVC *vc);
   int _copy_writer_to_aggregation(CacheVC *vc);
   int _copy_evacuator_to_aggregation(CacheVC *vc);
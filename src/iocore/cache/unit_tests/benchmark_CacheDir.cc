@@ -0,0 +1,278 @@
+/** @file
+
+  Microbenchmark for cache directory bucket probing
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+/*
+  Compares walking a bucket chain entry by entry, as Directory::probe does,
+  with first comparing all the rows of the bucket at once with SIMD
+  instructions and walking the chain only when that cannot settle a miss.
+  The directory is filled the way Directory::insert fills it: the bucket head
+  first, then free rows of the same bucket, then rows taken from elsewhere in
+  the segment. CACHE_DIR_FILL sets the fraction of entries in use (default
+  0.75).
+
+  With the current layout the rows of a bucket are 40 bytes of interleaved
+  offset, tag and link words, so gathering the tags costs more than the
+  short chain walk it saves, and a bucket often straddles two cache lines
+  where the walk would have touched one. Keep this around to measure any
+  other directory layout against.
+
+  This is not run by ctest, run benchmark_CacheDir directly.
+*/
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "P_CacheDir.h"
+
+#include "tscore/CryptoHash.h"
+
+#include <cstdlib>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+
+constexpr int     SEGMENTS = 16;
+constexpr int64_t BUCKETS  = MAX_BUCKETS_PER_SEGMENT;
+
+/* Returns true if a key with @a tag cannot be in the chain of bucket @a b,
+   the @a bi th bucket of its segment. That is the case when no occupied row
+   of the bucket carries the tag and each occupied row links only to rows of
+   the same bucket, so the chain from the head never leaves the bucket. The
+   rows of a bucket are adjacent, so their tags and links are compared in one
+   vector operation where available. A false return means the chain has to
+   be walked.
+ */
+bool
+bucket_miss(const Dir *b, int64_t bi, uint32_t tag)
+{
+#if DIR_DEPTH == 4
+  uint16_t first = static_cast<uint16_t>(bi * DIR_DEPTH);
+  uint16_t used[DIR_DEPTH], tags[DIR_DEPTH], next[DIR_DEPTH];
+  for (int r = 0; r < DIR_DEPTH; r++) {
+    used[r] = dir_offset(&b[r]) != 0;
+    tags[r] = b[r].w[2] & ((1 << DIR_TAG_WIDTH) - 1);
+    next[r] = b[r].w[3];
+  }
+#if defined(__SSE2__)
+  // SSE2 has no unsigned compare, so next - first is biased into signed range
+  __m128i zero    = _mm_setzero_si128();
+  __m128i empty   = _mm_cmpeq_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(used)), zero);
+  __m128i vnext   = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(next));
+  __m128i match   = _mm_cmpeq_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(tags)), _mm_set1_epi16(tag));
+  __m128i rel     = _mm_xor_si128(_mm_sub_epi16(vnext, _mm_set1_epi16(first)), _mm_set1_epi16(INT16_MIN));
+  __m128i outside = _mm_cmpgt_epi16(rel, _mm_set1_epi16(INT16_MIN + DIR_DEPTH - 1));
+  __m128i leaves  = _mm_andnot_si128(_mm_cmpeq_epi16(vnext, zero), outside);
+  return (_mm_movemask_epi8(_mm_andnot_si128(empty, _mm_or_si128(match, leaves))) & 0xFF) == 0;
+#elif defined(__ARM_NEON)
+  uint16x4_t zero   = vdup_n_u16(0);
+  uint16x4_t vnext  = vld1_u16(next);
+  uint16x4_t vused  = vmvn_u16(vceq_u16(vld1_u16(used), zero));
+  uint16x4_t match  = vceq_u16(vld1_u16(tags), vdup_n_u16(tag));
+  uint16x4_t leaves = vbic_u16(vcge_u16(vsub_u16(vnext, vdup_n_u16(first)), vdup_n_u16(DIR_DEPTH)), vceq_u16(vnext, zero));
+  return vget_lane_u64(vreinterpret_u64_u16(vand_u16(vused, vorr_u16(match, leaves))), 0) == 0;
+#else
+  for (int r = 0; r < DIR_DEPTH; r++) {
+    if (used[r] && (tags[r] == tag || (next[r] && static_cast<uint16_t>(next[r] - first) >= DIR_DEPTH))) {
+      return false;
+    }
+  }
+  return true;
+#endif
+#else
+  return false;
+#endif
+}
+
+struct Lookup {
+  int      s;
+  int64_t  b;
+  uint32_t tag;
+};
+
+class SyntheticDir
+{
+public:
+  explicit SyntheticDir(double fill) : _dir(SEGMENTS * BUCKETS * DIR_DEPTH), _spare(SEGMENTS, 0)
+  {
+    int64_t n = static_cast<int64_t>(SEGMENTS * BUCKETS * DIR_DEPTH * fill);
+    for (int64_t i = 0; i < n; ++i) {
+      Lookup l = lookup(i);
+      if (insert(l, i + 1)) {
+        hits.push_back(l);
+      }
+      misses.push_back(lookup(n + i));
+    }
+  }
+
+  Dir *
+  segment(int s)
+  {
+    return &_dir[s * BUCKETS * DIR_DEPTH];
+  }
+
+  // The chain walk Directory::probe does.
+  Dir *
+  walk(const Lookup &l)
+  {
+    Dir *seg = segment(l.s);
+    Dir *e   = dir_bucket(l.b, seg);
+    if (!dir_offset(e)) {
+      return nullptr;
+    }
+    do {
+      if (dir_tag(e) == l.tag) {
+        return e;
+      }
+      e = next_dir(e, seg);
+    } while (e);
+    return nullptr;
+  }
+
+  // The same, settling what it can from the bucket rows first.
+  Dir *
+  scan(const Lookup &l)
+  {
+    Dir *e = dir_bucket(l.b, segment(l.s));
+    if (!dir_offset(e) || bucket_miss(e, l.b, l.tag)) {
+      return nullptr;
+    }
+    return walk(l);
+  }
+
+  std::vector<Lookup> hits;
+  std::vector<Lookup> misses;
+
+private:
+  static Lookup
+  lookup(int64_t i)
+  {
+    CryptoHash key;
+    CryptoContext().hash_immediate(key, &i, sizeof(i));
+    return {static_cast<int>(key.slice32(0) % SEGMENTS), key.slice32(1) % BUCKETS, DIR_MASK_TAG(key.slice32(2))};
+  }
+
+  bool
+  insert(const Lookup &l, int64_t offset)
+  {
+    Dir *seg = segment(l.s);
+    Dir *b   = dir_bucket(l.b, seg);
+    Dir *e   = nullptr;
+
+    if (!dir_offset(b)) {
+      e = b;
+    } else {
+      for (int r = 1; r < DIR_DEPTH && !e; ++r) {
+        if (!dir_offset(dir_bucket_row(b, r))) {
+          e = dir_bucket_row(b, r);
+        }
+      }
+      // otherwise take the next free non-head row of the segment, like the freelist does
+      for (int64_t &i = _spare[l.s]; !e && i < BUCKETS * DIR_DEPTH; ++i) {
+        if (i % DIR_DEPTH && !dir_offset(dir_in_seg(seg, i))) {
+          e = dir_in_seg(seg, i);
+        }
+      }
+      if (!e) {
+        return false;
+      }
+      Dir *last = b;
+      while (dir_next(last)) {
+        last = next_dir(last, seg);
+      }
+      dir_set_next(last, dir_to_offset(e, seg));
+    }
+    dir_set_offset(e, offset);
+    dir_set_tag(e, l.tag);
+    return true;
+  }
+
+  std::vector<Dir>     _dir;
+  std::vector<int64_t> _spare;
+};
+
+SyntheticDir &
+fixture()
+{
+  const char         *fill = getenv("CACHE_DIR_FILL");
+  static SyntheticDir dir(fill ? atof(fill) : 0.75);
+  return dir;
+}
+
+} // end anonymous namespace
+
+TEST_CASE("bucket_miss agrees with the chain walk", "[cache][dir]")
+{
+  SyntheticDir &dir = fixture();
+  for (auto const &l : dir.hits) {
+    REQUIRE(dir.scan(l) == dir.walk(l));
+  }
+  for (auto const &l : dir.misses) {
+    REQUIRE(dir.scan(l) == dir.walk(l));
+  }
+}
+
+TEST_CASE("CacheDirProbe", "[bench][cache][dir]")
+{
+  SyntheticDir &dir = fixture();
+
+  BENCHMARK("walk hits")
+  {
+    uint64_t found = 0;
+    for (auto const &l : dir.hits) {
+      found += dir.walk(l) != nullptr;
+    }
+    return found;
+  };
+  BENCHMARK("scan hits")
+  {
+    uint64_t found = 0;
+    for (auto const &l : dir.hits) {
+      found += dir.scan(l) != nullptr;
+    }
+    return found;
+  };
+  BENCHMARK("walk misses")
+  {
+    uint64_t found = 0;
+    for (auto const &l : dir.misses) {
+      found += dir.walk(l) != nullptr;
+    }
+    return found;
+  };
+  BENCHMARK("scan misses")
+  {
+    uint64_t found = 0;
+    for (auto const &l : dir.misses) {
+      found += dir.scan(l) != nullptr;
+    }
+    return found;
+  };
+}
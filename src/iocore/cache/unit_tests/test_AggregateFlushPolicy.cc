@@ -0,0 +1,103 @@
+/** @file
+
+  Unit tests for AggregateFlushPolicy
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "AggregateFlushPolicy.h"
+
+TEST_CASE("AggregateFlushPolicy without a target flushes at the high water mark", "[cache][agg]")
+{
+  AggregateFlushPolicy policy;
+  policy.configure(0, HRTIME_MSECONDS(100));
+
+  CHECK_FALSE(policy.is_adaptive());
+  CHECK(policy.flush_size() == AGG_HIGH_WATER);
+  CHECK(policy.write_limit() == AGG_SIZE);
+
+  CHECK_FALSE(policy.should_flush(AGG_HIGH_WATER - 1, 0, HRTIME_SECONDS(10)));
+  CHECK(policy.should_flush(AGG_HIGH_WATER, 0, 0));
+
+  // slow writes change nothing
+  for (int i = 0; i < 10; ++i) {
+    policy.write_done(HRTIME_SECONDS(1), AGG_SIZE);
+  }
+  CHECK(policy.flush_size() == AGG_HIGH_WATER);
+  CHECK(policy.write_latency() > 0);
+}
+
+TEST_CASE("AggregateFlushPolicy follows the write latency", "[cache][agg]")
+{
+  AggregateFlushPolicy policy;
+  policy.configure(HRTIME_MSECONDS(10), HRTIME_MSECONDS(100));
+  REQUIRE(policy.is_adaptive());
+
+  SECTION("slow writes shrink the flush size down to the minimum")
+  {
+    policy.write_done(HRTIME_MSECONDS(40), 0);
+    CHECK(policy.flush_size() == AGG_HIGH_WATER / 2);
+    CHECK(policy.write_limit() == AGG_HIGH_WATER);
+    for (int i = 0; i < 20; ++i) {
+      policy.write_done(HRTIME_MSECONDS(40), 0);
+    }
+    CHECK(policy.flush_size() == AggregateFlushPolicy::MIN_FLUSH_SIZE);
+  }
+
+  SECTION("fast writes grow it back only with a backlog")
+  {
+    for (int i = 0; i < 20; ++i) {
+      policy.write_done(HRTIME_MSECONDS(40), 0);
+    }
+    int shrunk = policy.flush_size();
+    for (int i = 0; i < 100; ++i) {
+      policy.write_done(HRTIME_MSECONDS(1), 0);
+    }
+    CHECK(policy.flush_size() == shrunk);
+    for (int i = 0; i < 100; ++i) {
+      policy.write_done(HRTIME_MSECONDS(1), AGG_SIZE);
+    }
+    CHECK(policy.flush_size() == AGG_HIGH_WATER);
+  }
+}
+
+TEST_CASE("AggregateFlushPolicy flushes a slowly filling buffer", "[cache][agg]")
+{
+  AggregateFlushPolicy policy;
+  policy.configure(HRTIME_MSECONDS(10), HRTIME_MSECONDS(100));
+
+  // no write seen yet, wait the maximum delay
+  CHECK(policy.flush_delay() == HRTIME_MSECONDS(100));
+  CHECK_FALSE(policy.should_flush(4096, 0, HRTIME_MSECONDS(99)));
+  CHECK(policy.should_flush(4096, 0, HRTIME_MSECONDS(100)));
+  CHECK_FALSE(policy.should_flush(0, 0, HRTIME_SECONDS(10)));
+
+  // then a couple of write times
+  policy.write_done(HRTIME_MSECONDS(5), 0);
+  CHECK(policy.flush_delay() == HRTIME_MSECONDS(10));
+  CHECK(policy.should_flush(4096, HRTIME_MSECONDS(50), HRTIME_MSECONDS(60)));
+
+  // but never longer than the maximum
+  for (int i = 0; i < 50; ++i) {
+    policy.write_done(HRTIME_SECONDS(1), 0);
+  }
+  CHECK(policy.flush_delay() == HRTIME_MSECONDS(100));
+}
@@ -29,6 +29,8 @@
 
 #include "tscore/Random.h"
 
+#include <algorithm>
+
 // Required by main.h
 int  cache_vols           = 1;
 bool reuse_existing_cache = false;
@@ -236,6 +238,45 @@ public:
       CHECK(!stripe->directory.check());
 #endif
     }
+
+    // test the ranges written by an incremental directory sync
+    {
+      Directory                           &directory = stripe->directory;
+      std::vector<std::pair<off_t, off_t>> ranges;
+      off_t                                dir_start = reinterpret_cast<char *>(directory.dir) - directory.raw_dir;
+
+      directory.header->sync_serial = 10;
+      std::fill(directory.segment_serial.begin(), directory.segment_serial.end(), 0);
+      directory.synced_serial[0] = directory.synced_serial[1] = 0;
+      CHECK(!directory.dirty_ranges(12, ranges));
+
+      // nothing changed since copy A was written with serial 10
+      directory.synced_serial[0] = 10;
+      REQUIRE(directory.dirty_ranges(12, ranges));
+      for (auto const &[start, end] : ranges) {
+        CHECK(end <= dir_start);
+      }
+
+      rand_CacheKey(&key);
+      s = key.slice32(0) % directory.segments;
+      directory.insert(&key, stripe, &dir);
+      off_t seg_start = reinterpret_cast<char *>(directory.get_segment(s)) - directory.raw_dir;
+      off_t seg_end   = seg_start + directory.buckets * DIR_DEPTH * SIZEOF_DIR;
+      REQUIRE(directory.dirty_ranges(12, ranges));
+      bool covered = false;
+      for (auto const &[start, end] : ranges) {
+        covered |= start <= seg_start && seg_end <= end;
+      }
+      CHECK(covered);
+
+      // once snapshot 12 is on copy A the change is not written again
+      directory.header->sync_serial = 12;
+      directory.synced_serial[0]    = 12;
+      REQUIRE(directory.dirty_ranges(14, ranges));
+      for (auto const &[start, end] : ranges) {
+        CHECK(end <= dir_start);
+      }
+    }
     stripe->clear_dir();
 
     // Teardown
@@ -0,0 +1,113 @@
+/** @file
+
+  Unit tests for FrequencySketch
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "FrequencySketch.h"
+
+namespace
+{
+
+CryptoHash
+make_key(uint64_t n)
+{
+  CryptoHash key;
+  // Spread the bits the way a real digest would.
+  key.u64[0] = n * 0x9E3779B97F4A7C15ULL;
+  key.u64[1] = (n ^ 0xD6E8FEB86659FD93ULL) * 0xBF58476D1CE4E5B9ULL;
+  return key;
+}
+
+} // end anonymous namespace
+
+TEST_CASE("FrequencySketch counts accesses", "[cache][sketch]")
+{
+  FrequencySketch sketch;
+  sketch.init(1024);
+
+  CryptoHash key = make_key(1);
+  CHECK(sketch.frequency(key) == 0);
+
+  for (int i = 1; i <= 5; ++i) {
+    sketch.increment(key);
+    CHECK(sketch.frequency(key) == i);
+  }
+
+  SECTION("counters saturate")
+  {
+    for (int i = 0; i < 100; ++i) {
+      sketch.increment(key);
+    }
+    CHECK(sketch.frequency(key) == FrequencySketch::MAX_FREQUENCY);
+  }
+
+  SECTION("init clears the counters")
+  {
+    sketch.init(1024);
+    CHECK(sketch.frequency(key) == 0);
+  }
+}
+
+TEST_CASE("FrequencySketch separates hot and cold keys", "[cache][sketch]")
+{
+  FrequencySketch sketch;
+  sketch.init(4096);
+
+  for (int round = 0; round < 8; ++round) {
+    for (uint64_t n = 0; n < 16; ++n) {
+      sketch.increment(make_key(n));
+    }
+  }
+  for (uint64_t n = 1000; n < 3000; ++n) {
+    sketch.increment(make_key(n));
+  }
+
+  for (uint64_t n = 0; n < 16; ++n) {
+    CHECK(sketch.frequency(make_key(n)) >= 8);
+  }
+  int overestimated = 0;
+  for (uint64_t n = 1000; n < 3000; ++n) {
+    if (sketch.frequency(make_key(n)) > 2) {
+      ++overestimated;
+    }
+  }
+  CHECK(overestimated < 20);
+}
+
+TEST_CASE("FrequencySketch ages counters", "[cache][sketch]")
+{
+  FrequencySketch sketch;
+  sketch.init(1024);
+
+  CryptoHash hot = make_key(7);
+  for (int i = 0; i < 12; ++i) {
+    sketch.increment(hot);
+  }
+  REQUIRE(sketch.frequency(hot) == 12);
+
+  // Enough distinct accesses to cross the sample size and trigger aging.
+  for (uint64_t n = 100000; n < 100000 + 10 * 1024; ++n) {
+    sketch.increment(make_key(n));
+  }
+  CHECK(sketch.frequency(hot) < 12);
+}
@@ -0,0 +1,333 @@
+/** @file
+
+  Unit tests for partially cached (sparse) objects
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "main.h"
+#include "../P_CacheInternal.h"
+
+#include <cinttypes>
+
+int  cache_vols           = 1;
+bool reuse_existing_cache = false;
+
+namespace
+{
+
+constexpr int64_t OBJECT_SIZE = 10 * 1024 * 1024;
+constexpr int     MAX_RETRIES = 50;
+const char       *SPARSE_URL  = "http://www.scw22.com/";
+
+int64_t
+frag_size()
+{
+  return cache_config_target_fragment_size - sizeof(Doc);
+}
+
+} // end anonymous namespace
+
+// Write the bytes from @a offset of the object as a sparse fill.
+class CacheFillTest : public CacheTestBase
+{
+public:
+  CacheFillTest(int64_t offset, int64_t size, CacheTestHandler *cont) : CacheTestBase(cont), _offset(offset), _size(size)
+  {
+    this->_cursor       = GLOBAL_DATA + offset;
+    this->_write_buffer = new_MIOBuffer(BUFFER_SIZE_INDEX_4K);
+
+    this->info.create();
+    build_hdrs(this->info, SPARSE_URL);
+  }
+
+  ~CacheFillTest() override
+  {
+    if (this->_write_buffer) {
+      free_MIOBuffer(this->_write_buffer);
+      this->_write_buffer = nullptr;
+    }
+    info.destroy();
+  }
+
+  int
+  start_test(int /* event ATS_UNUSED */, void * /* e ATS_UNUSED */) override
+  {
+    HttpCacheKey key = generate_key(this->info);
+
+    SET_HANDLER(&CacheFillTest::write_event);
+    cacheProcessor.open_write(this, &key, nullptr);
+    return 0;
+  }
+
+  int
+  write_event(int event, void *e)
+  {
+    switch (event) {
+    case CACHE_EVENT_OPEN_WRITE:
+      this->vc = static_cast<CacheVC *>(e);
+      this->process_event(event);
+      break;
+    case VC_EVENT_WRITE_READY:
+      this->process_event(event);
+      this->fill_data();
+      break;
+    default:
+      this->process_event(event);
+      break;
+    }
+    return 0;
+  }
+
+  void
+  do_io_write(size_t /* size ATS_UNUSED */ = 0) override
+  {
+    this->vc->set_http_info(&this->info);
+    REQUIRE(this->vc->set_sparse_fill(this->_offset, OBJECT_SIZE));
+    this->vio = this->vc->do_io_write(this, this->_size, this->_write_buffer->alloc_reader());
+  }
+
+  HTTPInfo info;
+
+private:
+  void
+  fill_data()
+  {
+    int64_t size   = std::min(static_cast<int64_t>(WRITE_LIMIT), this->_size);
+    auto    n      = this->_write_buffer->write(this->_cursor, size);
+    this->_size   -= n;
+    this->_cursor += n;
+  }
+
+  int64_t     _offset       = 0;
+  int64_t     _size         = 0;
+  const char *_cursor       = nullptr;
+  MIOBuffer  *_write_buffer = nullptr;
+};
+
+// Read the bytes from @a start to @a end of the object with a Range request.
+class CacheRangeReadTest : public CacheTestBase
+{
+public:
+  CacheRangeReadTest(int64_t start, int64_t end, CacheTestHandler *cont)
+    : CacheTestBase(cont), _start(start), _size(end - start + 1)
+  {
+    this->_cursor      = GLOBAL_DATA + start;
+    this->_read_buffer = new_MIOBuffer(BUFFER_SIZE_INDEX_4K);
+    this->_reader      = this->_read_buffer->alloc_reader();
+
+    this->info.create();
+    build_hdrs(this->info, SPARSE_URL);
+
+    char range[64];
+    snprintf(range, sizeof(range), "bytes=%" PRId64 "-%" PRId64, start, end);
+    this->info.request_get()->value_set(static_cast<std::string_view>(MIME_FIELD_RANGE), range);
+  }
+
+  ~CacheRangeReadTest() override
+  {
+    if (this->_read_buffer) {
+      free_MIOBuffer(this->_read_buffer);
+      this->_read_buffer = nullptr;
+    }
+    info.destroy();
+  }
+
+  int
+  start_test(int /* event ATS_UNUSED */, void * /* e ATS_UNUSED */) override
+  {
+    HttpCacheKey key = generate_key(this->info);
+
+    SET_HANDLER(&CacheRangeReadTest::read_event);
+    cacheProcessor.open_read(this, &key, static_cast<CacheHTTPHdr *>(this->info.request_get()), &this->params);
+    return 0;
+  }
+
+  int
+  read_event(int event, void *e)
+  {
+    switch (event) {
+    case CACHE_EVENT_OPEN_READ:
+      this->vc = static_cast<CacheVC *>(e);
+      this->process_event(event);
+      break;
+    case VC_EVENT_READ_READY:
+    case VC_EVENT_READ_COMPLETE:
+      while (this->_reader->block_read_avail()) {
+        auto str = this->_reader->block_read_view();
+        CHECK(memcmp(str.data(), this->_cursor, str.size()) == 0);
+        this->_reader->consume(str.size());
+        this->_cursor += str.size();
+      }
+      this->process_event(event);
+      break;
+    default:
+      this->process_event(event);
+      break;
+    }
+    return 0;
+  }
+
+  void
+  do_io_read(size_t /* size ATS_UNUSED */ = 0) override
+  {
+    REQUIRE(this->vc->alternate.is_sparse());
+    this->vio = this->vc->do_io_pread(this, this->_size, this->_read_buffer, this->_start);
+  }
+
+  HTTPInfo info;
+
+private:
+  int64_t                _start       = 0;
+  int64_t                _size        = 0;
+  const char            *_cursor      = nullptr;
+  MIOBuffer             *_read_buffer = nullptr;
+  IOBufferReader        *_reader      = nullptr;
+  MockHttpConfigAccessor params;
+};
+
+class SparseFill : public CacheTestHandler
+{
+public:
+  SparseFill(int64_t offset, int64_t size)
+  {
+    this->_wt        = new CacheFillTest(offset, size, this);
+    this->_wt->mutex = this->mutex;
+    SET_HANDLER(&SparseFill::start_test);
+  }
+
+  int
+  start_test(int /* event ATS_UNUSED */, void * /* e ATS_UNUSED */)
+  {
+    this_ethread()->schedule_imm(this->_wt);
+    return 0;
+  }
+
+  void
+  handle_cache_event(int event, CacheTestBase *base) override
+  {
+    switch (event) {
+    case CACHE_EVENT_OPEN_WRITE:
+      base->do_io_write();
+      break;
+    case VC_EVENT_WRITE_READY:
+      base->reenable();
+      break;
+    case VC_EVENT_WRITE_COMPLETE:
+      base->close();
+      delete this;
+      break;
+    default:
+      REQUIRE(false);
+      base->close();
+      delete this;
+      break;
+    }
+  }
+};
+
+class RangeRead : public CacheTestHandler
+{
+public:
+  RangeRead(int64_t start, int64_t end, bool hit) : _start(start), _end(end), _hit(hit) { SET_HANDLER(&RangeRead::start_test); }
+
+  int
+  start_test(int /* event ATS_UNUSED */, void * /* e ATS_UNUSED */)
+  {
+    this->_rt        = new CacheRangeReadTest(this->_start, this->_end, this);
+    this->_rt->mutex = this->mutex;
+    this_ethread()->schedule_imm(this->_rt);
+    return 0;
+  }
+
+  void
+  handle_cache_event(int event, CacheTestBase *base) override
+  {
+    switch (event) {
+    case CACHE_EVENT_OPEN_READ:
+      CHECK(this->_hit);
+      base->do_io_read();
+      break;
+    case VC_EVENT_READ_READY:
+      base->reenable();
+      break;
+    case VC_EVENT_READ_COMPLETE:
+      base->close();
+      delete this;
+      break;
+    case CACHE_EVENT_OPEN_READ_RWW:
+      // the fill before this is still open, the read goes on once it is done
+      break;
+    case CACHE_EVENT_OPEN_READ_FAILED:
+      base->close();
+      // the fill before this may still be writing the vector
+      if (this->_hit && ++this->_retries < MAX_RETRIES) {
+        this_ethread()->schedule_in(this, HRTIME_MSECONDS(20));
+        break;
+      }
+      CHECK_FALSE(this->_hit);
+      delete this;
+      break;
+    default:
+      REQUIRE(false);
+      base->close();
+      delete this;
+      break;
+    }
+  }
+
+private:
+  int64_t _start   = 0;
+  int64_t _end     = 0;
+  bool    _hit     = false;
+  int     _retries = 0;
+};
+
+class CacheSparseInit : public CacheInit
+{
+public:
+  CacheSparseInit() {}
+  int
+  cache_init_success_callback(int /* event ATS_UNUSED */, void * /* e ATS_UNUSED */) override
+  {
+    int64_t F = frag_size();
+
+    // fragments 1 and 2, the partial fragments around them are dropped
+    SparseFill *h = new SparseFill(F - 10, 2 * F + 20);
+    h->add(new RangeRead(F, 3 * F - 1, true));
+    h->add(new RangeRead(F - 10, F + 10, false));
+    // the rest of the object, merged with the first fill
+    h->add(new SparseFill(3 * F, OBJECT_SIZE - 3 * F));
+    h->add(new RangeRead(F + 5, OBJECT_SIZE - 1, true));
+    h->add(new RangeRead(0, 99, false));
+    h->add(new TerminalTest);
+    this_ethread()->schedule_imm(h);
+    delete this;
+    return 0;
+  }
+};
+
+TEST_CASE("cache sparse fill -> range read", "cache")
+{
+  init_cache(256 * 1024 * 1024);
+  CacheSparseInit *init = new CacheSparseInit;
+
+  this_ethread()->schedule_imm(init);
+  this_thread()->execute();
+}
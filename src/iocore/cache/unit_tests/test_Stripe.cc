@@ -123,6 +123,12 @@ init_stripe_for_writing(StripeSM &stripe, StripeHeaderFooter &header, CacheVol &
   stripe.cache_vol->vol_rsb.write_bytes        = ts::Metrics::Counter::createPtr("unit_test.write.bytes");
   cache_rsb.gc_frags_evacuated                 = ts::Metrics::Counter::createPtr("unit_test.gc.frags.evacuated");
   stripe.cache_vol->vol_rsb.gc_frags_evacuated = ts::Metrics::Counter::createPtr("unit_test.gc.frags.evacuated");
+  for (int i = 0; i < CACHE_AGG_HISTOGRAM_BUCKETS; i++) {
+    cache_rsb.agg_write_wait[i]                    = ts::Metrics::Counter::createPtr("unit_test.agg_write.wait");
+    stripe.cache_vol->vol_rsb.agg_write_wait[i]    = ts::Metrics::Counter::createPtr("unit_test.agg_write.wait");
+    cache_rsb.agg_write_latency[i]                 = ts::Metrics::Counter::createPtr("unit_test.agg_write.latency");
+    stripe.cache_vol->vol_rsb.agg_write_latency[i] = ts::Metrics::Counter::createPtr("unit_test.agg_write.latency");
+  }
 
   stripe.sector_size = 256;
 
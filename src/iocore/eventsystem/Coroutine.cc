@@ -0,0 +1,118 @@
+/** @file
+
+  C++20 coroutines on the event system.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "iocore/eventsystem/Coroutine.h"
+#include "iocore/eventsystem/ProxyAllocator.h"
+#include "tscore/ink_memory.h"
+
+// Frames of 256 bytes to 8K, larger ones are not kept.
+Allocator coroFrameAllocator[CORO_FRAME_SIZES] = {
+  {"coroFrameAllocator[0]", 256,  128, 16},
+  {"coroFrameAllocator[1]", 512,  128, 16},
+  {"coroFrameAllocator[2]", 1024, 64,  16},
+  {"coroFrameAllocator[3]", 2048, 32,  16},
+  {"coroFrameAllocator[4]", 4096, 16,  16},
+  {"coroFrameAllocator[5]", 8192, 8,   16},
+};
+
+namespace
+{
+int
+frame_size_index(size_t size)
+{
+  for (int i = 0; i < CORO_FRAME_SIZES; ++i) {
+    if (size <= (size_t{256} << i)) {
+      return i;
+    }
+  }
+  return -1;
+}
+} // end anonymous namespace
+
+namespace ts::coro
+{
+void *
+frame_alloc(size_t size)
+{
+  int i = frame_size_index(size);
+  if (i < 0) {
+    return ats_malloc(size);
+  }
+  if (Thread *t = this_thread(); t) {
+    return THREAD_ALLOC(coroFrameAllocator[i], t);
+  }
+  return coroFrameAllocator[i].alloc_void();
+}
+
+void
+frame_free(void *p, size_t size)
+{
+  int i = frame_size_index(size);
+  if (i < 0) {
+    ats_free(p);
+    return;
+  }
+  THREAD_FREE(p, coroFrameAllocator[i], this_thread());
+}
+
+bool
+Task::IOHandler::take(VIO *vio)
+{
+  for (auto &[v, e] : _pending) {
+    if (v == vio) {
+      event = e;
+      v     = nullptr;
+      return true;
+    }
+  }
+  return false;
+}
+
+int
+Task::IOHandler::handle_event(int e, void *data)
+{
+  VIO *vio = static_cast<VIO *>(data);
+
+  if (vio == awaiting) {
+    awaiting = nullptr;
+    event    = e;
+    handle.resume();
+    return EVENT_DONE;
+  }
+
+  // Keep it for when the coroutine awaits this VIO, only the latest event matters.
+  std::pair<VIO *, int> *slot = nullptr;
+  for (auto &p : _pending) {
+    if (p.first == vio) {
+      slot = &p;
+      break;
+    }
+    if (p.first == nullptr && slot == nullptr) {
+      slot = &p;
+    }
+  }
+  ink_release_assert(slot != nullptr);
+  *slot = {vio, e};
+  return EVENT_DONE;
+}
+} // namespace ts::coro
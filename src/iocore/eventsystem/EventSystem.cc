@@ -32,6 +32,8 @@
 #include "tscore/Version.h"
 #include "tscore/hugepages.h"
 #include "records/RecCore.h"
+#include "records/RecProcess.h"
+#include "tsutil/Metrics.h"
 
 static constexpr ts::ModuleVersion EVENT_SYSTEM_MODULE_INTERNAL_VERSION{EVENT_SYSTEM_MODULE_PUBLIC_VERSION,
                                                                         ts::ModuleVersion::PRIVATE};
@@ -49,6 +51,10 @@ ink_event_system_init(ts::ModuleVersion v)
 
   extern int loop_time_update_probability;
   RecEstablishStaticConfigInt32(loop_time_update_probability, "proxy.config.exec_thread.loop_time_update_probability");
+  RecEstablishStaticConfigInt32(EThread::loop_event_budget, "proxy.config.exec_thread.loop_event_budget");
+  RecEstablishStaticConfigInt32(EThread::loop_time_budget, "proxy.config.exec_thread.loop_time_budget");
+  RecEstablishStaticConfigInt32(EThread::handler_timing, "proxy.config.exec_thread.handler_timing");
+  RecEstablishStaticConfigInt32(EThread::profile_sample_rate, "proxy.config.exec_thread.profile_sample_rate");
 
   int chunk_sizes[DEFAULT_BUFFER_SIZES] = {0};
   {
@@ -61,6 +67,26 @@ ink_event_system_init(ts::ModuleVersion v)
   }
 
   bool use_hugepages = ats_hugepage_enabled();
+  bool use_arena     = false;
+
+  if (auto arena = RecGetRecordInt("proxy.config.allocator.iobuf_arena").value_or(0); arena > 0) {
+    size_t page_size   = arena == 2 ? 1 << 30 : 2 << 20;
+    size_t region_size = RecGetRecordInt("proxy.config.allocator.iobuf_arena_region_size").value_or(0);
+    ats_hugepage_arena_init(page_size, region_size);
+    use_arena = true;
+
+    auto hugepage_bytes = ts::Metrics::Gauge::createPtr("proxy.process.allocator.iobuf_arena.hugepage_bytes");
+    auto fallback_bytes = ts::Metrics::Gauge::createPtr("proxy.process.allocator.iobuf_arena.fallback_bytes");
+    auto used_bytes     = ts::Metrics::Gauge::createPtr("proxy.process.allocator.iobuf_arena.used_bytes");
+    auto failures       = ts::Metrics::Gauge::createPtr("proxy.process.allocator.iobuf_arena.failures");
+    RecRegNewSyncStatSync([=]() {
+      HugepageArenaStats stats = ats_hugepage_arena_stats();
+      ts::Metrics::Gauge::store(hugepage_bytes, stats.hugepage_bytes);
+      ts::Metrics::Gauge::store(fallback_bytes, stats.fallback_bytes);
+      ts::Metrics::Gauge::store(used_bytes, stats.used_bytes);
+      ts::Metrics::Gauge::store(failures, stats.failures);
+    });
+  }
 
 #ifdef MADV_DONTDUMP // This should only exist on Linux 3.4 and higher.
   RecBool dont_dump_enabled = true;
@@ -73,5 +99,5 @@ ink_event_system_init(ts::ModuleVersion v)
   }
 #endif
 
-  init_buffer_allocators(iobuffer_advice, chunk_sizes, use_hugepages);
+  init_buffer_allocators(iobuffer_advice, chunk_sizes, use_hugepages, use_arena);
 }
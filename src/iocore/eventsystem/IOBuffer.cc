@@ -1012,7 +1012,7 @@ int64_t                              max_iobuffer_size           = DEFAULT_BUFFE
 // Initialization
 //
 void
-init_buffer_allocators(int iobuffer_advice, int chunk_sizes[DEFAULT_BUFFER_SIZES], bool use_hugepages)
+init_buffer_allocators(int iobuffer_advice, int chunk_sizes[DEFAULT_BUFFER_SIZES], bool use_hugepages, bool use_arena)
 {
   for (int i = 0; i < DEFAULT_BUFFER_SIZES; i++) {
     int64_t s = DEFAULT_BUFFER_BASE_SIZE * ((static_cast<int64_t>(1)) << i);
@@ -1031,7 +1031,7 @@ init_buffer_allocators(int iobuffer_advice, int chunk_sizes[DEFAULT_BUFFER_SIZES
     } else {
       snprintf(name, 64, "ioBufAllocator[%d]", i);
     }
-    ioBufAllocator[i].re_init(name, s, n, a, use_hugepages, iobuffer_advice);
+    ioBufAllocator[i].re_init(name, s, n, a, use_hugepages, iobuffer_advice, use_arena);
   }
 }
 
@@ -23,16 +23,24 @@
   @section details Details
 
   ProtectedQueue implements a FIFO queue with the following functionality:
-    -# Multiple threads could be simultaneously trying to enqueue and
-      dequeue. Hence the queue needs to be protected with mutex.
-    -# In case the queue is empty, dequeue() sleeps for a specified amount
-      of time, or until a new element is inserted, whichever is earlier.
+    -# Multiple threads could be simultaneously trying to enqueue, while
+      the owning thread dequeues. Enqueueing is wait free, a single
+      atomic exchange, so producers never block each other or the owner.
+    -# In case the queue is empty, the owner parks and sleeps for a
+      specified amount of time, or until a new element is inserted,
+      whichever is earlier. Producers wake the owner only if it is
+      parked, so a busy thread is not signaled at all.
 
 */
 
 #include "iocore/eventsystem/ProtectedQueue.h"
 #include "iocore/eventsystem/EThread.h"
 
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
 // The protected queue is designed to delay signaling of threads
 // until some amount of work has been completed on the current thread
 // in order to prevent excess context switches.
@@ -44,36 +52,100 @@
 
 extern ClassAllocator<Event, false> eventAllocator;
 
+namespace
+{
+// Event::link.next is a plain pointer, shared between producers and the owner only while the
+// event is in the external queue.
+std::atomic_ref<Event *>
+next_of(Event *e)
+{
+  return std::atomic_ref<Event *>(e->link.next);
+}
+} // namespace
+
+void
+ProtectedQueue::push(Event *e)
+{
+  next_of(e).store(nullptr, std::memory_order_relaxed);
+  Event *prev = _tail.exchange(e);
+  // Until this store the owner sees a tail it cannot reach, and does not park.
+  next_of(prev).store(e, std::memory_order_release);
+}
+
+Event *
+ProtectedQueue::pop()
+{
+  Event *head = _head;
+  Event *next = next_of(head).load(std::memory_order_acquire);
+  if (head == &_stub) {
+    if (!next) {
+      return nullptr;
+    }
+    _head = head = next;
+    next = next_of(head).load(std::memory_order_acquire);
+  }
+  if (next) {
+    _head = next;
+    return head;
+  }
+  // @a head is the last element unless a producer is part way through a push.
+  if (head != _tail.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  push(&_stub);
+  next = next_of(head).load(std::memory_order_acquire);
+  if (next) {
+    _head = next;
+    return head;
+  }
+  return nullptr;
+}
+
 void
 ProtectedQueue::enqueue(Event *e)
 {
   ink_assert(!e->in_the_prot_queue && !e->in_the_priority_queue);
   EThread *e_ethread   = e->ethread;
   e->in_the_prot_queue = 1;
-  bool was_empty       = (ink_atomiclist_push(&al, e) == nullptr);
-
-  if (was_empty) {
-    EThread *inserting_thread = this_ethread();
-    // queue e->ethread in the list of threads to be signalled
-    // inserting_thread == 0 means it is not a regular EThread
-    if (inserting_thread != e_ethread) {
-      e_ethread->tail_cb->signalActivity();
-    }
+  push(e);
+
+  // inserting_thread == 0 means it is not a regular EThread
+  EThread *inserting_thread = this_ethread();
+  if (inserting_thread != e_ethread) {
+    ring(e_ethread);
+  }
+}
+
+bool
+ProtectedQueue::ring(EThread *owner)
+{
+  // Ring the doorbell only if the owner is parked, and only once per park.
+  if (_parked.load() && _parked.exchange(0)) {
+    owner->tail_cb->signalActivity();
+    return true;
   }
+  return false;
+}
+
+void
+ProtectedQueue::signal()
+{
+#if defined(__linux__)
+  syscall(SYS_futex, &_parked, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+  // Need to get the lock before you can signal the thread
+  ink_mutex_acquire(&lock);
+  ink_cond_signal(&might_have_data);
+  ink_mutex_release(&lock);
+#endif
 }
 
 void
 ProtectedQueue::dequeue_external()
 {
-  Event *e = static_cast<Event *>(ink_atomiclist_popall(&al));
-  // invert the list, to preserve order
-  SLL<Event, Event::Link_link> l, t;
-  t.head = e;
-  while ((e = t.pop())) {
-    l.push(e);
-  }
-  // insert into localQueue
-  while ((e = l.pop())) {
+  Event *e;
+  // in order, and stopping early if a producer is part way through a push
+  while ((e = pop())) {
     if (!e->cancelled) {
       localQueue.enqueue(e);
     } else {
@@ -86,14 +158,22 @@ ProtectedQueue::dequeue_external()
 void
 ProtectedQueue::wait(ink_hrtime timeout)
 {
-  /* If there are no external events available, will do a cond_timedwait.
-   *
-   *   - The `EThread::lock` will be released,
-   *   - And then the Event Thread goes to sleep and waits for the wakeup signal of `EThread::might_have_data`,
-   *   - The `EThread::lock` will be locked again when the Event Thread wakes up.
+  /* Sleep only while still parked, a producer that finds the owner parked unparks it before it
+   * signals. On Linux the parked flag is the futex word, so a producer that unparks the owner
+   * between the check and the sleep makes the futex wait return at once.
    */
-  if (INK_ATOMICLIST_EMPTY(al) && localQueue.empty()) {
-    timespec ts = ink_hrtime_to_timespec(timeout);
+  if (timeout <= 0) {
+    return;
+  }
+#if defined(__linux__)
+  timespec ts = ink_hrtime_to_timespec(timeout);
+  syscall(SYS_futex, &_parked, FUTEX_WAIT_PRIVATE, 1, &ts, nullptr, 0);
+#else
+  timespec ts = ink_hrtime_to_timespec(ink_get_hrtime() + timeout);
+  ink_mutex_acquire(&lock);
+  if (_parked.load()) {
     ink_cond_timedwait(&might_have_data, &lock, &ts);
   }
+  ink_mutex_release(&lock);
+#endif
 }
@@ -23,6 +23,7 @@
 
 #include "iocore/eventsystem/Tasks.h"
 #include "iocore/eventsystem/EventProcessor.h"
+#include "records/RecCore.h"
 
 // Globals
 EventType      ET_TASK = ET_CALL;
@@ -40,6 +41,9 @@ TasksProcessor::register_event_type()
 int
 TasksProcessor::start(int task_threads, size_t stacksize)
 {
+  if (ET_TASK != ET_CALL) {
+    eventProcessor.thread_group[ET_TASK]._work_stealing = RecGetRecordInt("proxy.config.task_threads.work_stealing").value_or(0);
+  }
   eventProcessor.spawn_event_threads(ET_TASK, std::max(1, task_threads), stacksize);
   return 0;
 }
@@ -72,6 +72,10 @@ const ink_hrtime DELAY_FOR_RETRY               = HRTIME_MSECONDS(10);
 // Subsystem have this data.
 thread_local EThread *EThread::this_ethread_ptr;
 int                   EThread::default_wait_interval_ms = 10;
+int                   EThread::loop_event_budget        = 0;
+int                   EThread::loop_time_budget         = 0;
+int                   EThread::handler_timing           = 0;
+int                   EThread::profile_sample_rate      = 0;
 
 void
 EThread::set_specific()
@@ -168,8 +172,30 @@ EThread::process_event(Event *e, int calling_code, ink_hrtime event_time)
     // Restore the client IP debugging flags
     set_cont_flags(e->continuation->control_flags);
 
+    // Sample at random intervals that average the rate, so that a pattern in the events does not
+    // line up with the samples.
+    int  rate    = profile_sample_rate;
+    bool sampled = rate > 0 && --profile._countdown <= 0;
+    if (sampled) {
+      profile._countdown = 1 + generator.random() % (2 * rate - 1);
+    }
+
+    // The continuation may be gone after the call, so get what is needed from it first.
+    std::type_info const *type   = handler_timing || sampled ? &typeid(*c_temp) : nullptr;
+    void const           *target = sampled ? c_temp->profile_target() : nullptr;
+    ink_hrtime            start  = type ? ink_get_hrtime() : 0;
+
     e->continuation->handleEvent(calling_code, e);
-    if (loop_time_update_probability == 100) {
+    ++loop_events;
+    if (type) {
+      event_time = ink_get_hrtime();
+      if (handler_timing) {
+        metrics.record_handler_time(*type, event_time - start);
+      }
+      if (sampled) {
+        profile.record(*type, target, std::max<ink_hrtime>(0, event_time - start) * rate);
+      }
+    } else if (loop_time_update_probability == 100) {
       event_time = ink_get_hrtime();
     } else if (loop_time_update_probability > 0) {
       if (static_cast<int>(generator.random() % 100) < loop_time_update_probability) {
@@ -195,10 +221,57 @@ EThread::process_event(Event *e, int calling_code, ink_hrtime event_time)
   return event_time;
 }
 
+namespace
+{
+// Events run from the stealable queues in one loop, so that a flood of them does not hold up the
+// timed events.
+constexpr int STEALABLE_BATCH = 64;
+
+// The thread of the work stealing group @a t with the most events queued, other than @a t.
+EThread *
+busiest_sibling(EThread *t)
+{
+  EThread *victim = nullptr;
+  int      depth  = 0;
+  for (EThread *sibling : eventProcessor.active_group_threads(t->steal_group)) {
+    if (int n = sibling->EventQueueStealable.depth(); sibling != t && n > depth) {
+      victim = sibling;
+      depth  = n;
+    }
+  }
+  return victim;
+}
+} // namespace
+
+ink_hrtime
+EThread::process_stealable(int *ev_count, ink_hrtime event_time)
+{
+  for (int n = 0; n < STEALABLE_BATCH && !loop_budget_spent(); ++n) {
+    Event *e = EventQueueStealable.take();
+    if (!e) {
+      // Nothing of our own, help the busiest thread of the group.
+      EThread *victim = busiest_sibling(this);
+      if (!victim || !(e = victim->EventQueueStealable.steal())) {
+        break;
+      }
+      e->ethread = this;
+      steal_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    ++(*ev_count);
+    if (e->cancelled) {
+      free_event(e);
+    } else {
+      event_time = process_event(e, e->callback_event, event_time);
+    }
+  }
+  return event_time;
+}
+
 ink_hrtime
 EThread::process_queue(Que(Event, link) * NegativeQueue, int *ev_count, int *nq_count, ink_hrtime event_time)
 {
   Event *e;
+  Que(Event, link) deferred;
 
   // Move events from the external thread safe queues to the local queue.
   EventQueueExternal.dequeue_external();
@@ -211,6 +284,13 @@ EThread::process_queue(Que(Event, link) * NegativeQueue, int *ev_count, int *nq_
       free_event(e);
     } else if (!e->timeout_at) { // IMMEDIATE
       ink_assert(e->period == 0);
+      if (loop_budget_spent()) {
+        // Keep going to sort out the timed and poll events, but leave this for the next pass.
+        e->in_the_prot_queue = 1;
+        deferred.enqueue(e);
+        loop_cut_short = true;
+        continue;
+      }
       event_time = process_event(e, e->callback_event, event_time);
     } else if (e->timeout_at > 0) { // INTERVAL
       EventQueue.enqueue(e, event_time);
@@ -229,6 +309,8 @@ EThread::process_queue(Que(Event, link) * NegativeQueue, int *ev_count, int *nq_
     }
     ++(*nq_count);
   }
+  // The local queue is empty now, put back what was left for the next pass.
+  EventQueueExternal.localQueue = deferred;
   return event_time;
 }
 
@@ -271,14 +353,21 @@ EThread::execute_regular()
     }
     ++(current_slice->_count); // loop started, bump count.
 
+    loop_events    = 0;
+    loop_deadline  = loop_time_budget > 0 ? loop_start_time + HRTIME_USECONDS(loop_time_budget) : 0;
+    loop_cut_short = false;
+
     ink_hrtime event_time = process_queue(&NegativeQueue, &ev_count, &nq_count, loop_start_time);
+    if (steal_group != -1) {
+      event_time = process_stealable(&ev_count, event_time);
+    }
 
     bool done_one;
     do {
       done_one = false;
       // execute all the eligible internal events
       EventQueue.check_ready(event_time, this);
-      while ((e = EventQueue.dequeue_ready(event_time))) {
+      while (!loop_budget_spent() && (e = EventQueue.dequeue_ready(event_time))) {
         ink_assert(e);
         ink_assert(e->timeout_at > 0);
         if (e->cancelled) {
@@ -300,9 +389,17 @@ EThread::execute_regular()
       }
     }
 
+    // Whatever was left is ready now, only check for I/O before running it.
+    bool deferred = loop_budget_spent() && (loop_cut_short || EventQueue.ready.head || EventQueueStealable.depth());
+    if (deferred) {
+      loop_deferred.fetch_add(1, std::memory_order_relaxed);
+    }
+
     next_time             = EventQueue.earliest_timeout();
     ink_hrtime sleep_time = next_time - event_time;
-    if (sleep_time > 0) {
+    if (deferred) {
+      sleep_time = 0;
+    } else if (sleep_time > 0) {
       if (EventQueueExternal.localQueue.empty()) {
         sleep_time = std::min(sleep_time, HRTIME_MSECONDS(thread_max_heartbeat_mseconds));
       } else {
@@ -323,7 +420,15 @@ EThread::execute_regular()
     // Relaxed store because this EThread is the only writer and the watchdog only needs a coherent timestamp.
     this->heartbeat_state.last_sleep.store(std::chrono::steady_clock::now(), std::memory_order_relaxed);
 
+    // Producers only signal a parked thread, so events that arrived since the queue was drained
+    // are picked up by parking first.
+    if (sleep_time > 0 && !EventQueueExternal.park()) {
+      sleep_time = 0;
+    } else if (sleep_time > 0 && steal_group != -1 && (EventQueueStealable.depth() || busiest_sibling(this))) {
+      sleep_time = 0;
+    }
     tail_cb->waitForActivity(sleep_time);
+    EventQueueExternal.unpark();
 
     // watchdog kick - post-wake
     // Relaxed store/fetch because the monitor thread is the single reader and per-field coherence is sufficient.
@@ -372,16 +477,7 @@ EThread::execute()
 
   switch (tt) {
   case REGULAR: {
-    /* The Event Thread has two status: busy and sleep:
-     *   - Keep `EThread::lock` locked while Event Thread is busy,
-     *   - The `EThread::lock` is released while Event Thread is sleep.
-     * When other threads try to acquire the `EThread::lock` of the target Event Thread:
-     *   - Acquired, indicating that the target Event Thread is sleep,
-     *   - Failed, indicating that the target Event Thread is busy.
-     */
-    ink_mutex_acquire(&EventQueueExternal.lock);
     this->execute_regular();
-    ink_mutex_release(&EventQueueExternal.lock);
     break;
   }
   case DEDICATED: {
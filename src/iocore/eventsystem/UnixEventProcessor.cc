@@ -28,8 +28,14 @@
 #include "records/RecProcess.h"
 #include "tscore/ink_align.h"
 #include "tscore/ink_atomic.h"
+#include "tscore/ink_queue.h"
 #include "tscore/TSSystemState.h"
+#include <cxxabi.h>
+#include <map>
 #include <sched.h>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
 #if TS_USE_HWLOC
 #if __has_include(<alloca.h>)
 #include <alloca.h>
@@ -92,8 +98,51 @@ struct EventStatsBlock {
   static constexpr size_t STAT_COUNT =
     EThread::Metrics::Graph::N_BUCKETS * 2 + EThread::Metrics::Slice::N_STAT_ID * EThread::Metrics::N_TIMESCALES;
   std::array<ts::Metrics::Gauge::AtomicType *, STAT_COUNT> stats;
+
+  // Work stealing thread groups.
+  ts::Metrics::Gauge::AtomicType *steals;
+  ts::Metrics::Gauge::AtomicType *steal_queue_depth;
+  ts::Metrics::Gauge::AtomicType *steal_queue_depth_max;
+
+  // Event loop budgets.
+  ts::Metrics::Gauge::AtomicType *deferred;
 } events_rsb;
 
+/// Stat name for the handler timings of the continuation type @a type.
+std::string
+handler_stat_name(std::type_info const &type)
+{
+  int         status    = 0;
+  char       *demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+  std::string name{EThread::Metrics::HANDLER_STAT_STEM};
+
+  for (char const *c = status == 0 ? demangled : type.name(); *c; ++c) {
+    name += (isalnum(static_cast<unsigned char>(*c)) || *c == '_') ? *c : '_';
+  }
+  free(demangled);
+  return name;
+}
+
+/// Upper bound of the bucket of @a graph that has the @a pct percentile sample, 0 if it is empty.
+template <typename G>
+uint64_t
+histogram_percentile(G &graph, unsigned pct)
+{
+  uint64_t total = 0;
+  for (unsigned idx = 0; idx < G::N_BUCKETS; ++idx) {
+    total += graph[idx];
+  }
+  uint64_t rank = (total * pct + 99) / 100;
+  uint64_t sum  = 0;
+  for (unsigned idx = 0; total && idx < G::N_BUCKETS; ++idx) {
+    if ((sum += graph[idx]) >= rank) {
+      // The overflow bucket has no upper bound, use its lower bound.
+      return G::min_for_bucket(std::min<unsigned>(idx + 1, G::N_BUCKETS - 1));
+    }
+  }
+  return 0;
+}
+
 void
 EventMetricStatSync()
 {
@@ -140,13 +189,66 @@ EventMetricStatSync()
     ts::Metrics::Gauge::store(events_rsb.stats[id], summary._api_timing[idx]);
   }
 
+  // Work stealing groups, summed over the groups.
+  uint64_t steals    = 0;
+  int64_t  depth     = 0;
+  int64_t  depth_max = 0;
+  for (int group = 0; group < eventProcessor.n_thread_groups; ++group) {
+    if (eventProcessor.thread_group[group]._work_stealing) {
+      for (EThread *t : eventProcessor.active_group_threads(group)) {
+        int n      = t->EventQueueStealable.depth();
+        steals    += t->steal_count.load(std::memory_order_relaxed);
+        depth     += n;
+        depth_max  = std::max<int64_t>(depth_max, n);
+      }
+    }
+  }
+  ts::Metrics::Gauge::store(events_rsb.steals, steals);
+  ts::Metrics::Gauge::store(events_rsb.steal_queue_depth, depth);
+  ts::Metrics::Gauge::store(events_rsb.steal_queue_depth_max, depth_max);
+
+  // Event loop budgets and handler timings, over all the thread groups. A type can have more than
+  // one @c type_info if it is in more than one shared object, so the timings are merged by name.
+  static std::unordered_map<std::type_info const *, std::string>             handler_names;
+  static std::unordered_map<std::string, ts::Metrics::Gauge::AtomicType *> handler_gauges;
+  std::map<std::string_view, EThread::Metrics::HandlerTiming::Graph>        handler_timing;
+  uint64_t                                                                   deferred = 0;
+
+  for (int group = 0; group < eventProcessor.n_thread_groups; ++group) {
+    for (EThread *t : eventProcessor.active_group_threads(group)) {
+      deferred += t->loop_deferred.load(std::memory_order_relaxed);
+      if (t->metrics._decay_count) {
+        continue;
+      }
+      for (auto &h : t->metrics._handler_timing) {
+        if (auto type = h._type.load(std::memory_order_acquire); type) {
+          auto [spot, added] = handler_names.try_emplace(type);
+          if (added) {
+            spot->second = handler_stat_name(*type);
+          }
+          handler_timing[spot->second] += h._timing;
+        }
+      }
+    }
+  }
+  ts::Metrics::Gauge::store(events_rsb.deferred, deferred);
+  for (auto &[name, graph] : handler_timing) {
+    auto &gauge = handler_gauges[std::string{name}];
+    if (!gauge) {
+      gauge = ts::Metrics::Gauge::createPtr(std::string{name} + ".p99");
+    }
+    ts::Metrics::Gauge::store(gauge, histogram_percentile(graph, 99));
+  }
+
   // Check if it's time to schedule a decay of the histogram data.
-  // Done here so that it's (roughly) synchronized across the ET_NET threads.
+  // Done here so that it's (roughly) synchronized across the event threads.
   // The decay is done in the local threads, this bumps a counter to indicate it should be done.
   if (auto now = ts_clock::now(); now > (EThread::Metrics::_last_decay_time + EThread::Metrics::_decay_delay)) {
     EThread::Metrics::_last_decay_time = now;
-    for (EThread *t : eventProcessor.active_group_threads(ET_CALL)) {
-      ++(t->metrics._decay_count);
+    for (int group = 0; group < eventProcessor.n_thread_groups; ++group) {
+      for (EThread *t : eventProcessor.active_group_threads(group)) {
+        ++(t->metrics._decay_count);
+      }
     }
   }
 }
@@ -280,6 +382,12 @@ ThreadAffinityInitializer::set_affinity(int, Event *)
     Dbg(dbg_ctl_iocore_thread, "EThread: %d %s: %d", _name, obj->logical_index);
 #endif // HWLOC_API_VERSION
     hwloc_set_thread_cpubind(ink_get_topology(), t->tid, obj->cpuset, HWLOC_CPUBIND_STRICT);
+
+    // If the thread is kept on one NUMA node, have it use the free lists of that node.
+    if (hwloc_get_nbobjs_inside_cpuset_by_type(ink_get_topology(), obj->cpuset, HWLOC_OBJ_NODE) == 1) {
+      hwloc_obj_t node = hwloc_get_obj_inside_cpuset_by_type(ink_get_topology(), obj->cpuset, HWLOC_OBJ_NODE, 0);
+      ink_freelist_set_thread_node(node->logical_index);
+    }
   } else {
     Warning("hwloc returned an unexpected number of objects -- CPU affinity disabled");
   }
@@ -456,6 +564,9 @@ EventProcessor::spawn_event_threads(EventType ev_type, int n_threads, size_t sta
     tg->_thread[i]               = t;
     t->id                        = i; // unfortunately needed to support affinity and NUMA logic.
     t->set_event_type(ev_type);
+    if (tg->_work_stealing) {
+      t->steal_group = ev_type;
+    }
     t->schedule_spawn(&thread_initializer);
   }
   tg->_count  = n_threads;
@@ -548,6 +659,11 @@ EventProcessor::start(int n_event_threads, size_t stacksize)
 
   debug_assert_message(stat_idx == events_rsb.stats.size(), "events_rsp stats overrun!");
 
+  events_rsb.steals                = ts::Metrics::Gauge::createPtr("proxy.process.eventloop.steals");
+  events_rsb.steal_queue_depth     = ts::Metrics::Gauge::createPtr("proxy.process.eventloop.steal_queue.depth");
+  events_rsb.steal_queue_depth_max = ts::Metrics::Gauge::createPtr("proxy.process.eventloop.steal_queue.depth.max");
+  events_rsb.deferred              = ts::Metrics::Gauge::createPtr("proxy.process.eventloop.deferred");
+
   RecRegNewSyncStatSync(EventMetricStatSync);
 
   this->spawn_event_threads(ET_CALL, n_event_threads, stacksize);
@@ -705,6 +821,20 @@ EventProcessor::schedule(Event *e, EventType etype)
     e->mutex = e->continuation->mutex;
   }
 
+  if (ThreadGroupDescriptor &tg = thread_group[etype];
+      tg._work_stealing && e->ethread->steal_group == etype && !e->timeout_at && !e->period) {
+    EThread *target = e->ethread;
+    target->EventQueueStealable.push(e);
+    // If the target is busy, wake another thread of the group to steal the event.
+    if (!target->EventQueueExternal.ring(target)) {
+      EThread *thief = tg._thread[++tg._next_thief % tg._count];
+      if (thief != target) {
+        thief->EventQueueExternal.ring(thief);
+      }
+    }
+    return e;
+  }
+
   if (curr_thread != nullptr && e->ethread == curr_thread) {
     e->ethread->EventQueueExternal.enqueue_local(e);
   } else {
@@ -0,0 +1,136 @@
+/** @file
+
+  Microbenchmark for scheduling events across threads
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+/*
+  Measures the cost of EThread::schedule_imm from threads other than the
+  target, which goes through the ProtectedQueue of the target thread.
+
+  The latency case schedules one event at a time on an idle thread and waits
+  for it to run, so it includes waking the thread. The throughput case has
+  several producer threads schedule a batch of events each on one thread, so
+  mostly the queue itself is measured while the thread is busy draining it.
+
+  This is not run by ctest, run benchmark_ProtectedQueue directly.
+*/
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/reporters/catch_reporter_event_listener.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+
+#include "iocore/eventsystem/EventSystem.h"
+#include "tscore/Layout.h"
+
+#include "iocore/utils/diags.i"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+constexpr int PRODUCERS = 4;
+constexpr int BATCH     = 1000;
+
+struct Counter : public Continuation {
+  std::atomic<int> count{0};
+
+  Counter() : Continuation(new_ProxyMutex()) { SET_HANDLER(&Counter::handle_event); }
+
+  int
+  handle_event(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+  {
+    count.fetch_add(1, std::memory_order_release);
+    return EVENT_DONE;
+  }
+
+  void
+  wait_for(int n) const
+  {
+    while (count.load(std::memory_order_acquire) < n) {
+      std::this_thread::yield();
+    }
+  }
+};
+
+EThread *
+target_thread()
+{
+  return eventProcessor.thread_group[ET_CALL]._thread[0];
+}
+
+} // end anonymous namespace
+
+TEST_CASE("cross thread schedule_imm", "[iocore][bench]")
+{
+  Counter  counter;
+  EThread *target = target_thread();
+
+  BENCHMARK("latency to an idle thread")
+  {
+    int n = counter.count.load() + 1;
+    target->schedule_imm(&counter);
+    counter.wait_for(n);
+    return n;
+  };
+
+  BENCHMARK("throughput, 4 producers of 1000 events")
+  {
+    int                      n = counter.count.load() + PRODUCERS * BATCH;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+      producers.emplace_back([&]() {
+        for (int i = 0; i < BATCH; ++i) {
+          target->schedule_imm(&counter);
+        }
+      });
+    }
+    for (auto &t : producers) {
+      t.join();
+    }
+    counter.wait_for(n);
+    return n;
+  };
+}
+
+struct EventProcessorListener : Catch::EventListenerBase {
+  using EventListenerBase::EventListenerBase;
+
+  void
+  testRunStarting(Catch::TestRunInfo const & /* testRunInfo ATS_UNUSED */) override
+  {
+    Layout::create();
+    init_diags("", nullptr);
+    RecProcessInit();
+
+    ink_event_system_init(EVENT_SYSTEM_MODULE_PUBLIC_VERSION);
+    eventProcessor.start(1, 1048576); // Hardcoded stacksize at 1MB
+
+    EThread *main_thread = new EThread;
+    main_thread->set_specific();
+  }
+};
+
+CATCH_REGISTER_LISTENER(EventProcessorListener);
@@ -26,6 +26,7 @@
 #include <catch2/reporters/catch_reporter_registrars.hpp>
 #include <catch2/interfaces/catch_interfaces_config.hpp>
 
+#include "iocore/eventsystem/Coroutine.h"
 #include "iocore/eventsystem/EventSystem.h"
 #include "tscore/ink_atomic.h"
 #include "tscore/Layout.h"
@@ -33,9 +34,239 @@
 
 #include "iocore/utils/diags.i"
 
+#include <atomic>
+#include <thread>
+
 #define TEST_TIME_SECOND 60
 #define TEST_THREADS     2
 
+// Runs before the "EventSystem" test case, which shuts the event system down.
+TEST_CASE("EventSystemWorkStealing", "[iocore]")
+{
+  static constexpr int    TASKS = 10;
+  static std::atomic<int> done;
+  static std::atomic<int> blocking;
+  static std::atomic<int> release;
+
+  struct blocker : public Continuation {
+    blocker() : Continuation(new_ProxyMutex()) { SET_HANDLER(&blocker::block); }
+
+    int
+    block(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+    {
+      blocking = 1;
+      while (!release) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      return 0;
+    }
+  };
+
+  struct task : public Continuation {
+    task() : Continuation(new_ProxyMutex()) { SET_HANDLER(&task::run); }
+
+    int
+    run(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+    {
+      ++done;
+      return 0;
+    }
+  };
+
+  EventType et                                   = eventProcessor.register_event_type("ET_STEAL");
+  eventProcessor.thread_group[et]._work_stealing = true;
+  eventProcessor.spawn_event_threads(et, 2, 1048576);
+  while (eventProcessor.thread_group[et]._started < 2) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // Events are assigned round robin, so half of them are queued behind the blocked thread.
+  blocker b;
+  eventProcessor.schedule_imm(&b, et);
+  while (!blocking) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  task tasks[TASKS];
+  for (auto &t : tasks) {
+    eventProcessor.schedule_imm(&t, et);
+  }
+  for (int i = 0; i < 500 && done < TASKS; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  CHECK(done == TASKS);
+
+  uint64_t steals = 0;
+  for (EThread *t : eventProcessor.active_group_threads(et)) {
+    steals += t->steal_count;
+  }
+  CHECK(steals > 0);
+  release = 1;
+}
+
+// Runs before the "EventSystem" test case, which shuts the event system down.
+TEST_CASE("EventSystemLoopBudget", "[iocore]")
+{
+  static constexpr int    TASKS = 10;
+  static std::atomic<int> done;
+
+  struct task : public Continuation {
+    task() : Continuation(new_ProxyMutex()) { SET_HANDLER(&task::run); }
+
+    int
+    run(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+    {
+      ++done;
+      return 0;
+    }
+  };
+
+  // Queues all the tasks at once on its own thread.
+  struct spawner : public Continuation {
+    task tasks[TASKS];
+
+    spawner() : Continuation(new_ProxyMutex()) { SET_HANDLER(&spawner::spawn); }
+
+    int
+    spawn(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+    {
+      for (auto &t : tasks) {
+        this_ethread()->schedule_imm_local(&t);
+      }
+      return 0;
+    }
+  };
+
+  EThread *t        = eventProcessor.thread_group[ET_CALL]._thread[0];
+  uint64_t deferred = t->loop_deferred;
+
+  EThread::loop_event_budget = 1;
+  EThread::handler_timing    = 1;
+  spawner s;
+  t->schedule_imm(&s);
+  for (int i = 0; i < 500 && done < TASKS; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EThread::loop_event_budget = 0;
+  EThread::handler_timing    = 0;
+  CHECK(done == TASKS);
+
+  // Each task after the first was left for a later pass.
+  CHECK(t->loop_deferred - deferred >= TASKS - 1);
+
+  bool timed = false;
+  for (auto &h : t->metrics._handler_timing) {
+    timed = timed || h._type == &typeid(task);
+  }
+  CHECK(timed);
+}
+
+// Runs before the "EventSystem" test case, which shuts the event system down.
+TEST_CASE("EventSystemProfile", "[iocore]")
+{
+  static constexpr int    TASKS = 10;
+  static std::atomic<int> done;
+
+  struct task : public Continuation {
+    task() : Continuation(new_ProxyMutex()) { SET_HANDLER(&task::run); }
+
+    int
+    run(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+    {
+      ++done;
+      return 0;
+    }
+  };
+
+  EThread *t = eventProcessor.thread_group[ET_CALL]._thread[0];
+
+  EThread::profile_sample_rate = 1;
+  task tasks[TASKS];
+  for (auto &task : tasks) {
+    t->schedule_imm(&task);
+  }
+  for (int i = 0; i < 500 && done < TASKS; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EThread::profile_sample_rate = 0;
+  CHECK(done == TASKS);
+
+  // Every call was sampled and charged to the handler.
+  uint64_t samples = 0;
+  for (auto &e : t->profile._entry) {
+    if (e._type == &typeid(task)) {
+      CHECK(e._target == tasks[0].profile_target());
+      samples += e._samples;
+    }
+  }
+  CHECK(samples == TASKS);
+}
+
+// Runs before the "EventSystem" test case, which shuts the event system down.
+TEST_CASE("EventSystemCoroutine", "[iocore]")
+{
+  static constexpr int CALLED = 1234;
+
+  struct runner : public Continuation {
+    EThread          *thread = nullptr;
+    std::atomic<int>  done{0};
+    std::atomic<int>  events[3]{};
+    std::atomic<bool> locked{true};
+    std::atomic<bool> same_thread{true};
+    ink_hrtime        elapsed = 0;
+
+    runner() : Continuation(new_ProxyMutex()) { SET_HANDLER(&runner::start); }
+
+    int
+    start(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+    {
+      thread = this_ethread();
+      run();
+      return 0;
+    }
+
+    void
+    resumed()
+    {
+      locked      = locked && mutex->thread_holding == this_ethread();
+      same_thread = same_thread && thread == this_ethread();
+    }
+
+    ts::coro::Task
+    run()
+    {
+      ink_hrtime start = ink_get_hrtime();
+      auto       r     = co_await ts::coro::schedule_in(HRTIME_MSECONDS(20));
+      elapsed          = ink_get_hrtime() - start;
+      events[0]        = r.event;
+      resumed();
+
+      r         = co_await ts::coro::schedule_imm();
+      events[1] = r.event;
+      resumed();
+
+      // Called back before it is suspended.
+      r         = co_await ts::coro::call([](Continuation *c) { c->handleEvent(CALLED, nullptr); });
+      events[2] = r.event;
+      resumed();
+
+      done = 1;
+    }
+  };
+
+  runner r;
+  eventProcessor.schedule_imm(&r);
+  for (int i = 0; i < 500 && !r.done; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  REQUIRE(r.done);
+  CHECK(r.events[0] == EVENT_INTERVAL);
+  CHECK(r.events[1] == EVENT_IMMEDIATE);
+  CHECK(r.events[2] == CALLED);
+  CHECK(r.elapsed >= HRTIME_MSECONDS(20));
+  CHECK(r.locked);
+  CHECK(r.same_thread);
+}
+
 TEST_CASE("EventSystem", "[iocore]")
 {
   static int count;
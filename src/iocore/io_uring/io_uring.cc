@@ -22,8 +22,11 @@ Linux io_uring helper library
  */
 
 #include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <algorithm>
 #include <atomic>
 #include <cstring>
+#include <mutex>
 #include <stdexcept>
 
 #include <unistd.h>
@@ -41,6 +44,22 @@ namespace
 {
 DbgCtl dbg_ctl_io_uring{"io_uring"};
 
+// Files and buffers registered with every ring, each ring copies them when the generation changes.
+struct FixedRegistry {
+  std::mutex            mutex;
+  std::atomic<uint64_t> generation{0};
+  std::vector<int>      files;
+  std::vector<iovec>    buffers; // sorted by base address
+};
+
+FixedRegistry fixed_registry;
+
+bool
+iovec_before(const iovec &a, const iovec &b)
+{
+  return reinterpret_cast<uintptr_t>(a.iov_base) < reinterpret_cast<uintptr_t>(b.iov_base);
+}
+
 } // end anonymous namespace
 
 IOUringConfig IOUringContext::config;
@@ -209,6 +228,109 @@ IOUringContext::register_eventfd()
   return evfd;
 }
 
+void
+IOUringContext::register_file(int fd)
+{
+  if (!config.fixed) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(fixed_registry.mutex);
+  auto                       &files = fixed_registry.files;
+  if (std::find(files.begin(), files.end(), fd) == files.end()) {
+    files.push_back(fd);
+    ++fixed_registry.generation;
+  }
+}
+
+void
+IOUringContext::register_buffer(void *base, size_t len)
+{
+  if (!config.fixed) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(fixed_registry.mutex);
+  auto                       &buffers = fixed_registry.buffers;
+  if (buffers.size() >= UIO_MAXIOV) {
+    Dbg(dbg_ctl_io_uring, "not registering buffer %p, the limit of %d buffers is reached", base, UIO_MAXIOV);
+    return;
+  }
+  iovec iov{base, len};
+  buffers.insert(std::upper_bound(buffers.begin(), buffers.end(), iov, iovec_before), iov);
+  ++fixed_registry.generation;
+}
+
+void
+IOUringContext::unregister_buffer(void *base)
+{
+  std::lock_guard<std::mutex> lock(fixed_registry.mutex);
+  auto                       &buffers = fixed_registry.buffers;
+  auto it = std::find_if(buffers.begin(), buffers.end(), [base](const iovec &iov) { return iov.iov_base == base; });
+  if (it != buffers.end()) {
+    buffers.erase(it);
+    ++fixed_registry.generation;
+  }
+}
+
+// Replace this ring's registered files and buffers with the current ones. They
+// only change while the cache is set up, so whole tables are registered again.
+void
+IOUringContext::sync_fixed()
+{
+  std::lock_guard<std::mutex> lock(fixed_registry.mutex);
+  fixed_generation = fixed_registry.generation.load();
+
+  if (!fixed_files.empty()) {
+    io_uring_unregister_files(&ring);
+  }
+  if (!fixed_buffers.empty()) {
+    io_uring_unregister_buffers(&ring);
+  }
+  fixed_files   = fixed_registry.files;
+  fixed_buffers = fixed_registry.buffers;
+
+  if (!fixed_files.empty()) {
+    if (int ret = io_uring_register_files(&ring, fixed_files.data(), fixed_files.size()); ret < 0) {
+      Warning("io_uring unable to register %zu files: %s", fixed_files.size(), strerror(-ret));
+      fixed_files.clear();
+    }
+  }
+  if (!fixed_buffers.empty()) {
+    // pinned buffers are charged against RLIMIT_MEMLOCK on older kernels
+    if (int ret = io_uring_register_buffers(&ring, fixed_buffers.data(), fixed_buffers.size()); ret < 0) {
+      Warning("io_uring unable to register %zu buffers: %s", fixed_buffers.size(), strerror(-ret));
+      fixed_buffers.clear();
+    }
+  }
+  Dbg(dbg_ctl_io_uring, "ring %d registered %zu files and %zu buffers", ring.ring_fd, fixed_files.size(), fixed_buffers.size());
+}
+
+int
+IOUringContext::fixed_file(int fd)
+{
+  if (fixed_generation != fixed_registry.generation.load(std::memory_order_acquire)) {
+    sync_fixed();
+  }
+  auto it = std::find(fixed_files.begin(), fixed_files.end(), fd);
+  return it == fixed_files.end() ? -1 : it - fixed_files.begin();
+}
+
+int
+IOUringContext::fixed_buffer(const void *p, size_t len)
+{
+  if (fixed_generation != fixed_registry.generation.load(std::memory_order_acquire)) {
+    sync_fixed();
+  }
+  iovec key{const_cast<void *>(p), len};
+  auto  it = std::upper_bound(fixed_buffers.begin(), fixed_buffers.end(), key, iovec_before);
+  if (it == fixed_buffers.begin()) {
+    return -1;
+  }
+  --it;
+  uintptr_t start = reinterpret_cast<uintptr_t>(p);
+  uintptr_t base  = reinterpret_cast<uintptr_t>(it->iov_base);
+  return start + len <= base + it->iov_len ? it - fixed_buffers.begin() : -1;
+}
+
 IOUringContext *
 IOUringContext::local_context()
 {
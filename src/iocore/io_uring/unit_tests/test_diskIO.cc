@@ -21,6 +21,7 @@
   limitations under the License.
  */
 #include <atomic>
+#include <cstring>
 #include <fcntl.h>
 #include <catch2/catch_test_macros.hpp>
 
@@ -164,6 +165,52 @@ TEST_CASE("disk_io", "[io_uring]")
   ctx.submit_and_wait(100 * HRTIME_MSECOND);
 }
 
+TEST_CASE("fixed_io", "[io_uring]")
+{
+  IOUringConfig cfg = {
+    .queue_entries = 32,
+    .fixed         = 1,
+  };
+  IOUringContext::set_config(cfg);
+  IOUringContext ctx;
+
+  auto tmp = temp_prefix("fixed_io");
+  int  fd  = open_path(tmp / "a");
+  REQUIRE(fd != -1);
+
+  char buffer[8192] = {0};
+  IOUringContext::register_file(fd);
+  IOUringContext::register_buffer(buffer, sizeof(buffer));
+
+  int file = ctx.fixed_file(fd);
+  int buf  = ctx.fixed_buffer(buffer + 16, 16);
+  REQUIRE(file == 0);
+  REQUIRE(buf == 0);
+  REQUIRE(ctx.fixed_file(fd + 1) == -1);
+  REQUIRE(ctx.fixed_buffer(buffer + sizeof(buffer) - 8, 16) == -1);
+
+  memcpy(buffer, "hello", 5);
+  io_uring_sqe *s = ctx.next_sqe(handle([](int result) { REQUIRE(result == 5); }));
+  io_uring_prep_write_fixed(s, file, buffer, 5, 0, buf);
+  s->flags |= IOSQE_FIXED_FILE;
+  ctx.submit_and_wait(100 * HRTIME_MSECOND);
+
+  memset(buffer, 0, 5);
+  s = ctx.next_sqe(handle([&](int result) {
+    using namespace std::literals;
+
+    REQUIRE(result == 5);
+    REQUIRE("hello"sv == std::string_view(buffer, result));
+  }));
+  io_uring_prep_read_fixed(s, file, buffer, 5, 0, buf);
+  s->flags |= IOSQE_FIXED_FILE;
+  ctx.submit_and_wait(100 * HRTIME_MSECOND);
+
+  IOUringContext::unregister_buffer(buffer);
+  REQUIRE(ctx.fixed_buffer(buffer, 5) == -1);
+  close(fd);
+}
+
 void
 set_reuseport(int s)
 {
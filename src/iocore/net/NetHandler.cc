@@ -25,6 +25,7 @@
 #include "P_UnixNet.h"
 #include "iocore/net/NetHandler.h"
 #include "iocore/net/PollCont.h"
+#include "tscore/ink_atomic.h"
 #if TS_USE_LINUX_IO_URING
 #include "iocore/io_uring/IO_URING.h"
 #endif
@@ -38,6 +39,10 @@ namespace
 DbgCtl dbg_ctl_net_queue{"net_queue"};
 DbgCtl dbg_ctl_v_net_queue{"v_net_queue"};
 
+// NetEvents with no timeout set are still looked at now and then, to free the ones closed from
+// another thread and to see timeouts that were set without telling the InactivityCop.
+constexpr ink_hrtime NO_TIMEOUT_CHECK_PERIOD = HRTIME_SECONDS(30);
+
 } // end anonymous namespace
 
 std::atomic<int32_t>  NetHandler::additional_accepts{0};
@@ -103,6 +108,49 @@ NetHandler::startCop(NetEvent *ne)
   ink_assert(!open_list.in(ne));
 
   open_list.enqueue(ne);
+  file_cop(ne, ink_get_hrtime());
+}
+
+void
+NetHandler::retime_cop(NetEvent *ne)
+{
+  if (!ink_atomic_swap(&ne->in_cop_retime_list, 1)) {
+    cop_retime_list.push(ne);
+  }
+}
+
+void
+NetHandler::file_cop(NetEvent *ne, ink_hrtime now, ink_hrtime not_before)
+{
+  ink_hrtime at = now + NO_TIMEOUT_CHECK_PERIOD;
+
+  if (ne->closed) {
+    at = now;
+  } else if (ne->next_inactivity_timeout_at && ne->next_activity_timeout_at) {
+    at = std::min(ne->next_inactivity_timeout_at, ne->next_activity_timeout_at);
+  } else if (ne->next_inactivity_timeout_at || ne->next_activity_timeout_at) {
+    at = ne->next_inactivity_timeout_at + ne->next_activity_timeout_at;
+  } else if ((ne->read.enabled || ne->write.enabled) && ne->default_inactivity_timeout_in != 0) {
+    at = now; // to get the default inactivity timeout
+  }
+
+  cop_wheel.remove(ne);
+  ne->cop_check_at = std::max(at, not_before);
+  cop_wheel.insert(ne);
+}
+
+void
+NetHandler::process_cop_retime_list(ink_hrtime now)
+{
+  NetEvent *ne = nullptr;
+
+  SList(NetEvent, cop_retime_link) rq(cop_retime_list.popall());
+  while ((ne = rq.pop())) {
+    ne->in_cop_retime_list = 0;
+    if (open_list.in(ne)) {
+      file_cop(ne, now);
+    }
+  }
 }
 
 void
@@ -111,7 +159,11 @@ NetHandler::stopCop(NetEvent *ne)
   ink_release_assert(ne->nh == this);
 
   open_list.remove(ne);
-  cop_list.remove(ne);
+  cop_wheel.remove(ne);
+  if (ne->in_cop_retime_list) {
+    cop_retime_list.remove(ne);
+    ne->in_cop_retime_list = 0;
+  }
   remove_from_keep_alive_queue(ne);
   remove_from_active_queue(ne);
 }
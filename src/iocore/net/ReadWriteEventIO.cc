@@ -50,12 +50,7 @@ ReadWriteEventIO::start(EventLoop l, int afd, NetEvent *ne, NetHandler *nh, int
 void
 ReadWriteEventIO::process_event(int flags)
 {
-  // Remove triggered NetEvent from cop_list because it won't be timeout before
-  // next InactivityCop runs.
   ATS_PROBE2(eventio_rw_process_event, _ne->get_fd(), flags);
-  if (_nh->cop_list.in(_ne)) {
-    _nh->cop_list.remove(_ne);
-  }
   if (flags & (EVENTIO_ERROR)) {
     _ne->set_error_from_socket();
   }
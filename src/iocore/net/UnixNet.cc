@@ -72,7 +72,7 @@ get_PollDescriptor(EThread *t)
 
 // INKqa10496
 // One Inactivity cop runs on each thread once every second and
-// loops through the list of NetEvents and calls the timeouts
+// checks the NetEvents whose timeouts are due
 class InactivityCop : public Continuation
 {
 public:
@@ -85,19 +85,26 @@ public:
     NetHandler &nh  = *get_NetHandler(this_ethread());
 
     Dbg(dbg_ctl_inactivity_cop_check, "Checking inactivity on Thread-ID #%d", this_ethread()->id);
-    // The rest NetEvents in cop_list which are not triggered between InactivityCop runs.
-    // Use pop() to catch any closes caused by callbacks.
-    while (NetEvent *ne = nh.cop_list.pop()) {
+    // Only the NetEvents filed in cop_wheel for now or earlier are looked at, not the whole
+    // open_list. The ones that were given a timeout since the last run are filed again first.
+    nh.process_cop_retime_list(now);
+    nh.cop_wheel.advance(now, [&](NetEvent *ne) {
+      if (ne->get_thread() != this_ethread()) {
+        nh.file_cop(ne, now, now + 1);
+        return;
+      }
+
       // If we cannot get the lock don't stop just keep cleaning
       MUTEX_TRY_LOCK(lock, ne->get_mutex(), this_ethread());
       if (!lock.is_locked()) {
         Metrics::Counter::increment(net_rsb.inactivity_cop_lock_acquire_failure);
-        continue;
+        nh.file_cop(ne, now, now + 1);
+        return;
       }
 
       if (ne->closed) {
         nh.free_netevent(ne);
-        continue;
+        return;
       }
 
       if (ne->default_inactivity_timeout_in == -1) {
@@ -121,6 +128,10 @@ public:
         Metrics::Counter::increment(net_rsb.default_inactivity_timeout_applied);
       }
 
+      // Filed again before the callback, which may free it. A timeout that is still due after
+      // the callback is seen in the next run.
+      nh.file_cop(ne, now, now + 1);
+
       if (ne->next_inactivity_timeout_at && ne->next_inactivity_timeout_at < now) {
         if (ne->is_default_inactivity_timeout()) {
           // track the connections that timed out due to default inactivity
@@ -141,19 +152,7 @@ public:
             ink_hrtime_to_sec(now), ne->next_activity_timeout_at, ne->active_timeout_in);
         ne->callback(VC_EVENT_ACTIVE_TIMEOUT, e);
       }
-    }
-    // The cop_list is empty now.
-    // Let's reload the cop_list from open_list again.
-    forl_LL(NetEvent, ne, nh.open_list)
-    {
-      if (ne->get_thread() == this_ethread()) {
-        nh.cop_list.push(ne);
-      }
-    }
-    // NetHandler will remove NetEvent from cop_list if it is triggered.
-    // As the NetHandler runs, the number of NetEvents in the cop_list is decreasing.
-    // NetHandler runs 100 times maximum between InactivityCop runs.
-    // Therefore we don't have to check all the NetEvents as much as open_list.
+    });
 
     // Cleanup the active and keep-alive queues periodically
     nh.manage_active_queue(nullptr, true); // close any connections over the active timeout
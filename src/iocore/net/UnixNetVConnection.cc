@@ -289,6 +289,9 @@ UnixNetVConnection::do_io_close(int alerrno /* = -1 */)
     } else {
       this->free_thread(t);
     }
+  } else if (nh) {
+    // Freed by the cop of the thread, at its next run.
+    nh->retime_cop(this);
   }
 }
 
@@ -450,8 +453,14 @@ UnixNetVConnection::set_enabled(VIO *vio)
   ink_assert(vio->mutex->thread_holding == this_ethread() && thread);
   ink_release_assert(!closed);
   STATE_FROM_VIO(vio)->enabled = 1;
-  if (!next_inactivity_timeout_at && inactivity_timeout_in) {
-    next_inactivity_timeout_at = ink_get_hrtime() + inactivity_timeout_in;
+  if (!next_inactivity_timeout_at) {
+    if (inactivity_timeout_in) {
+      next_inactivity_timeout_at = ink_get_hrtime() + inactivity_timeout_in;
+    }
+    // Either way there is an inactivity timeout now, the one set here or the default the cop sets.
+    if (nh) {
+      nh->retime_cop(this);
+    }
   }
 }
 
@@ -936,6 +945,10 @@ UnixNetVConnection::netActivity()
 {
   Dbg(dbg_ctl_socket, "net_activity updating inactivity %" PRId64 ", NetVC=%p", this->inactivity_timeout_in, this);
   if (this->inactivity_timeout_in) {
+    // Only a timeout that was not set before can be due before the cop is going to look.
+    if (!this->next_inactivity_timeout_at && this->nh) {
+      this->nh->retime_cop(this);
+    }
     this->next_inactivity_timeout_at = ink_get_hrtime() + this->inactivity_timeout_in;
   } else {
     this->next_inactivity_timeout_at = 0;
@@ -1286,6 +1299,20 @@ UnixNetVConnection::set_inactivity_timeout(ink_hrtime timeout_in)
   Dbg(dbg_ctl_socket, "Set inactive timeout=%" PRId64 ", for NetVC=%p", timeout_in, this);
   inactivity_timeout_in      = timeout_in;
   next_inactivity_timeout_at = (timeout_in > 0) ? ink_get_hrtime() + inactivity_timeout_in : 0;
+  if (nh && next_inactivity_timeout_at) {
+    nh->retime_cop(this);
+  }
+}
+
+void
+UnixNetVConnection::set_active_timeout(ink_hrtime timeout_in)
+{
+  Dbg(dbg_ctl_socket, "Set active timeout=%" PRId64 ", NetVC=%p", timeout_in, this);
+  active_timeout_in        = timeout_in;
+  next_activity_timeout_at = (active_timeout_in > 0) ? ink_get_hrtime() + timeout_in : 0;
+  if (nh && next_activity_timeout_at) {
+    nh->retime_cop(this);
+  }
 }
 
 TS_INLINE void
@@ -0,0 +1,171 @@
+/**
+   @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "mgmt/rpc/handlers/eventloop/Profile.h"
+#include "mgmt/rpc/handlers/common/ErrorUtils.h"
+
+#include "iocore/eventsystem/EThread.h"
+#include "iocore/eventsystem/EventProcessor.h"
+#include "tscore/Diags.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace
+{
+DbgCtl dbg_ctl_rpc_handler_eventloop{"rpc.handler.eventloop"};
+
+/// Where the time of a profile entry goes in a flame graph.
+struct Frames {
+  std::string plugin;  ///< Shared object of the handler, empty for the core.
+  std::string handler; ///< Handler function, or the continuation type if that is not known.
+};
+
+std::string
+demangle(char const *name)
+{
+  int         status    = 0;
+  char       *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  std::string text{status == 0 ? demangled : name};
+  free(demangled);
+  return text;
+}
+
+/// Drop the parameter list of a demangled function name.
+void
+strip_parameters(std::string &name)
+{
+  if (name.empty() || name.back() != ')') {
+    return;
+  }
+  int depth = 0;
+  for (size_t i = name.size(); i-- > 0;) {
+    if (name[i] == ')') {
+      ++depth;
+    } else if (name[i] == '(' && --depth == 0) {
+      name.resize(i);
+      return;
+    }
+  }
+}
+
+Frames
+resolve(std::type_info const *type, void const *target)
+{
+  static Dl_info core;
+  static bool    have_core = dladdr(reinterpret_cast<void const *>(&resolve), &core) != 0;
+
+  Frames  frames;
+  Dl_info info;
+  if (target && dladdr(target, &info)) {
+    if (info.dli_fname && !(have_core && info.dli_fbase == core.dli_fbase)) {
+      std::string_view path{info.dli_fname};
+      path          = path.substr(path.rfind('/') + 1);
+      frames.plugin = path.substr(0, path.find('.'));
+    }
+    if (info.dli_sname) {
+      frames.handler = demangle(info.dli_sname);
+      strip_parameters(frames.handler);
+    }
+  }
+  if (frames.handler.empty()) {
+    frames.handler = demangle(type->name());
+  }
+  Dbg(dbg_ctl_rpc_handler_eventloop, "%p of %s is %s;%s", target, type->name(), frames.plugin.c_str(), frames.handler.c_str());
+  return frames;
+}
+} // end anonymous namespace
+
+namespace rpc::handlers::eventloop
+{
+namespace err = rpc::handlers::errors;
+
+swoc::Rv<YAML::Node>
+get_continuation_profile(std::string_view const & /* id ATS_UNUSED */, YAML::Node const & /* params ATS_UNUSED */)
+{
+  // Resolving symbols is slow and the same handlers show up every time.
+  static std::mutex                                                        names_mutex;
+  static std::map<std::pair<std::type_info const *, void const *>, Frames> names;
+
+  swoc::Rv<YAML::Node> resp;
+  try {
+    std::lock_guard lock(names_mutex);
+    YAML::Node      threads{YAML::NodeType::Sequence};
+    std::string     folded;
+
+    for (int group = 0; group < eventProcessor.n_thread_groups; ++group) {
+      int idx = 0;
+      for (EThread *t : eventProcessor.active_group_threads(group)) {
+        std::string name = eventProcessor.thread_group[group]._name + " " + std::to_string(idx++);
+
+        // Entries that resolve to the same frames are merged.
+        std::map<std::pair<std::string, std::string>, std::pair<uint64_t, uint64_t>> handlers;
+        for (auto &e : t->profile._entry) {
+          auto type = e._type.load(std::memory_order_acquire);
+          if (!type) {
+            continue;
+          }
+          auto key           = std::make_pair(type, e._target.load(std::memory_order_relaxed));
+          auto [spot, added] = names.try_emplace(key);
+          if (added) {
+            spot->second = resolve(key.first, key.second);
+          }
+          auto &[samples, nsec]  = handlers[std::make_pair(spot->second.plugin, spot->second.handler)];
+          samples               += e._samples.load(std::memory_order_relaxed);
+          nsec                  += e._nsec.load(std::memory_order_relaxed);
+        }
+
+        YAML::Node thread;
+        thread["name"]     = name;
+        thread["dropped"]  = t->profile._dropped.load(std::memory_order_relaxed);
+        thread["handlers"] = YAML::Node{YAML::NodeType::Sequence};
+        for (auto &[frames, counts] : handlers) {
+          YAML::Node handler;
+          handler["plugin"]  = frames.first;
+          handler["handler"] = frames.second;
+          handler["samples"] = counts.first;
+          handler["usec"]    = counts.second / 1000;
+          thread["handlers"].push_back(handler);
+
+          folded += name + ";";
+          if (!frames.first.empty()) {
+            folded += frames.first + ";";
+          }
+          folded += frames.second + " " + std::to_string(counts.second / 1000) + "\n";
+        }
+        threads.push_back(thread);
+      }
+    }
+
+    resp.result()["sample_rate"] = EThread::profile_sample_rate;
+    resp.result()["threads"]     = threads;
+    resp.result()["folded"]      = folded;
+  } catch (std::exception const &ex) {
+    resp.errata()
+      .assign(std::error_code{errors::Codes::SERVER})
+      .note("Error found when calling get_continuation_profile API: {}", ex.what());
+  }
+  return resp;
+}
+} // namespace rpc::handlers::eventloop
@@ -2022,6 +2022,7 @@ HTTPCacheAlt::destroy()
   m_request_hdr.destroy();
   m_response_hdr.destroy();
   m_frag_offset_count = 0;
+  m_frag_sparse       = 0;
   if (m_frag_offsets && m_frag_offsets != m_integral_frag_offsets) {
     ats_free(m_frag_offsets);
     m_frag_offsets = nullptr;
@@ -2058,22 +2059,24 @@ void
 HTTPCacheAlt::copy_frag_offsets_from(HTTPCacheAlt *src)
 {
   m_frag_offset_count = src->m_frag_offset_count;
-  if (m_frag_offset_count > 0) {
-    if (m_frag_offset_count > N_INTEGRAL_FRAG_OFFSETS) {
+  m_frag_sparse       = src->m_frag_sparse;
+  int table_size      = this->frag_table_size();
+  if (table_size > 0) {
+    if (table_size > N_INTEGRAL_FRAG_OFFSETS) {
       /* Mixed feelings about this - technically we don't need it to be a
          power of two when copied because currently that means it is frozen.
          But that could change later and it would be a nasty bug to find.
          So we'll do it for now. The relative overhead is tiny.
       */
       int bcount = HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS * 2;
-      while (bcount < m_frag_offset_count) {
+      while (bcount < table_size) {
         bcount *= 2;
       }
       m_frag_offsets = static_cast<FragOffset *>(ats_malloc(sizeof(FragOffset) * bcount));
     } else {
       m_frag_offsets = m_integral_frag_offsets;
     }
-    memcpy(m_frag_offsets, src->m_frag_offsets, sizeof(FragOffset) * m_frag_offset_count);
+    memcpy(m_frag_offsets, src->m_frag_offsets, sizeof(FragOffset) * table_size);
   }
 }
 
@@ -2117,8 +2120,8 @@ HTTPInfo::marshal_length()
     len += m_alt->m_response_hdr.m_heap->marshal_length();
   }
 
-  if (m_alt->m_frag_offset_count > HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS) {
-    len += sizeof(FragOffset) * m_alt->m_frag_offset_count;
+  if (m_alt->frag_table_size() > HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS) {
+    len += sizeof(FragOffset) * m_alt->frag_table_size();
   }
 
   return len;
@@ -2149,11 +2152,12 @@ HTTPInfo::marshal(char *buf, int len)
   buf                          += HTTP_ALT_MARSHAL_SIZE;
   used                         += HTTP_ALT_MARSHAL_SIZE;
 
-  if (m_alt->m_frag_offset_count > HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS) {
+  int table_size = m_alt->frag_table_size();
+  if (table_size > HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS) {
     marshal_alt->m_frag_offsets = static_cast<FragOffset *>(reinterpret_cast<void *>(used));
-    memcpy(buf, m_alt->m_frag_offsets, m_alt->m_frag_offset_count * sizeof(FragOffset));
-    buf  += m_alt->m_frag_offset_count * sizeof(FragOffset);
-    used += m_alt->m_frag_offset_count * sizeof(FragOffset);
+    memcpy(buf, m_alt->m_frag_offsets, table_size * sizeof(FragOffset));
+    buf  += table_size * sizeof(FragOffset);
+    used += table_size * sizeof(FragOffset);
   } else {
     marshal_alt->m_frag_offsets = nullptr;
   }
@@ -2211,11 +2215,11 @@ HTTPInfo::unmarshal(char *buf, int len, RefCountObj *block_ref)
   ink_assert(alt->m_writeable == 0);
   len -= HTTP_ALT_MARSHAL_SIZE;
 
-  if (alt->m_frag_offset_count > HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS) {
+  if (alt->frag_table_size() > HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS) {
     alt->m_frag_offsets  = reinterpret_cast<FragOffset *>(buf + reinterpret_cast<intptr_t>(alt->m_frag_offsets));
-    len                 -= sizeof(FragOffset) * alt->m_frag_offset_count;
+    len                 -= sizeof(FragOffset) * alt->frag_table_size();
     ink_assert(len >= 0);
-  } else if (alt->m_frag_offset_count > 0) {
+  } else if (alt->frag_table_size() > 0) {
     alt->m_frag_offsets = alt->m_integral_frag_offsets;
   } else {
     alt->m_frag_offsets = nullptr; // should really already be zero.
@@ -2276,7 +2280,9 @@ HTTPInfo::unmarshal_v24_1(char *buf, int len, RefCountObj *block_ref)
   ink_assert(alt->m_unmarshal_len < 0);
   alt->m_magic = CacheAltMagic::ALIVE;
   ink_assert(alt->m_writeable == 0);
-  len -= HTTP_ALT_MARSHAL_SIZE;
+  // This was padding, objects of this version are never sparse.
+  alt->m_frag_sparse  = 0;
+  len                -= HTTP_ALT_MARSHAL_SIZE;
 
   if (alt->m_frag_offset_count > HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS) {
     // stuff that didn't fit in the integral slots.
@@ -2337,6 +2343,19 @@ HTTPInfo::unmarshal_v24_1(char *buf, int len, RefCountObj *block_ref)
   return alt->m_unmarshal_len;
 }
 
+int
+HTTPInfo::unmarshal_v24_2(char *buf, int len, RefCountObj *block_ref)
+{
+  HTTPCacheAlt *alt = reinterpret_cast<HTTPCacheAlt *>(buf);
+
+  // The sparse flag was padding in this version, clear it before it is used
+  // to size the fragment table.
+  if (alt->m_magic == CacheAltMagic::MARSHALED) {
+    alt->m_frag_sparse = 0;
+  }
+  return unmarshal(buf, len, block_ref);
+}
+
 // bool HTTPInfo::check_marshalled(char* buf, int len)
 //  Checks a marhshalled HTTPInfo buffer to make
 //    sure it's sane.  Returns true if sane, false otherwise
@@ -2442,6 +2461,7 @@ void
 HTTPInfo::push_frag_offset(FragOffset offset)
 {
   ink_assert(m_alt);
+  ink_assert(!m_alt->m_frag_sparse); // the table of a sparse object is complete from the start
   if (nullptr == m_alt->m_frag_offsets) {
     m_alt->m_frag_offsets = m_alt->m_integral_frag_offsets;
   } else if (m_alt->m_frag_offset_count >= HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS &&
@@ -2458,3 +2478,87 @@ HTTPInfo::push_frag_offset(FragOffset offset)
 
   m_alt->m_frag_offsets[m_alt->m_frag_offset_count++] = offset;
 }
+
+int64_t
+HTTPInfo::get_frag_length(int idx)
+{
+  int count = this->get_frag_offset_count();
+
+  if (idx < 0 || idx > count) {
+    return 0;
+  }
+
+  FragOffset *frags = this->get_frag_table();
+  int64_t     start = idx > 0 ? frags[idx - 1] : 0;
+  int64_t     end   = idx < count ? static_cast<int64_t>(frags[idx]) : this->object_size_get();
+  return end - start;
+}
+
+void
+HTTPInfo::init_sparse_frags(int64_t object_size, int64_t frag_size)
+{
+  ink_assert(m_alt && m_alt->m_writeable);
+  ink_assert(frag_size > 0 && object_size > frag_size);
+
+  if (m_alt->m_frag_offsets && m_alt->m_frag_offsets != m_alt->m_integral_frag_offsets) {
+    ats_free(m_alt->m_frag_offsets);
+  }
+  m_alt->m_frag_offset_count = static_cast<int>((object_size - 1) / frag_size);
+  m_alt->m_frag_sparse       = 1;
+
+  int table_size = m_alt->frag_table_size();
+  if (table_size > HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS) {
+    m_alt->m_frag_offsets = static_cast<FragOffset *>(ats_malloc(sizeof(FragOffset) * table_size));
+  } else {
+    m_alt->m_frag_offsets = m_alt->m_integral_frag_offsets;
+  }
+  for (int i = 0; i < m_alt->m_frag_offset_count; ++i) {
+    m_alt->m_frag_offsets[i] = (i + 1) * frag_size;
+  }
+  memset(m_alt->m_frag_offsets + m_alt->m_frag_offset_count, 0, sizeof(FragOffset) * m_alt->frag_present_words());
+  this->object_size_set(object_size);
+}
+
+void
+HTTPInfo::mark_frag_present(int idx)
+{
+  ink_assert(this->is_sparse());
+  ink_assert(idx >= 0 && idx <= m_alt->m_frag_offset_count);
+
+  FragOffset *present  = m_alt->m_frag_offsets + m_alt->m_frag_offset_count;
+  present[idx / 64]   |= FragOffset{1} << (idx % 64);
+}
+
+bool
+HTTPInfo::is_frag_present(int idx)
+{
+  if (!this->is_sparse()) {
+    return true;
+  }
+  if (idx < 0 || idx > m_alt->m_frag_offset_count) {
+    return false;
+  }
+
+  FragOffset *present = m_alt->m_frag_offsets + m_alt->m_frag_offset_count;
+  return (present[idx / 64] >> (idx % 64)) & 1;
+}
+
+bool
+HTTPInfo::is_range_present(int64_t start, int64_t end)
+{
+  if (!this->is_sparse()) {
+    return true;
+  }
+  if (start < 0 || end < start || end >= this->object_size_get()) {
+    return false;
+  }
+
+  // All fragments but the last have the size of the first.
+  int64_t frag_size = m_alt->m_frag_offsets[0];
+  for (int64_t idx = start / frag_size; idx <= end / frag_size; ++idx) {
+    if (!this->is_frag_present(static_cast<int>(idx))) {
+      return false;
+    }
+  }
+  return true;
+}
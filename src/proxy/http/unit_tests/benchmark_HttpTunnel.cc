@@ -0,0 +1,146 @@
+/** @file
+
+  Microbenchmark for the copying done by the tunnel, with and without the huge page arena
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+/*
+  Dechunks a body of small chunks with the ChunkedHandler of the tunnel.
+  Chunks below the block transfer threshold are copied into the dechunked
+  buffer instead of being referenced, so the body is copied twice, once into
+  the producer buffer and once out of it. The body is large enough that its
+  buffers are well past what the TLB covers with normal pages.
+
+  The IO buffer allocators are set up again between the cases, first without
+  and then with proxy.config.allocator.iobuf_arena. Without reserved huge
+  pages the arena falls back to transparent huge pages, which is reported at
+  the end.
+
+  This is not run by ctest, run benchmark_HttpTunnel directly.
+*/
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/reporters/catch_reporter_event_listener.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+
+#include "tscore/Layout.h"
+#include "tscore/hugepages.h"
+
+#include "iocore/eventsystem/EventSystem.h"
+#include "records/RecordsConfig.h"
+#include "proxy/http/HttpTunnel.h"
+
+#include "iocore/utils/diags.i"
+
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+
+namespace
+{
+
+constexpr int64_t CHUNK_SIZE = 200;      // Below the block transfer threshold, so copied.
+constexpr int64_t BODY_SIZE  = 32 << 20; // Bytes of dechunked body.
+
+std::string const chunk = [] {
+  char header[16];
+  int  len = snprintf(header, sizeof(header), "%" PRIx64 "\r\n", CHUNK_SIZE);
+  return std::string(header, len) + std::string(CHUNK_SIZE, 'x') + "\r\n";
+}();
+
+void
+setup_buffers(bool use_arena)
+{
+  // Everything is back in the free lists between cases, so the allocators can be replaced.
+  int chunk_sizes[DEFAULT_BUFFER_SIZES] = {0};
+
+  if (use_arena && !ats_hugepage_arena_enabled()) {
+    ats_hugepage_arena_init(2 << 20, 64 << 20);
+  }
+  init_buffer_allocators(0, chunk_sizes, false, use_arena);
+}
+
+int64_t
+dechunk_body()
+{
+  MIOBuffer      *in     = new_MIOBuffer(BUFFER_SIZE_INDEX_32K);
+  IOBufferReader *reader = in->alloc_reader();
+  ChunkedHandler  handler;
+
+  for (int64_t n = 0; n < BODY_SIZE; n += CHUNK_SIZE) {
+    in->write(chunk.data(), chunk.size());
+  }
+  in->write("0\r\n\r\n", 5);
+
+  handler.init_by_action(reader, ChunkedHandler::Action::DECHUNK, false, true);
+  handler.dechunked_reader = handler.dechunked_buffer->alloc_reader();
+  handler.state            = ChunkedHandler::ChunkedState::READ_SIZE;
+  handler.process_chunked_content();
+
+  int64_t size = handler.dechunked_size;
+  handler.clear();
+  free_MIOBuffer(in);
+  return size;
+}
+
+} // end anonymous namespace
+
+TEST_CASE("tunnel dechunking small chunks", "[http][bench]")
+{
+  setup_buffers(false);
+  REQUIRE(dechunk_body() >= BODY_SIZE);
+  BENCHMARK("normal pages")
+  {
+    return dechunk_body();
+  };
+
+  setup_buffers(true);
+  BENCHMARK("huge page arena")
+  {
+    return dechunk_body();
+  };
+
+  HugepageArenaStats stats = ats_hugepage_arena_stats();
+  printf("arena: %zu bytes of huge pages, %zu bytes of normal pages, %zu bytes used\n", stats.hugepage_bytes,
+         stats.fallback_bytes, stats.used_bytes);
+}
+
+struct EventProcessorListener : Catch::EventListenerBase {
+  using EventListenerBase::EventListenerBase;
+
+  void
+  testRunStarting(Catch::TestRunInfo const & /* testRunInfo ATS_UNUSED */) override
+  {
+    Layout::create();
+    init_diags("", nullptr);
+    RecProcessInit();
+    LibRecordsConfigInit();
+
+    ink_event_system_init(EVENT_SYSTEM_MODULE_PUBLIC_VERSION);
+    eventProcessor.start(1);
+
+    EThread *main_thread = new EThread;
+    main_thread->set_specific();
+  }
+};
+
+CATCH_REGISTER_LISTENER(EventProcessorListener);
@@ -0,0 +1,604 @@
+/** @file
+
+  Offline analysis and compaction of cache stripes.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "CacheAnalyze.h"
+#include "proxy/hdrs/HTTP.h"
+
+#include <algorithm>
+#include <bit>
+#include <bitset>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <vector>
+
+using ts::make_errno_code;
+
+extern int OPEN_RW_FLAG;
+
+namespace
+{
+// Enough for the Doc and the first alternate of an HTTP object.
+constexpr ssize_t DOC_HEADER_READ_SIZE = 4096;
+
+void
+json_string(std::ostream &s, std::string_view str)
+{
+  s << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      s << '\\';
+    }
+    s << c;
+  }
+  s << '"';
+}
+
+/// Documents at one stripe offset and where they are moved to.
+struct Extent {
+  int64_t                      size = 0; ///< Bytes, a multiple of CACHE_BLOCK_SIZE.
+  int64_t                      to   = 0; ///< New directory offset.
+  std::vector<CacheDirEntry *> entries;
+};
+
+// MAX_STRIPE_SIZE and the largest directory offset with compact entries.
+constexpr int64_t COMPACT_MAX_STRIPE_SIZE = int64_t(8) << 30;
+constexpr int64_t COMPACT_DIR_OFFSET_MAX  = (int64_t(1) << 24) - 1;
+
+/// Word access to a directory with entries of @a size bytes, whatever the size of @c CacheDirEntry.
+struct DirWords {
+  char   *base;
+  int     size;
+  int64_t buckets; ///< Per segment.
+
+  uint16_t *
+  entry(int64_t s, int64_t i) const
+  {
+    return reinterpret_cast<uint16_t *>(base + (s * buckets * DIR_DEPTH + i) * size);
+  }
+
+  // The layouts differ only in the offset_high word of the larger one.
+  int64_t
+  offset(uint16_t const *w) const
+  {
+    int64_t o = w[0] | (static_cast<int64_t>(w[1] & 0xFF) << 16);
+    return size == ts::CLASSIC_SIZEOF_DIR ? o | (static_cast<int64_t>(w[4]) << 24) : o;
+  }
+};
+} // namespace
+
+namespace ct
+{
+void
+Log2Histogram::add(uint64_t value)
+{
+  ++_count[std::bit_width(value)];
+}
+
+void
+Log2Histogram::merge(Log2Histogram const &that)
+{
+  for (size_t i = 0; i < _count.size(); ++i) {
+    _count[i] += that._count[i];
+  }
+}
+
+void
+Log2Histogram::json(std::ostream &s) const
+{
+  const char *sep = "";
+  s << '[';
+  for (size_t i = 0; i < _count.size(); ++i) {
+    if (_count[i]) {
+      uint64_t le = i < 64 ? (uint64_t(1) << i) - 1 : UINT64_MAX;
+      s << sep << "{\"le\": " << le << ", \"count\": " << _count[i] << '}';
+      sep = ", ";
+    }
+  }
+  s << ']';
+}
+
+void
+StripeStats::merge(StripeStats const &that)
+{
+  entries       += that.entries;
+  objects       += that.objects;
+  live_bytes    += that.live_bytes;
+  stale_entries += that.stale_entries;
+  loops         += that.loops;
+  read_errors   += that.read_errors;
+  bad_docs      += that.bad_docs;
+  object_size.merge(that.object_size);
+  object_age.merge(that.object_age);
+  fragments.merge(that.fragments);
+}
+
+Errata
+CacheAnalyze::Analyze(int n_threads)
+{
+  Errata zret = stripe->loadMeta();
+  if (zret.length()) {
+    return zret;
+  }
+  stripe->mapDir();
+
+  n_threads = std::clamp<int>(n_threads, 1, std::max<int64_t>(stripe->_segments, 1));
+  std::vector<StripeStats> partial(n_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < n_threads; ++t) {
+    threads.emplace_back(&CacheAnalyze::analyze_segments, this, t, n_threads, std::ref(partial[t]));
+  }
+  for (auto &th : threads) {
+    th.join();
+  }
+  for (auto const &p : partial) {
+    stats.merge(p);
+  }
+
+  stripe->unmapDir();
+  return zret;
+}
+
+void
+CacheAnalyze::analyze_segments(int first, int step, StripeStats &out)
+{
+  char              *buf = static_cast<char *>(ats_memalign(ats_pagesize(), DOC_HEADER_READ_SIZE));
+  time_t             now = time(nullptr);
+  std::bitset<65536> seen;
+
+  for (int s = first; s < stripe->_segments; s += step) {
+    CacheDirEntry *seg = stripe->dir_segment(s);
+    seen.reset();
+    for (int b = 0; b < stripe->_buckets; b++) {
+      CacheDirEntry *e = dir_bucket(b, seg);
+      if (!dir_offset(e)) {
+        continue;
+      }
+      for (; e; e = next_dir(e, seg)) {
+        int64_t i = dir_to_offset(e, seg);
+        if (seen[i]) {
+          ++out.loops;
+          break;
+        }
+        seen[i] = true;
+        if (!dir_offset(e)) {
+          continue;
+        }
+        if (!stripe->dir_valid(e)) {
+          ++out.stale_entries;
+          continue;
+        }
+        ++out.entries;
+        out.live_bytes += dir_approx_size(e);
+        if (!dir_head(e)) {
+          continue;
+        }
+
+        // The first fragment of each alternate is also a head, only the doc
+        // with the object headers counts as an object.
+        ssize_t n = pread(stripe->_span->_fd, buf, DOC_HEADER_READ_SIZE, stripe->stripe_offset(e));
+        if (n < static_cast<ssize_t>(sizeof(Doc))) {
+          ++out.read_errors;
+          continue;
+        }
+        Doc *doc = reinterpret_cast<Doc *>(buf);
+        if (doc->magic != Doc::MAGIC || dir_tag(e) != DIR_MASK_TAG(doc->key.slice32(2))) {
+          ++out.bad_docs;
+          continue;
+        }
+        if (doc->hlen == 0) {
+          continue;
+        }
+        ++out.objects;
+
+        uint64_t size  = doc->total_len;
+        uint64_t frags = 1;
+        if (!doc->single_fragment() && doc->data_len() > 0) {
+          frags = (doc->total_len + doc->data_len() - 1) / doc->data_len();
+        }
+        // HTTP objects keep their size, fragment table and age in the
+        // alternate, use the first one.
+        if (doc->hlen >= sizeof(HTTPCacheAlt) && sizeof(Doc) + sizeof(HTTPCacheAlt) <= static_cast<size_t>(n)) {
+          HTTPCacheAlt *alt = reinterpret_cast<HTTPCacheAlt *>(doc->hdr());
+          if (alt->m_magic == CacheAltMagic::MARSHALED) {
+            int64_t object_size;
+            memcpy(&object_size, alt->m_object_size, sizeof(object_size));
+            size  = object_size;
+            frags = alt->m_frag_offset_count + 1;
+            if (alt->m_response_received_time > 0 && alt->m_response_received_time <= now) {
+              out.object_age.add(now - alt->m_response_received_time);
+            }
+          }
+        }
+        out.object_size.add(size);
+        out.fragments.add(frags);
+      }
+    }
+  }
+  ats_free(buf);
+}
+
+void
+CacheAnalyze::json(std::ostream &s) const
+{
+  StripeMeta const &meta = stripe->_meta[StripeSM::A][StripeSM::HEAD];
+
+  int64_t content_bytes = stripe->_start.count() + stripe->_len.count() * CacheStoreBlocks::SCALE - stripe->_content.count();
+  // Until the stripe wraps only the part before the write position holds data.
+  int64_t written_bytes = meta.cycle ? content_bytes : meta.write_pos - stripe->_content.count();
+  double  fragmentation = 0;
+  if (written_bytes > 0) {
+    fragmentation = std::clamp(1.0 - static_cast<double>(stats.live_bytes) / written_bytes, 0.0, 1.0);
+  }
+
+  s << "{\"stripe\": ";
+  json_string(s, stripe->hashText);
+  s << ", \"content_bytes\": " << content_bytes;
+  s << ", \"written_bytes\": " << written_bytes;
+  s << ", \"live_bytes\": " << stats.live_bytes;
+  s << ", \"fragmentation\": " << fragmentation;
+  s << ", \"entries\": " << stats.entries;
+  s << ", \"objects\": " << stats.objects;
+  s << ", \"stale_entries\": " << stats.stale_entries;
+  s << ", \"loops\": " << stats.loops;
+  s << ", \"read_errors\": " << stats.read_errors;
+  s << ", \"bad_docs\": " << stats.bad_docs;
+  s << ", \"object_size\": ";
+  stats.object_size.json(s);
+  s << ", \"object_age\": ";
+  stats.object_age.json(s);
+  s << ", \"fragments\": ";
+  stats.fragments.json(s);
+  s << '}';
+}
+
+Errata
+CacheAnalyze::Compact()
+{
+  Errata zret = stripe->loadMeta();
+  if (zret.length()) {
+    return zret;
+  }
+  auto &meta = stripe->_meta;
+  if (!clean_copy_a()) {
+    return Errata("Stripe {} was not shut down cleanly, start and stop the cache once before compacting it", stripe->hashText);
+  }
+  StripeMeta &header = meta[StripeSM::A][StripeSM::HEAD];
+  stripe->mapDir();
+  // drop the entries the write cursor has passed
+  stripe->walk_all_buckets();
+
+  // Documents written since the last wrap, and the older ones past the write position.
+  std::map<int64_t, Extent> newer, older;
+  std::bitset<65536>        seen;
+  for (int s = 0; s < stripe->_segments; s++) {
+    CacheDirEntry *seg = stripe->dir_segment(s);
+    seen.reset();
+    for (int b = 0; b < stripe->_buckets; b++) {
+      for (CacheDirEntry *e = dir_bucket(b, seg); e && dir_offset(e); e = next_dir(e, seg)) {
+        int64_t i = dir_to_offset(e, seg);
+        if (seen[i]) {
+          break;
+        }
+        seen[i]   = true;
+        Extent &x = (dir_phase(e) == header.phase ? newer : older)[dir_offset(e)];
+        x.size    = std::max<int64_t>(x.size, dir_approx_size(e));
+        x.entries.push_back(e);
+      }
+    }
+  }
+
+  // Plan the moves before doing any, so that overlapping documents leave the stripe untouched.
+  int64_t write_block = (header.write_pos - stripe->_content.count()) / CACHE_BLOCK_SIZE + 1;
+  int64_t cursor      = 1;
+  int64_t moved       = 0;
+  int64_t end         = 0;
+  int64_t max_size    = 0;
+  for (auto &[offset, x] : newer) {
+    if (offset < end || offset + x.size / CACHE_BLOCK_SIZE > write_block) {
+      stripe->unmapDir();
+      return Errata("Stripe {} has overlapping documents at offset {}, not compacting it", stripe->hashText, offset);
+    }
+    end     = offset + x.size / CACHE_BLOCK_SIZE;
+    x.to    = cursor;
+    cursor += x.size / CACHE_BLOCK_SIZE;
+  }
+  int64_t top = 0;
+  for (auto const &[offset, x] : older) {
+    if (offset < top || offset < write_block) {
+      stripe->unmapDir();
+      return Errata("Stripe {} has overlapping documents at offset {}, not compacting it", stripe->hashText, offset);
+    }
+    top = offset + x.size / CACHE_BLOCK_SIZE;
+  }
+  for (auto it = older.rbegin(); it != older.rend(); ++it) {
+    top           -= it->second.size / CACHE_BLOCK_SIZE;
+    it->second.to  = top;
+  }
+  for (auto const *region : {&newer, &older}) {
+    for (auto const &[offset, x] : *region) {
+      if (x.to != offset) {
+        moved    += x.size;
+        max_size  = std::max(max_size, x.size);
+      }
+    }
+  }
+
+  std::cout << "Stripe " << stripe->hashText << ": " << newer.size() + older.size() << " documents, " << moved
+            << " bytes to move, write position " << (write_block - 1) * CACHE_BLOCK_SIZE << " -> "
+            << (cursor - 1) * CACHE_BLOCK_SIZE << std::endl;
+  if (!moved) {
+    stripe->unmapDir();
+    return zret;
+  }
+  if (!OPEN_RW_FLAG) {
+    stripe->unmapDir();
+    zret.note("Writing Not Enabled.. Please use --write to enable writing to disk");
+    return zret;
+  }
+
+  // In place: newer documents only move down and are moved lowest first,
+  // older ones only move up and are moved highest first.
+  int   fd  = stripe->_span->_fd;
+  char *buf = static_cast<char *>(ats_memalign(ats_pagesize(), max_size));
+  auto  move = [&](int64_t from, Extent &x) -> bool {
+    if (x.to != from) {
+      off_t src = stripe->_content.count() + (from - 1) * CACHE_BLOCK_SIZE;
+      off_t dst = stripe->_content.count() + (x.to - 1) * CACHE_BLOCK_SIZE;
+      if (pread(fd, buf, x.size, src) < x.size || pwrite(fd, buf, x.size, dst) < x.size) {
+        return false;
+      }
+      for (auto e : x.entries) {
+        dir_set_offset(e, x.to);
+      }
+    }
+    return true;
+  };
+  bool ok = true;
+  for (auto it = newer.begin(); ok && it != newer.end(); ++it) {
+    ok = move(it->first, it->second);
+  }
+  for (auto it = older.rbegin(); ok && it != older.rend(); ++it) {
+    ok = move(it->first, it->second);
+  }
+  if (!ok) {
+    // Keep what was moved. The entries of a document damaged by the failed
+    // move still point at it, the cache drops them when the doc key does not
+    // match on the first read.
+    zret = Errata(make_errno_code(), "Failed to move documents in stripe {}", stripe->hashText);
+  } else {
+    if (cursor < write_block) {
+      // Clear the first document after the write position so that recovery
+      // at startup does not mistake a moved copy for a write after the last sync.
+      int64_t n = std::min({(write_block - cursor) * CACHE_BLOCK_SIZE, int64_t(CacheStoreBlocks::SCALE), max_size});
+      memset(buf, 0, n);
+      if (pwrite(fd, buf, n, stripe->_content.count() + (cursor - 1) * CACHE_BLOCK_SIZE) < n) {
+        zret = Errata(make_errno_code(), "Failed to clear the write position of stripe {}", stripe->hashText);
+      }
+    }
+    header.write_pos      = stripe->_content.count() + (cursor - 1) * CACHE_BLOCK_SIZE;
+    header.agg_pos        = header.write_pos;
+    header.last_write_pos = header.write_pos;
+  }
+  ats_free(buf);
+
+  header.dirty = 0;
+  for (auto i : {StripeSM::A, StripeSM::B}) {
+    for (auto j : {StripeSM::HEAD, StripeSM::FOOT}) {
+      meta[i][j] = header;
+    }
+  }
+  if (Errata werr = stripe->writeMeta(); !werr.is_ok()) {
+    zret = std::move(werr);
+  }
+  stripe->unmapDir();
+  return zret;
+}
+
+bool
+CacheAnalyze::clean_copy_a() const
+{
+  auto &head = stripe->_meta[StripeSM::A];
+  auto &tail = stripe->_meta[StripeSM::B];
+  if (!stripe->_meta_pos[StripeSM::B][StripeSM::FOOT] || head[StripeSM::HEAD].sync_serial != head[StripeSM::FOOT].sync_serial ||
+      (tail[StripeSM::HEAD].sync_serial == tail[StripeSM::FOOT].sync_serial &&
+       tail[StripeSM::HEAD].sync_serial > head[StripeSM::HEAD].sync_serial)) {
+    return false;
+  }
+  return true;
+}
+
+Errata
+CacheAnalyze::ConvertDir()
+{
+  using ts::CLASSIC_SIZEOF_DIR;
+  using ts::COMPACT_SIZEOF_DIR;
+
+  // Computed as the cache does, starting from the start of the stripe.
+  auto geometry = [this](int entry_size) {
+    stripe->_dir_entry_size = entry_size;
+    stripe->_content        = stripe->_start;
+    stripe->vol_init_data();
+  };
+
+  geometry(CLASSIC_SIZEOF_DIR);
+  Errata zret = stripe->loadMeta();
+  if (zret.length()) {
+    return zret;
+  }
+  StripeMeta header = stripe->_meta[StripeSM::A][StripeSM::HEAD];
+  if (header.dir_entry_size == COMPACT_SIZEOF_DIR) {
+    std::cout << "Stripe " << stripe->hashText << " already has compact directory entries" << std::endl;
+    return zret;
+  }
+  if (!clean_copy_a()) {
+    return Errata("Stripe {} was not shut down cleanly, start and stop the cache once before converting it", stripe->hashText);
+  }
+
+  int64_t from_segments = stripe->_segments;
+  int64_t from_buckets  = stripe->_buckets;
+  Bytes   from_content  = stripe->_content;
+  size_t  from_len      = stripe->vol_dirlen();
+  geometry(COMPACT_SIZEOF_DIR);
+  int64_t to_segments = stripe->_segments;
+  int64_t to_buckets  = stripe->_buckets;
+  Bytes   to_content  = stripe->_content;
+  size_t  to_len      = stripe->vol_dirlen();
+  geometry(CLASSIC_SIZEOF_DIR);
+
+  // Only one copy of the directory is kept in memory.
+  std::cout << "Stripe " << stripe->hashText << ": directory of " << from_len << " bytes, " << to_len
+            << " bytes with compact entries, saving " << from_len - to_len << " bytes of memory" << std::endl;
+  if (stripe->_len.count() * CacheStoreBlocks::SCALE > COMPACT_MAX_STRIPE_SIZE) {
+    zret.note("Stripe {} is larger than {} bytes, the cache clears it rather than using compact entries", stripe->hashText,
+              COMPACT_MAX_STRIPE_SIZE);
+    return zret;
+  }
+  if (!OPEN_RW_FLAG) {
+    zret.note("Writing Not Enabled.. Please use --write to enable writing to disk");
+    return zret;
+  }
+
+  stripe->mapDir();
+  DirWords             from{reinterpret_cast<char *>(stripe->dir_segment(0)), CLASSIC_SIZEOF_DIR, from_buckets};
+  std::vector<char>    to_dir(ROUND_TO_STORE_BLOCK(to_buckets * DIR_DEPTH * to_segments * COMPACT_SIZEOF_DIR));
+  DirWords             to{to_dir.data(), COMPACT_SIZEOF_DIR, to_buckets};
+  std::vector<int64_t> spare(to_segments, 1); // where to look for an unused row in each segment
+  std::bitset<65536>   seen;
+
+  int64_t shift           = (from_content - to_content).count() / CACHE_BLOCK_SIZE;
+  int64_t in_phase_end    = (header.write_pos - from_content.count()) / CACHE_BLOCK_SIZE;
+  int64_t out_phase_start = (header.agg_pos - from_content.count()) / CACHE_BLOCK_SIZE;
+  int64_t converted = 0, stale = 0, dropped = 0;
+  char   *buf = static_cast<char *>(ats_memalign(ats_pagesize(), CACHE_BLOCK_SIZE));
+  for (int64_t s = 0; s < from_segments; s++) {
+    seen.reset();
+    for (int64_t b = 0; b < from_buckets; b++) {
+      // Same order as the chains, so entries for the same key keep their order.
+      int64_t i = b * DIR_DEPTH;
+      do {
+        if (seen[i]) {
+          break;
+        }
+        seen[i]             = true;
+        uint16_t const *e   = from.entry(s, i);
+        int64_t         off = from.offset(e);
+        i                   = e[3];
+        if (!off) {
+          continue;
+        }
+        if (((e[2] >> 12) & 1) == header.phase ? off - 1 >= in_phase_end : off - 1 < out_phase_start) {
+          ++stale;
+          continue;
+        }
+        Doc    *doc = reinterpret_cast<Doc *>(buf);
+        ssize_t n   = pread(stripe->_span->_fd, buf, CACHE_BLOCK_SIZE, from_content.count() + (off - 1) * CACHE_BLOCK_SIZE);
+        if (n < static_cast<ssize_t>(sizeof(Doc)) || doc->magic != Doc::MAGIC ||
+            (e[2] & ((1 << DIR_TAG_WIDTH) - 1)) != DIR_MASK_TAG(doc->key.slice32(2)) || off + shift > COMPACT_DIR_OFFSET_MAX) {
+          ++dropped;
+          continue;
+        }
+
+        // Placed as Directory::insert does: the bucket head, another row of
+        // the bucket, then any unused row, linked at the tail of the chain.
+        int64_t ts   = doc->key.slice32(0) % to_segments;
+        int64_t head = (doc->key.slice32(1) % to_buckets) * DIR_DEPTH;
+        int64_t j    = head;
+        if (to.offset(to.entry(ts, head))) {
+          j = 0;
+          for (int l = 1; l < DIR_DEPTH && !j; l++) {
+            if (!to.offset(to.entry(ts, head + l))) {
+              j = head + l;
+            }
+          }
+          for (int64_t &k = spare[ts]; !j && k < to_buckets * DIR_DEPTH; k++) {
+            if (k % DIR_DEPTH && !to.offset(to.entry(ts, k))) {
+              j = k;
+            }
+          }
+          if (!j) {
+            ++dropped;
+            continue;
+          }
+          int64_t tail = head;
+          while (to.entry(ts, tail)[3]) {
+            tail = to.entry(ts, tail)[3];
+          }
+          to.entry(ts, tail)[3] = j;
+        }
+        uint16_t *t = to.entry(ts, j);
+        t[0]        = static_cast<uint16_t>(off + shift);
+        t[1]        = static_cast<uint16_t>((e[1] & 0xFF00) | (((off + shift) >> 16) & 0xFF));
+        t[2]        = e[2];
+        t[3]        = 0;
+        ++converted;
+      } while (i);
+    }
+  }
+  ats_free(buf);
+  stripe->unmapDir();
+
+  // The unused rows are put on the freelist in the order dir_init_segment uses.
+  uint16_t *freelist = static_cast<uint16_t *>(malloc(to_segments * sizeof(uint16_t)));
+  for (int64_t s = 0; s < to_segments; s++) {
+    freelist[s] = 0;
+    for (int l = 1; l < DIR_DEPTH; l++) {
+      for (int64_t b = 0; b < to_buckets; b++) {
+        int64_t   i = b * DIR_DEPTH + l;
+        uint16_t *t = to.entry(s, i);
+        if (to.offset(t)) {
+          continue;
+        }
+        t[3] = freelist[s];
+        if (freelist[s]) {
+          to.entry(s, freelist[s])[2] = i;
+        }
+        freelist[s] = i;
+      }
+    }
+  }
+  free(stripe->freelist);
+  stripe->freelist = freelist;
+
+  geometry(COMPACT_SIZEOF_DIR);
+  stripe->dir           = reinterpret_cast<CacheDirEntry *>(to_dir.data());
+  header.dir_entry_size = COMPACT_SIZEOF_DIR;
+  header.dirty          = 0;
+  for (auto i : {StripeSM::A, StripeSM::B}) {
+    for (auto j : {StripeSM::HEAD, StripeSM::FOOT}) {
+      stripe->_meta[i][j] = header;
+    }
+  }
+  Bytes footer_offset                          = Bytes(to_len - ROUND_TO_STORE_BLOCK(sizeof(StripeMeta)));
+  stripe->_meta_pos[StripeSM::A][StripeSM::HEAD] = round_down(stripe->_start);
+  stripe->_meta_pos[StripeSM::A][StripeSM::FOOT] = round_down(stripe->_start + footer_offset);
+  stripe->_meta_pos[StripeSM::B][StripeSM::HEAD] = round_down(stripe->_start + Bytes(to_len));
+  stripe->_meta_pos[StripeSM::B][StripeSM::FOOT] = round_down(stripe->_start + Bytes(to_len) + footer_offset);
+  zret                                           = stripe->writeMeta();
+  stripe->dir                                    = nullptr;
+
+  std::cout << "Stripe " << stripe->hashText << ": " << converted << " entries converted, " << stale << " stale and " << dropped
+            << " unusable entries dropped" << std::endl;
+  return zret;
+}
+} // namespace ct
@@ -0,0 +1,102 @@
+/** @file
+
+  Offline analysis and compaction of cache stripes.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <ostream>
+#include "CacheDefs.h"
+
+namespace ct
+{
+/// Counts of values in power of two buckets, bucket @c i holds values in [2^(i-1), 2^i).
+struct Log2Histogram {
+  std::array<uint64_t, 65> _count = {};
+
+  void add(uint64_t value);
+  void merge(Log2Histogram const &that);
+  void json(std::ostream &s) const;
+};
+
+/// What was found in one stripe.
+struct StripeStats {
+  uint64_t entries       = 0; ///< Valid directory entries.
+  uint64_t objects       = 0; ///< Entries that are the head of an object.
+  uint64_t live_bytes    = 0; ///< Approximate bytes referenced by valid entries.
+  uint64_t stale_entries = 0; ///< Entries that the write cursor has passed.
+  uint64_t loops         = 0; ///< Bucket chains cut short by a loop.
+  uint64_t read_errors   = 0; ///< Doc headers that could not be read.
+  uint64_t bad_docs      = 0; ///< Doc headers that did not match their entry.
+
+  Log2Histogram object_size; ///< Bytes.
+  Log2Histogram object_age;  ///< Seconds since the response was received.
+  Log2Histogram fragments;   ///< Fragments per object.
+
+  void merge(StripeStats const &that);
+};
+
+/** Analysis and compaction of a stripe, with the cache not running.
+
+    The directory is mapped rather than read so that analyzing a large
+    stripe does not need a copy of it in memory, and the doc headers are
+    read by several threads, each taking a share of the segments.
+ */
+class CacheAnalyze
+{
+  StripeSM   *stripe = nullptr;
+  StripeStats stats;
+
+public:
+  CacheAnalyze(StripeSM *str) : stripe(str) {}
+
+  /// Collect the stripe statistics using @a n_threads readers.
+  Errata Analyze(int n_threads);
+
+  /** Rewrite the stripe so that the data is contiguous.
+
+      The documents written since the last wrap are moved down to the start
+      of the stripe and the older ones up towards the end, keeping the
+      order in which they will be overwritten. The write position is set to
+      the end of the newer ones, so the free space is all in front of it.
+      Without --write only the savings are reported.
+   */
+  Errata Compact();
+
+  /** Convert the directory to the 8 byte entries of TS_USE_COMPACT_CACHE_DIR builds.
+
+      The directory memory saved is reported for each stripe. The compact
+      directory has its own geometry, so each entry is placed again using the
+      key in its doc header, with its offset moved to the earlier content
+      start. Entries that do not fit are dropped. Without --write only the
+      savings are reported.
+   */
+  Errata ConvertDir();
+
+  /// Write the statistics for the stripe as a JSON object.
+  void json(std::ostream &s) const;
+
+private:
+  bool clean_copy_a() const;
+  void analyze_segments(int first, int step, StripeStats &out);
+};
+} // namespace ct
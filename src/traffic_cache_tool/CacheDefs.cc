@@ -25,6 +25,7 @@
 
 #include <iostream>
 #include <fcntl.h>
+#include <sys/mman.h>
 
 #include "tscore/ink_assert.h"
 
@@ -270,7 +271,7 @@ StripeSM::validateMeta(StripeMeta const *meta)
 {
   // Need to be bit more robust at some point.
   return StripeMeta::MAGIC == meta->magic && meta->version._major <= ts::CACHE_DB_MAJOR_VERSION &&
-         meta->version._minor <= 2 // This may have always been zero, actually.
+         meta->version._minor <= 3 // This may have always been zero, actually.
     ;
 }
 
@@ -296,7 +297,6 @@ StripeSM::updateHeaderFooter()
   Errata zret;
   this->vol_init_data();
 
-  int64_t hdr_size      = this->vol_headerlen();
   int64_t dir_size      = this->vol_dirlen();
   Bytes   footer_offset = Bytes(dir_size - ROUND_TO_STORE_BLOCK(sizeof(StripeMeta)));
   _meta_pos[A][HEAD]    = round_down(_start);
@@ -314,10 +314,22 @@ StripeSM::updateHeaderFooter()
     return zret;
   }
 
-  char *meta_t = static_cast<char *>(ats_memalign(ats_pagesize(), dir_size));
+  return this->writeMeta();
+}
+
+Errata
+StripeSM::writeMeta()
+{
+  Errata  zret;
+  int64_t hdr_size    = this->vol_headerlen();
+  int64_t footer_size = ROUND_TO_STORE_BLOCK(sizeof(StripeMeta));
+  int64_t dir_size    = this->vol_dirlen() - hdr_size - footer_size;
+
+  char *meta_t = static_cast<char *>(ats_memalign(ats_pagesize(), this->vol_dirlen()));
   // copy headers
   for (auto i : {A, B}) {
     // copy header
+    memset(meta_t, 0, hdr_size);
     memcpy(meta_t, &_meta[i][HEAD], sizeof(StripeMeta));
     // copy freelist
     memcpy(meta_t + sizeof(StripeMeta) - sizeof(uint16_t), this->freelist, this->_segments * sizeof(uint16_t));
@@ -330,7 +342,6 @@ StripeSM::updateHeaderFooter()
       return zret;
     }
     // copy dir entries
-    dir_size = dir_size - hdr_size - ROUND_TO_STORE_BLOCK(sizeof(StripeMeta));
     memcpy(meta_t, (char *)dir, dir_size);
     n = pwrite(_span->_fd, meta_t, dir_size, _meta_pos[i][HEAD] + hdr_size); //
     if (n < dir_size) {
@@ -341,10 +352,10 @@ StripeSM::updateHeaderFooter()
     }
 
     // copy footer,
+    memset(meta_t, 0, footer_size);
     memcpy(meta_t, &_meta[i][FOOT], sizeof(StripeMeta));
 
-    int64_t footer_size = ROUND_TO_STORE_BLOCK(sizeof(StripeMeta));
-    n                   = pwrite(_span->_fd, meta_t, footer_size, _meta_pos[i][FOOT]);
+    n = pwrite(_span->_fd, meta_t, footer_size, _meta_pos[i][FOOT]);
     if (n < footer_size) {
       zret = Errata(make_errno_code(), "Failed to write stripe header ");
       std::cout << "problem writing footer to disk: " << strerror(errno) << ":" << " " << n << "<" << footer_size << std::endl;
@@ -359,7 +370,7 @@ StripeSM::updateHeaderFooter()
 size_t
 StripeSM::vol_dirlen()
 {
-  return vol_headerlen() + ROUND_TO_STORE_BLOCK(((size_t)this->_buckets) * DIR_DEPTH * this->_segments * SIZEOF_DIR) +
+  return vol_headerlen() + ROUND_TO_STORE_BLOCK(((size_t)this->_buckets) * DIR_DEPTH * this->_segments * _dir_entry_size) +
          ROUND_TO_STORE_BLOCK(sizeof(StripeMeta));
 }
 
@@ -420,13 +431,13 @@ dir_compare_tag(const CacheDirEntry *e, const CryptoHash *key)
 int
 vol_in_phase_valid(StripeSM *stripe, CacheDirEntry *e)
 {
-  return (dir_offset(e) - 1 < ((stripe->_meta[0][0].write_pos + stripe->agg_buf_pos - stripe->_start) / CACHE_BLOCK_SIZE));
+  return (dir_offset(e) - 1 < ((stripe->_meta[0][0].write_pos + stripe->agg_buf_pos - stripe->_content) / CACHE_BLOCK_SIZE));
 }
 
 int
 vol_out_of_phase_valid(StripeSM *stripe, CacheDirEntry *e)
 {
-  return (dir_offset(e) - 1 >= ((stripe->_meta[0][0].agg_pos - stripe->_start) / CACHE_BLOCK_SIZE));
+  return (dir_offset(e) - 1 >= ((stripe->_meta[0][0].agg_pos - stripe->_content) / CACHE_BLOCK_SIZE));
 }
 
 bool
@@ -631,6 +642,34 @@ StripeSM::loadDir()
   }
   return zret;
 }
+
+Errata
+StripeSM::mapDir()
+{
+  Errata zret;
+  size_t dirlen = this->vol_dirlen();
+  // Private so that changes made before writing the directory back stay in memory.
+  void *raw_dir = mmap(nullptr, dirlen, PROT_READ | PROT_WRITE, MAP_PRIVATE, this->_span->_fd, this->_start);
+  if (raw_dir == MAP_FAILED) {
+    // not every device can be mapped
+    return this->loadDir();
+  }
+  _dir_map     = raw_dir;
+  _dir_map_len = dirlen;
+  dir          = reinterpret_cast<CacheDirEntry *>(static_cast<char *>(raw_dir) + this->vol_headerlen());
+  return zret;
+}
+
+void
+StripeSM::unmapDir()
+{
+  if (_dir_map) {
+    munmap(_dir_map, _dir_map_len);
+    _dir_map     = nullptr;
+    _dir_map_len = 0;
+    dir          = nullptr;
+  }
+}
 //
 // Cache Directory
 //
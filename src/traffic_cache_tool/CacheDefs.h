@@ -33,6 +33,7 @@
 #include "tsutil/ts_errata.h"
 
 #include "tscore/Version.h"
+#include "tscore/ink_config.h"
 #include "tscore/ink_memory.h"
 #include "tsutil/Regex.h"
 #include "tscore/ink_file.h"
@@ -53,6 +54,23 @@ namespace ts
 /* INK_ALIGN() is only to be used to align on a power of 2 boundary */
 #define INK_ALIGN(size, boundary) (((size) + ((boundary) - 1)) & ~((boundary) - 1))
 #define ROUND_TO_STORE_BLOCK(_x)  INK_ALIGN((_x), 8192)
+#if TS_USE_COMPACT_CACHE_DIR
+#define dir_clear(_e) \
+  do {                \
+    (_e)->w[0] = 0;   \
+    (_e)->w[1] = 0;   \
+    (_e)->w[2] = 0;   \
+    (_e)->w[3] = 0;   \
+  } while (0)
+
+#define dir_assign(_e, _x)   \
+  do {                       \
+    (_e)->w[0] = (_x)->w[0]; \
+    (_e)->w[1] = (_x)->w[1]; \
+    (_e)->w[2] = (_x)->w[2]; \
+    (_e)->w[3] = (_x)->w[3]; \
+  } while (0)
+#else
 #define dir_clear(_e) \
   do {                \
     (_e)->w[0] = 0;   \
@@ -70,9 +88,13 @@ namespace ts
     (_e)->w[3] = (_x)->w[3]; \
     (_e)->w[4] = (_x)->w[4]; \
   } while (0)
+#endif
 
 constexpr static uint8_t CACHE_DB_MAJOR_VERSION = 24;
 constexpr static uint8_t CACHE_DB_MINOR_VERSION = 1;
+/// Bytes in a directory entry with and without the high offset bits, see TS_USE_COMPACT_CACHE_DIR.
+constexpr static int CLASSIC_SIZEOF_DIR = 10;
+constexpr static int COMPACT_SIZEOF_DIR = 8;
 /// Maximum allowed volume index.
 constexpr static int MAX_VOLUME_IDX          = 255;
 constexpr static int ENTRIES_PER_BUCKET      = 4;
@@ -160,11 +182,13 @@ public:
   uint32_t      write_serial;
   uint32_t      dirty;
   uint32_t      sector_size;
-  uint32_t      unused; // pad out to 8 byte boundary
+  uint32_t      dir_entry_size; // 0 if written before the entry size was recorded
   uint16_t      freelist[1];
 };
 
 struct Doc {
+  static constexpr uint32_t MAGIC = 0x5F129B13;
+
   uint32_t magic;     // DOC_MAGIC
   uint32_t len;       // length of this fragment (including hlen & sizeof(Doc), unrounded)
   uint64_t total_len; // total length of document
@@ -198,7 +222,7 @@ struct Doc {
 
 /*
  @internal struct Dir in P_CacheDir.h
- * size: 10bytes
+ * size: 10bytes, 8 without offset_high
  */
 
 class CacheDirEntry
@@ -216,7 +240,7 @@ public:
   unsigned int next : 16;
   uint16_t offset_high;
 #else
-  uint16_t w[5];
+  uint16_t w[(TS_USE_COMPACT_CACHE_DIR ? COMPACT_SIZEOF_DIR : CLASSIC_SIZEOF_DIR) / 2];
 #endif
 };
 
@@ -362,7 +386,7 @@ constexpr int            STRIPE_HASH_TABLE_SIZE  = 32707;
 constexpr unsigned short STRIPE_HASH_EMPTY       = 65535;
 constexpr int            DIR_TAG_WIDTH           = 12;
 constexpr int            DIR_DEPTH               = 4;
-constexpr int            SIZEOF_DIR              = 10;
+constexpr int            SIZEOF_DIR              = sizeof(CacheDirEntry);
 constexpr int            MAX_ENTRIES_PER_SEGMENT = (1 << 16);
 constexpr int            DIR_SIZE_WIDTH          = 6;
 constexpr int            DIR_BLOCK_SIZES         = 4;
@@ -378,6 +402,15 @@ namespace ct
 #define dir_head(_e)        dir_bit(_e, 2, 13)
 #define DIR_MASK_TAG(_t)    ((_t) & ((1 << DIR_TAG_WIDTH) - 1))
 #define dir_tag(_e)         ((uint32_t)((_e)->w[2] & ((1 << DIR_TAG_WIDTH) - 1)))
+#if TS_USE_COMPACT_CACHE_DIR
+#define dir_offset(_e) ((int64_t)(((uint64_t)(_e)->w[0]) | (((uint64_t)((_e)->w[1] & 0xFF)) << 16)))
+
+#define dir_set_offset(_e, _o)                                              \
+  do {                                                                      \
+    (_e)->w[0] = (uint16_t)_o;                                              \
+    (_e)->w[1] = (uint16_t)((((_o) >> 16) & 0xFF) | ((_e)->w[1] & 0xFF00)); \
+  } while (0)
+#else
 #define dir_offset(_e) \
   ((int64_t)(((uint64_t)(_e)->w[0]) | (((uint64_t)((_e)->w[1] & 0xFF)) << 16) | (((uint64_t)(_e)->w[4]) << 24)))
 
@@ -387,6 +420,7 @@ namespace ct
     (_e)->w[1] = (uint16_t)((((_o) >> 16) & 0xFF) | ((_e)->w[1] & 0xFF00)); \
     (_e)->w[4] = (uint16_t)((_o) >> 24);                                    \
   } while (0)
+#endif
 
 #define dir_next(_e)         (_e)->w[3]
 #define dir_phase(_e)        dir_bit(_e, 2, 12)
@@ -518,6 +552,11 @@ struct StripeSM {
   /// Load metadata for this stripe.
   Errata loadMeta();
   Errata loadDir();
+  /// Map the directory copy A instead of reading it, falling back to @c loadDir.
+  Errata mapDir();
+  void   unmapDir();
+  /// Write the current header and directory to both copies.
+  Errata writeMeta();
   int    check_loop(int s);
   void   dir_check();
   bool   walk_bucket_chain(int s); // returns true if there is a loop
@@ -536,8 +575,9 @@ struct StripeSM {
   int8_t           _idx        = -1; ///< StripeSM index in span.
   int              agg_buf_pos = 0;
 
-  int64_t _buckets  = 0; ///< Number of buckets per segment.
-  int64_t _segments = 0; ///< Number of segments.
+  int64_t _buckets        = 0;          ///< Number of buckets per segment.
+  int64_t _segments       = 0;          ///< Number of segments.
+  int     _dir_entry_size = SIZEOF_DIR; ///< Directory entry size used by @c vol_dirlen.
 
   std::string hashText;
 
@@ -545,6 +585,9 @@ struct StripeSM {
   StripeMeta _meta[2][2];
   /// Locations for the meta data.
   CacheStoreBlocks _meta_pos[2][2];
+  /// Mapping of the directory, if mapped by @c mapDir.
+  void  *_dir_map     = nullptr;
+  size_t _dir_map_len = 0;
   /// Directory.
   Chunk                _directory;
   CacheDirEntry const *dir      = nullptr; // the big buffer that will hold the whole directory of stripe header.
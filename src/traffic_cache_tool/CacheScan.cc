@@ -275,9 +275,10 @@ CacheScan::unmarshal(char *buf, int len, RefCountObj *block_ref)
   len -= HTTP_ALT_MARSHAL_SIZE;
 
   // usually the fragment count is less or equal to 4
-  if (alt->m_frag_offset_count > HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS) {
+  int table_size = alt->frag_table_size();
+  if (table_size > HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS) {
     // stuff that didn't fit in the integral slots.
-    int extra = sizeof(uint64_t) * alt->m_frag_offset_count - sizeof(alt->m_integral_frag_offsets);
+    int extra = sizeof(uint64_t) * table_size - sizeof(alt->m_integral_frag_offsets);
     if (extra >= len || extra < 0) {
       zret.note("Invalid Fragment Count {}", extra);
       return zret;
@@ -289,7 +290,7 @@ CacheScan::unmarshal(char *buf, int len, RefCountObj *block_ref)
     // future.
     int bcount = HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS * 2;
 
-    while (bcount < alt->m_frag_offset_count) {
+    while (bcount < table_size) {
       bcount *= 2;
     }
     alt->m_frag_offsets =
@@ -297,7 +298,7 @@ CacheScan::unmarshal(char *buf, int len, RefCountObj *block_ref)
     memcpy(alt->m_frag_offsets, alt->m_integral_frag_offsets, sizeof(alt->m_integral_frag_offsets));
     memcpy(alt->m_frag_offsets + HTTPCacheAlt::N_INTEGRAL_FRAG_OFFSETS, extra_src, extra);
     len -= extra;
-  } else if (alt->m_frag_offset_count > 0) {
+  } else if (table_size > 0) {
     alt->m_frag_offsets = alt->m_integral_frag_offsets;
   } else {
     alt->m_frag_offsets = nullptr; // should really already be zero.
@@ -35,6 +35,7 @@
 #include <ctime>
 #include <bitset>
 #include <cinttypes>
+#include <fstream>
 
 #include "tscore/ink_memory.h"
 #include "tscore/ink_file.h"
@@ -44,6 +45,7 @@
 
 #include "CacheDefs.h"
 #include "CacheScan.h"
+#include "CacheAnalyze.h"
 
 using swoc::Errata;
 using swoc::MemSpan;
@@ -1359,11 +1361,109 @@ Scan_Cache(swoc::file::path const &regex_path)
   }
 }
 
+void
+Analyze_Cache(int n_threads, swoc::file::path const &output_path)
+{
+  Cache cache;
+  if ((err = cache.loadSpan(SpanFile))) {
+    if (err.length()) {
+      return;
+    }
+    std::ofstream output;
+    if (!output_path.empty()) {
+      output.open(output_path.c_str());
+      if (!output) {
+        err.note("Unable to open {}", output_path);
+        return;
+      }
+    }
+    std::ostream &out = output_path.empty() ? std::cout : output;
+    const char   *sep = "";
+    out << "{\"stripes\": [";
+    // One stripe at a time, each read by n_threads threads.
+    for (auto &sp : cache._spans) {
+      for (auto strp : sp->_stripes) {
+        CacheAnalyze ca(strp);
+        if (auto zret = ca.Analyze(n_threads); zret.length()) {
+          std::cerr << zret;
+          continue;
+        }
+        out << sep;
+        ca.json(out);
+        sep = ", ";
+      }
+    }
+    out << "]}" << std::endl;
+  }
+}
+
+void static compact_span(Span &span)
+{
+  for (auto strp : span._stripes) {
+    CacheAnalyze ca(strp);
+    if (auto zret = ca.Compact(); zret.length()) {
+      std::cerr << zret;
+    }
+  }
+}
+
+void
+Compact_Cache(const std::string &devicePath)
+{
+  Cache                    cache;
+  std::vector<std::thread> threadPool;
+  if ((err = cache.loadSpan(SpanFile))) {
+    if (err.length()) {
+      return;
+    }
+    for (auto &sp : cache._spans) {
+      if (devicePath.empty() || sp->_path.view() == devicePath) {
+        threadPool.emplace_back(compact_span, std::ref(*sp));
+      }
+    }
+    for (auto &th : threadPool) {
+      th.join();
+    }
+  }
+}
+
+void static convert_dir_span(Span &span)
+{
+  for (auto strp : span._stripes) {
+    CacheAnalyze ca(strp);
+    if (auto zret = ca.ConvertDir(); zret.length()) {
+      std::cerr << zret;
+    }
+  }
+}
+
+void
+Convert_Dir(const std::string &devicePath)
+{
+  Cache                    cache;
+  std::vector<std::thread> threadPool;
+  if ((err = cache.loadSpan(SpanFile))) {
+    if (err.length()) {
+      return;
+    }
+    for (auto &sp : cache._spans) {
+      if (devicePath.empty() || sp->_path.view() == devicePath) {
+        threadPool.emplace_back(convert_dir_span, std::ref(*sp));
+      }
+    }
+    for (auto &th : threadPool) {
+      th.join();
+    }
+  }
+}
+
 int
 main([[maybe_unused]] int argc, const char *argv[])
 {
   swoc::file::path input_url_file;
+  swoc::file::path output_file;
   std::string      inputFile;
+  int              n_threads = std::max(1U, std::thread::hardware_concurrency());
 
   parser.add_global_usage(std::string(argv[0]) + " --spans <SPAN> --volume <FILE> <COMMAND> [<SUBCOMMAND> ...]\n");
   parser.require_commands()
@@ -1373,7 +1473,9 @@ main([[maybe_unused]] int argc, const char *argv[])
     .add_option("--write", "-w", "")
     .add_option("--input", "-i", "", "", 1)
     .add_option("--device", "-d", "", "", 1)
-    .add_option("--aos", "-o", "", "", 1);
+    .add_option("--aos", "-o", "", "", 1)
+    .add_option("--threads", "-t", "", "", 1)
+    .add_option("--output", "-O", "", "", 1);
 
   parser.add_command("list", "List elements of the cache", []() { List_Stripes(Cache::SpanDumpDepth::SPAN); })
     .add_command("stripes", "List the stripes", []() { List_Stripes(Cache::SpanDumpDepth::STRIPE); });
@@ -1394,6 +1496,12 @@ main([[maybe_unused]] int argc, const char *argv[])
   parser.add_command("init", " Initializes uninitialized span", [&]() { Init_disk(input_url_file); });
   parser.add_command("scan", " Scans the whole cache and lists the urls of the cached contents",
                      [&]() { Scan_Cache(input_url_file); });
+  parser.add_command("analyze", "Report the object size, age and fragment histograms of each stripe as JSON",
+                     [&]() { Analyze_Cache(n_threads, output_file); });
+  parser.add_command("compact", "Rewrite the stripes so that their contents are contiguous, with the cache stopped",
+                     [&]() { Compact_Cache(inputFile); });
+  parser.add_command("convert_dir", "Convert the stripe directories to compact entries, with the cache stopped",
+                     [&]() { Convert_Dir(inputFile); });
 
   // parse the arguments
   auto arguments = parser.parse(argv);
@@ -1412,6 +1520,12 @@ main([[maybe_unused]] int argc, const char *argv[])
   if (auto data = arguments.get("device")) {
     inputFile = data.value();
   }
+  if (auto data = arguments.get("threads")) {
+    n_threads = std::max(1, std::stoi(data.value()));
+  }
+  if (auto data = arguments.get("output")) {
+    output_file = data.value();
+  }
   if (auto data = arguments.get("write")) {
     OPEN_RW_FLAG = O_RDWR;
     std::cout << "NOTE: Writing to physical devices enabled" << std::endl;
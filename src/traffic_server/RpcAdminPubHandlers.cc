@@ -22,6 +22,7 @@
 
 // Admin API Implementation headers.
 #include "mgmt/rpc/handlers/config/Configuration.h"
+#include "mgmt/rpc/handlers/eventloop/Profile.h"
 #include "mgmt/rpc/handlers/hostdb/HostDB.h"
 #include "mgmt/rpc/handlers/records/Records.h"
 #include "mgmt/rpc/handlers/storage/Storage.h"
@@ -43,6 +44,11 @@ register_admin_jsonrpc_handlers()
   rpc::add_method_handler("get_reload_config_status", &get_reload_config_status, &core_ats_rpc_service_provider_handle,
                           {{rpc::RESTRICTED_API}});
 
+  // Event loop
+  using namespace rpc::handlers::eventloop;
+  rpc::add_method_handler("get_continuation_profile", &get_continuation_profile, &core_ats_rpc_service_provider_handle,
+                          {{rpc::RESTRICTED_API}});
+
   // HostDB
   using namespace rpc::handlers::hostdb;
   rpc::add_method_handler("get_hostdb_status", &get_hostdb_status, &core_ats_rpc_service_provider_handle, {{rpc::RESTRICTED_API}});
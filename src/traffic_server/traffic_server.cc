@@ -527,6 +527,20 @@ private:
   Metrics::Gauge::AtomicType *memory_rss;
 };
 
+// Periodically gives the memory of idle free list items back to the OS.
+class FreelistReclaim : public Continuation
+{
+public:
+  FreelistReclaim() : Continuation(new_ProxyMutex()) { SET_HANDLER(&FreelistReclaim::periodic); }
+
+  int
+  periodic(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+  {
+    ink_freelists_reclaim();
+    return EVENT_CONT;
+  }
+};
+
 /** Gate the emission of the "Traffic Server is fully initialized" log message.
  *
  * This message is intended to be helpful to users who want to know that
@@ -1892,18 +1906,21 @@ configure_io_uring()
   RecInt aio_io_uring_attach_wq     = cfg.attach_wq;
   RecInt aio_io_uring_wq_bounded    = cfg.wq_bounded;
   RecInt aio_io_uring_wq_unbounded  = cfg.wq_unbounded;
+  RecInt aio_io_uring_fixed         = cfg.fixed;
 
   aio_io_uring_queue_entries = RecGetRecordInt("proxy.config.io_uring.entries").value_or(0);
   aio_io_uring_sq_poll_ms    = RecGetRecordInt("proxy.config.io_uring.sq_poll_ms").value_or(0);
   aio_io_uring_attach_wq     = RecGetRecordInt("proxy.config.io_uring.attach_wq").value_or(0);
   aio_io_uring_wq_bounded    = RecGetRecordInt("proxy.config.io_uring.wq_workers_bounded").value_or(0);
   aio_io_uring_wq_unbounded  = RecGetRecordInt("proxy.config.io_uring.wq_workers_unbounded").value_or(0);
+  aio_io_uring_fixed         = RecGetRecordInt("proxy.config.io_uring.fixed").value_or(0);
 
   cfg.queue_entries = aio_io_uring_queue_entries;
   cfg.sq_poll_ms    = aio_io_uring_sq_poll_ms;
   cfg.attach_wq     = aio_io_uring_attach_wq;
   cfg.wq_bounded    = aio_io_uring_wq_bounded;
   cfg.wq_unbounded  = aio_io_uring_wq_unbounded;
+  cfg.fixed         = aio_io_uring_fixed;
 
   IOUringContext::set_config(cfg);
 }
@@ -2274,6 +2291,9 @@ main(int /* argc ATS_UNUSED */, const char **argv)
   eventProcessor.schedule_every(new SignalContinuation, HRTIME_MSECOND * 500, ET_CALL);
   eventProcessor.schedule_every(new DiagsLogContinuation, HRTIME_SECOND, ET_TASK);
   eventProcessor.schedule_every(new MemoryLimit, HRTIME_SECOND * 10, ET_TASK);
+  if (int reclaim_interval = RecGetRecordInt("proxy.config.allocator.reclaim_interval").value_or(0); reclaim_interval > 0) {
+    eventProcessor.schedule_every(new FreelistReclaim, HRTIME_SECONDS(reclaim_interval), ET_TASK);
+  }
   RecRegisterConfigUpdateCb("proxy.config.dump_mem_info_frequency", init_memory_tracker, nullptr);
   init_memory_tracker(nullptr, RECD_NULL, RecData(), nullptr);
 
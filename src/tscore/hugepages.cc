@@ -19,13 +19,18 @@
   limitations under the License.
  */
 
+#include <algorithm>
+#include <bit>
 #include <cstdio>
+#include <mutex>
 #include <sys/mman.h>
 
 #include "swoc/bwf_ip.h"
 
 #include "tscore/Diags.h"
 #include "tscore/ink_align.h"
+#include "tscore/ink_assert.h"
+#include "tscore/hugepages.h"
 
 namespace
 {
@@ -43,6 +48,58 @@ bool hugepage_enabled;
 DbgCtl dbg_ctl_hugepages{"hugepages"};
 DbgCtl dbg_ctl_hugepages_init{"hugepages_init"};
 
+struct {
+  std::mutex         mutex;
+  size_t             page_size   = 0;
+  size_t             region_size = 0;
+  char              *next        = nullptr;
+  char              *end         = nullptr;
+  HugepageArenaStats stats;
+} arena;
+
+// Called with the arena mutex held.
+char *
+arena_map_region(size_t size)
+{
+  void *mem = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+  flags |= std::countr_zero(arena.page_size) << MAP_HUGE_SHIFT;
+#endif
+  mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (mem != MAP_FAILED) {
+    arena.stats.hugepage_bytes += size;
+    Dbg(dbg_ctl_hugepages, "Arena region of %zu bytes {%p}", size, mem);
+    return static_cast<char *>(mem);
+  }
+#endif
+  ++arena.stats.failures;
+
+  // Map a page more than needed so that the region can start on a huge page boundary, which
+  // transparent huge pages need.
+  char *raw =
+    static_cast<char *>(mmap(nullptr, size + arena.page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  if (raw == MAP_FAILED) {
+    return nullptr;
+  }
+  char  *start = reinterpret_cast<char *>(INK_ALIGN(reinterpret_cast<uintptr_t>(raw), arena.page_size));
+  size_t head  = start - raw;
+  if (head) {
+    munmap(raw, head);
+  }
+  if (arena.page_size - head) {
+    munmap(start + size, arena.page_size - head);
+  }
+#ifdef MADV_HUGEPAGE
+  madvise(start, size, MADV_HUGEPAGE);
+#endif
+  arena.stats.fallback_bytes += size;
+  Dbg(dbg_ctl_hugepages, "Arena region of %zu bytes without huge pages {%p}", size, start);
+  return start;
+}
+
 } // namespace
 
 size_t
@@ -152,3 +209,54 @@ ats_free_hugepage([[maybe_unused]] void *ptr, [[maybe_unused]] size_t s)
   return false;
 #endif
 }
+
+void
+ats_hugepage_arena_init(size_t page_size, size_t region_size)
+{
+  std::lock_guard lock(arena.mutex);
+
+  ink_release_assert(std::has_single_bit(page_size));
+  arena.page_size   = page_size;
+  arena.region_size = INK_ALIGN(region_size, page_size);
+  Dbg(dbg_ctl_hugepages_init, "Arena page size = %zu region size = %zu", arena.page_size, arena.region_size);
+}
+
+bool
+ats_hugepage_arena_enabled()
+{
+  return arena.page_size != 0;
+}
+
+void *
+ats_hugepage_arena_alloc(size_t size, size_t alignment)
+{
+  std::lock_guard lock(arena.mutex);
+
+  if (arena.page_size == 0) {
+    return nullptr;
+  }
+
+  char *p = reinterpret_cast<char *>(INK_ALIGN(reinterpret_cast<uintptr_t>(arena.next), alignment));
+  if (arena.next == nullptr || p + size > arena.end) {
+    // What is left of the current region is not used.
+    size_t region = std::max(arena.region_size, INK_ALIGN(size, arena.page_size));
+    char  *mem    = arena_map_region(region);
+    if (mem == nullptr) {
+      return nullptr;
+    }
+    arena.end = mem + region;
+    p         = mem;
+  }
+  arena.next             = p + size;
+  arena.stats.used_bytes += size;
+
+  return p;
+}
+
+HugepageArenaStats
+ats_hugepage_arena_stats()
+{
+  std::lock_guard lock(arena.mutex);
+
+  return arena.stats;
+}
@@ -38,6 +38,7 @@
 
 #include "tscore/ink_config.h"
 
+#include <algorithm>
 #include <cassert>
 #include <memory.h>
 #include <cstdlib>
@@ -99,7 +100,11 @@ const ink_freelist_ops *default_ops  = &freelist_ops;
 ink_freelist_list      *freelists           = nullptr;
 const ink_freelist_ops *freelist_global_ops = default_ops;
 
+int              freelist_nodes       = 1; ///< One more than the highest node set by a thread.
+thread_local int freelist_thread_node = 0;
+
 DbgCtl dbg_ctl_freelist_init{"freelist_init"};
+DbgCtl dbg_ctl_freelist_reclaim{"freelist_reclaim"};
 
 #ifdef SANITY
 inline void
@@ -133,6 +138,17 @@ ink_freelist_init_ops(int nofl_class, int nofl_proxy)
   freelist_global_ops = (nofl_class || nofl_proxy) ? ink_freelist_malloc_ops() : ink_freelist_freelist_ops();
 }
 
+void
+ink_freelist_set_thread_node(int node)
+{
+  node = node % INK_FREELIST_NODES;
+
+  for (int n = freelist_nodes; n <= node; n = freelist_nodes) {
+    ink_atomic_cas(&freelist_nodes, n, node + 1);
+  }
+  freelist_thread_node = node;
+}
+
 void
 ink_freelist_init(InkFreeList **fl, const char *name, uint32_t type_size, uint32_t chunk_size, uint32_t alignment,
                   bool use_hugepages)
@@ -142,7 +158,7 @@ ink_freelist_init(InkFreeList **fl, const char *name, uint32_t type_size, uint32
 
   /* its safe to add to this global list because ink_freelist_init()
      is only called from single-threaded initialization code. */
-  f = static_cast<InkFreeList *>(ats_memalign(alignment, sizeof(InkFreeList)));
+  f = static_cast<InkFreeList *>(ats_memalign(std::max<size_t>(alignment, alignof(InkFreeList)), sizeof(InkFreeList)));
   ink_zero(*f);
 
   fll       = static_cast<ink_freelist_list *>(ats_malloc(sizeof(ink_freelist_list)));
@@ -178,17 +194,21 @@ ink_freelist_init(InkFreeList **fl, const char *name, uint32_t type_size, uint32
     f->chunk_size = INK_ALIGN(chunk_size * f->type_size, ats_pagesize()) / f->type_size;
   }
   Dbg(dbg_ctl_freelist_init, "<%s> Chunk Size request/actual (%" PRIu32 "/%" PRIu32 ")", name, chunk_size, f->chunk_size);
-  SET_FREELIST_POINTER_VERSION(f->head, FROM_PTR(0), 0);
+  for (auto &n : f->node) {
+    SET_FREELIST_POINTER_VERSION(n.head, FROM_PTR(0), 0);
+    SET_FREELIST_POINTER_VERSION(n.cold, FROM_PTR(0), 0);
+  }
 
   *fl = f;
 }
 
 void
 ink_freelist_madvise_init(InkFreeList **fl, const char *name, uint32_t type_size, uint32_t chunk_size, uint32_t alignment,
-                          bool use_hugepages, int advice)
+                          bool use_hugepages, int advice, bool use_arena)
 {
   ink_freelist_init(fl, name, type_size, chunk_size, alignment, use_hugepages);
-  (*fl)->advice = advice;
+  (*fl)->advice    = advice;
+  (*fl)->use_arena = use_arena && !(*fl)->use_hugepages && ats_hugepage_arena_enabled();
 }
 
 InkFreeList *
@@ -218,74 +238,167 @@ namespace
 {
 
 void *
-freelist_new(InkFreeList *f)
+list_pop(head_p *list)
 {
   head_p item;
   head_p next;
   int    result = 0;
 
   do {
-    INK_QUEUE_LD(item, f->head);
+    INK_QUEUE_LD(item, *list);
     if (TO_PTR(FREELIST_POINTER(item)) == nullptr) {
-      uint32_t i;
-      void    *newp       = nullptr;
-      size_t   alloc_size = static_cast<size_t>(f->chunk_size) * f->type_size;
-      size_t   alignment  = 0;
-
-      if (f->use_hugepages) {
-        alignment = ats_hugepage_size();
-        newp      = ats_alloc_hugepage(alloc_size);
-        if (newp == nullptr) {
-          f->hugepages_failure++;
-        }
+      return nullptr;
+    }
+    SET_FREELIST_POINTER_VERSION(next, *ADDRESS_OF_NEXT(TO_PTR(FREELIST_POINTER(item)), 0), FREELIST_VERSION(item) + 1);
+    result = ink_atomic_cas(&list->data, item.data, next.data);
+
+#ifdef SANITY
+    if (result) {
+      if (FREELIST_POINTER(item) == TO_PTR(FREELIST_POINTER(next))) {
+        ink_abort("ink_freelist_new: loop detected");
       }
+      if (((uintptr_t)(TO_PTR(FREELIST_POINTER(next)))) & 3) {
+        ink_abort("ink_freelist_new: bad list");
+      }
+      if (TO_PTR(FREELIST_POINTER(next))) {
+        dummy_forced_read(TO_PTR(FREELIST_POINTER(next)));
+      }
+    }
+#endif /* SANITY */
+  } while (result == 0);
+
+  return TO_PTR(FREELIST_POINTER(item));
+}
+
+void
+list_push(head_p *list, void *head, void *tail)
+{
+  void **adr_of_next = ADDRESS_OF_NEXT(tail, 0);
+  head_p h;
+  head_p item_pair;
+  int    result = 0;
 
+  while (!result) {
+    INK_QUEUE_LD(h, *list);
+#ifdef SANITY
+    if (TO_PTR(FREELIST_POINTER(h)) == head) {
+      ink_abort("ink_freelist_free: trying to free item twice");
+    }
+    if (((uintptr_t)(TO_PTR(FREELIST_POINTER(h)))) & 3) {
+      ink_abort("ink_freelist_free: bad list");
+    }
+    if (TO_PTR(FREELIST_POINTER(h))) {
+      dummy_forced_read(TO_PTR(FREELIST_POINTER(h)));
+    }
+#endif /* SANITY */
+    *adr_of_next = FREELIST_POINTER(h);
+    SET_FREELIST_POINTER_VERSION(item_pair, FROM_PTR(head), FREELIST_VERSION(h));
+    INK_MEMORY_BARRIER;
+    result = ink_atomic_cas(&list->data, h.data, item_pair.data);
+  }
+}
+
+void *
+pop_hot(InkFreeListNode &n)
+{
+  void *item = n.free > 0 ? list_pop(&n.head) : nullptr;
+
+  if (item) {
+    int32_t left = ink_atomic_increment(&n.free, -1) - 1;
+    if (left < n.min_free) {
+      n.min_free = left;
+    }
+  }
+  return item;
+}
+
+void *
+pop_cold(InkFreeListNode &n)
+{
+  void *item = n.cold_count > 0 ? list_pop(&n.cold) : nullptr;
+
+  if (item) {
+    ink_atomic_increment(&n.cold_count, -1);
+  }
+  return item;
+}
+
+void
+push_hot(InkFreeListNode &n, void *head, void *tail, size_t num_item)
+{
+  list_push(&n.head, head, tail);
+  ink_atomic_increment(&n.free, num_item);
+}
+
+void *
+freelist_new(InkFreeList *f)
+{
+  int              nodes = freelist_nodes;
+  int              node  = freelist_thread_node;
+  InkFreeListNode &own   = f->node[node];
+  void            *item  = pop_hot(own);
+
+  // The pages of cold items are faulted in again on the node of this thread, so those of any node
+  // are as good as the recently used items of this one.
+  for (int i = 0; item == nullptr && i < nodes; ++i) {
+    item = pop_cold(f->node[(node + i) % nodes]);
+  }
+  for (int i = 1; item == nullptr && i < nodes; ++i) {
+    item = pop_hot(f->node[(node + i) % nodes]);
+  }
+
+  if (item == nullptr) {
+    void  *newp       = nullptr;
+    size_t alloc_size = static_cast<size_t>(f->chunk_size) * f->type_size;
+    size_t alignment  = 0;
+
+    if (f->use_hugepages) {
+      alignment = ats_hugepage_size();
+      newp      = ats_alloc_hugepage(alloc_size);
       if (newp == nullptr) {
-        alignment = ats_pagesize();
-        newp      = ats_memalign(alignment, INK_ALIGN(alloc_size, alignment));
+        f->hugepages_failure++;
       }
+    }
 
-      if (f->advice) {
-        ats_madvise(static_cast<caddr_t>(newp), INK_ALIGN(alloc_size, alignment), f->advice);
+    if (f->use_arena) {
+      alignment = ats_pagesize();
+      newp      = ats_hugepage_arena_alloc(INK_ALIGN(alloc_size, alignment), alignment);
+      if (newp == nullptr) {
+        f->hugepages_failure++;
       }
-      SET_FREELIST_POINTER_VERSION(item, newp, 0);
+    }
 
-      ink_atomic_increment(reinterpret_cast<int *>(&f->allocated), f->chunk_size);
+    if (newp == nullptr) {
+      alignment = ats_pagesize();
+      newp      = ats_memalign(alignment, INK_ALIGN(alloc_size, alignment));
+    }
 
-      /* free each of the new elements */
-      for (i = 0; i < f->chunk_size; i++) {
-        char *a = (static_cast<char *>(FREELIST_POINTER(item))) + i * f->type_size;
-#ifdef DEADBEEF
-        const char str[4] = {static_cast<char>(0xde), static_cast<char>(0xad), static_cast<char>(0xbe), static_cast<char>(0xef)};
-        for (int j = 0; j < static_cast<int>(f->type_size); j++) {
-          a[j] = str[j % 4];
-        }
-#endif
-        freelist_free(f, a);
-      }
+    if (f->advice) {
+      ats_madvise(static_cast<caddr_t>(newp), INK_ALIGN(alloc_size, alignment), f->advice);
+    }
 
-    } else {
-      SET_FREELIST_POINTER_VERSION(next, *ADDRESS_OF_NEXT(TO_PTR(FREELIST_POINTER(item)), 0), FREELIST_VERSION(item) + 1);
-      result = ink_atomic_cas(&f->head.data, item.data, next.data);
+    ink_atomic_increment(reinterpret_cast<int *>(&f->allocated), f->chunk_size);
 
-#ifdef SANITY
-      if (result) {
-        if (FREELIST_POINTER(item) == TO_PTR(FREELIST_POINTER(next))) {
-          ink_abort("ink_freelist_new: loop detected");
-        }
-        if (((uintptr_t)(TO_PTR(FREELIST_POINTER(next)))) & 3) {
-          ink_abort("ink_freelist_new: bad list");
-        }
-        if (TO_PTR(FREELIST_POINTER(next))) {
-          dummy_forced_read(TO_PTR(FREELIST_POINTER(next)));
-        }
+    /* keep the first of the new elements and free the rest in one go */
+    for (uint32_t i = 0; i < f->chunk_size; i++) {
+      char *a = static_cast<char *>(newp) + i * f->type_size;
+#ifdef DEADBEEF
+      const char str[4] = {static_cast<char>(0xde), static_cast<char>(0xad), static_cast<char>(0xbe), static_cast<char>(0xef)};
+      for (int j = 0; j < static_cast<int>(f->type_size); j++) {
+        a[j] = str[j % 4];
       }
-#endif /* SANITY */
+#endif
+      *ADDRESS_OF_NEXT(a, 0) = FROM_PTR(a + f->type_size);
     }
-  } while (result == 0);
-  ink_assert(!((uintptr_t)TO_PTR(FREELIST_POINTER(item)) & (((uintptr_t)f->alignment) - 1)));
+    item = newp;
+    if (f->chunk_size > 1) {
+      push_hot(own, static_cast<char *>(newp) + f->type_size, static_cast<char *>(newp) + (f->chunk_size - 1) * f->type_size,
+               f->chunk_size - 1);
+    }
+  }
+  ink_assert(!((uintptr_t)item & (((uintptr_t)f->alignment) - 1)));
 
-  return TO_PTR(FREELIST_POINTER(item));
+  return item;
 }
 
 void *
@@ -320,11 +433,6 @@ namespace
 void
 freelist_free(InkFreeList *f, void *item)
 {
-  void **adr_of_next = ADDRESS_OF_NEXT(item, 0);
-  head_p h;
-  head_p item_pair;
-  int    result = 0;
-
   // ink_assert(!((long)item&(f->alignment-1))); XXX - why is this no longer working? -bcall
 
 #ifdef DEADBEEF
@@ -338,24 +446,7 @@ freelist_free(InkFreeList *f, void *item)
   }
 #endif /* DEADBEEF */
 
-  while (!result) {
-    INK_QUEUE_LD(h, f->head);
-#ifdef SANITY
-    if (TO_PTR(FREELIST_POINTER(h)) == item) {
-      ink_abort("ink_freelist_free: trying to free item twice");
-    }
-    if (((uintptr_t)(TO_PTR(FREELIST_POINTER(h)))) & 3) {
-      ink_abort("ink_freelist_free: bad list");
-    }
-    if (TO_PTR(FREELIST_POINTER(h))) {
-      dummy_forced_read(TO_PTR(FREELIST_POINTER(h)));
-    }
-#endif /* SANITY */
-    *adr_of_next = FREELIST_POINTER(h);
-    SET_FREELIST_POINTER_VERSION(item_pair, FROM_PTR(item), FREELIST_VERSION(h));
-    INK_MEMORY_BARRIER;
-    result = ink_atomic_cas(&f->head.data, h.data, item_pair.data);
-  }
+  push_hot(f->node[freelist_thread_node], item, item, 1);
 }
 
 void
@@ -383,13 +474,8 @@ namespace
 {
 
 void
-freelist_bulkfree(InkFreeList *f, void *head, void *tail, [[maybe_unused]] size_t num_item)
+freelist_bulkfree(InkFreeList *f, void *head, void *tail, size_t num_item)
 {
-  void **adr_of_next = ADDRESS_OF_NEXT(tail, 0);
-  head_p h;
-  head_p item_pair;
-  int    result = 0;
-
   // ink_assert(!((long)item&(f->alignment-1))); XXX - why is this no longer working? -bcall
 
 #ifdef DEADBEEF
@@ -408,24 +494,7 @@ freelist_bulkfree(InkFreeList *f, void *head, void *tail, [[maybe_unused]] size_
   }
 #endif /* DEADBEEF */
 
-  while (!result) {
-    INK_QUEUE_LD(h, f->head);
-#ifdef SANITY
-    if (TO_PTR(FREELIST_POINTER(h)) == head) {
-      ink_abort("ink_freelist_free: trying to free item twice");
-    }
-    if (((uintptr_t)(TO_PTR(FREELIST_POINTER(h)))) & 3) {
-      ink_abort("ink_freelist_free: bad list");
-    }
-    if (TO_PTR(FREELIST_POINTER(h))) {
-      dummy_forced_read(TO_PTR(FREELIST_POINTER(h)));
-    }
-#endif /* SANITY */
-    *adr_of_next = FREELIST_POINTER(h);
-    SET_FREELIST_POINTER_VERSION(item_pair, FROM_PTR(head), FREELIST_VERSION(h));
-    INK_MEMORY_BARRIER;
-    result = ink_atomic_cas(&f->head.data, h.data, item_pair.data);
-  }
+  push_hot(f->node[freelist_thread_node], head, tail, num_item);
 }
 
 void
@@ -446,6 +515,51 @@ malloc_bulkfree(InkFreeList *f, void *head, void *tail, size_t num_item)
 
 } // end anonymous namespace
 
+size_t
+ink_freelists_reclaim()
+{
+  size_t const page      = ats_pagesize();
+  size_t       reclaimed = 0;
+
+  if (freelist_global_ops != &freelist_ops) {
+    return 0;
+  }
+
+  for (ink_freelist_list *fll = freelists; fll; fll = fll->next) {
+    InkFreeList *f = fll->fl;
+
+    // Dropping part of a huge page would split it.
+    if (f->use_hugepages || f->use_arena || f->type_size < 2 * page) {
+      continue;
+    }
+    for (int i = 0; i < freelist_nodes; ++i) {
+      InkFreeListNode &n = f->node[i];
+
+      // Items that stayed in the list since the last time were not needed.
+      for (int idle = std::min(n.min_free, n.free); idle > 0; --idle) {
+        char *item = static_cast<char *>(pop_hot(n));
+        if (item == nullptr) {
+          break;
+        }
+        // Keep the page with the link to the next item.
+        uintptr_t start = INK_ALIGN(reinterpret_cast<uintptr_t>(item) + sizeof(void *), page);
+        uintptr_t end   = (reinterpret_cast<uintptr_t>(item) + f->type_size) & ~(page - 1);
+        if (end > start) {
+          // Not ats_madvise(), posix_madvise() ignores POSIX_MADV_DONTNEED on Linux.
+          madvise(reinterpret_cast<void *>(start), end - start, MADV_DONTNEED);
+          reclaimed += end - start;
+        }
+        list_push(&n.cold, item, item);
+        ink_atomic_increment(&n.cold_count, 1);
+      }
+      n.min_free = n.free;
+    }
+  }
+  Dbg(dbg_ctl_freelist_reclaim, "gave back %zu bytes", reclaimed);
+
+  return reclaimed;
+}
+
 void
 ink_freelists_snap_baseline()
 {
@@ -22,10 +22,14 @@
 */
 
 #include "tscore/Allocator.h"
+#include "tscore/hugepages.h"
+#include "tscore/ink_memory.h"
 
 #include <catch2/catch_test_macros.hpp>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <thread>
 
 // Counter to track constructor/destructor calls
 static int g_construct_count = 0;
@@ -328,3 +332,85 @@ TEST_CASE("ClassAllocator constructor forwarding", "[libts][allocator]")
     allocator.free(obj);
   }
 }
+
+TEST_CASE("FreelistAllocator NUMA nodes", "[libts][allocator]")
+{
+  FreelistAllocator allocator("test_nodes", 64, 4);
+
+  void *a = allocator.alloc_void();
+  allocator.free_void(a);
+
+  // Node 1 has nothing of its own, so it takes from node 0, and gets its own item back after that.
+  void *b = nullptr;
+  void *c = nullptr;
+  std::thread([&]() {
+    ink_freelist_set_thread_node(1);
+    b = allocator.alloc_void();
+    allocator.free_void(b);
+  }).join();
+  std::thread([&]() {
+    ink_freelist_set_thread_node(1);
+    c = allocator.alloc_void();
+  }).join();
+  REQUIRE(b == a);
+  REQUIRE(c == b);
+
+  void *d = allocator.alloc_void();
+  REQUIRE(d != nullptr);
+  REQUIRE(d != c);
+
+  allocator.free_void(c);
+  allocator.free_void(d);
+}
+
+TEST_CASE("FreelistAllocator reclaim", "[libts][allocator]")
+{
+  constexpr int     count = 4;
+  size_t const      page  = ats_pagesize();
+  size_t const      size  = 4 * page;
+  FreelistAllocator allocator("test_reclaim", size, count, page);
+  void             *items[count];
+
+  for (auto &item : items) {
+    item = allocator.alloc_void();
+    memset(item, 0xab, size);
+  }
+  for (auto item : items) {
+    allocator.free_void(item);
+  }
+
+  // The first pass only notes what is free, the second gives back what stayed free.
+  ink_freelists_reclaim();
+  REQUIRE(ink_freelists_reclaim() >= count * (size - page));
+
+  // The same items come back, with all but their first page zeroed.
+  for (auto &item : items) {
+    item = allocator.alloc_void();
+    auto p = static_cast<unsigned char *>(item);
+    REQUIRE(p[page] == 0);
+    REQUIRE(p[size - 1] == 0);
+  }
+  for (auto item : items) {
+    allocator.free_void(item);
+  }
+}
+
+TEST_CASE("FreelistAllocator huge page arena", "[libts][allocator]")
+{
+  ats_hugepage_arena_init(2 << 20, 4 << 20);
+
+  FreelistAllocator allocator;
+  allocator.re_init("test_arena", 1024, 64, 8, false, 0, true);
+
+  HugepageArenaStats before = ats_hugepage_arena_stats();
+  void              *item   = allocator.alloc_void();
+  HugepageArenaStats after  = ats_hugepage_arena_stats();
+
+  // Without reserved huge pages the region is mapped with normal pages.
+  REQUIRE(after.used_bytes == before.used_bytes + 64 * 1024);
+  REQUIRE(after.hugepage_bytes + after.fallback_bytes == 4 << 20);
+  REQUIRE(reinterpret_cast<uintptr_t>(item) % ats_pagesize() == 0);
+  memset(item, 0xab, 1024);
+
+  allocator.free_void(item);
+}
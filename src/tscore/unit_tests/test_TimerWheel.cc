@@ -0,0 +1,234 @@
+/** @file
+
+  Unit tests for TimerWheel
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "tscore/TimerWheel.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+struct Timer {
+  ink_hrtime at       = 0;
+  uint16_t   slot     = UINT16_MAX;
+  ink_hrtime expired  = 0; ///< Time passed to the advance() that expired it.
+  int        n_expire = 0;
+
+  LINK(Timer, link);
+};
+
+// A tick of 1 keeps the arithmetic obvious, a tick of 10 checks the rounding.
+using Wheel    = TimerWheel<Timer, Timer::Link_link, &Timer::at, &Timer::slot, 1>;
+using TenWheel = TimerWheel<Timer, Timer::Link_link, &Timer::at, &Timer::slot, 10>;
+
+constexpr ink_hrtime RANGE = ink_hrtime{1} << 24;
+
+template <class W>
+int
+advance(W &wheel, ink_hrtime now)
+{
+  int n = 0;
+  wheel.advance(now, [&](Timer *t) {
+    t->expired = now;
+    ++t->n_expire;
+    ++n;
+  });
+  return n;
+}
+} // namespace
+
+TEST_CASE("TimerWheel expires on time", "[libts][TimerWheel]")
+{
+  Wheel wheel(1000);
+  Timer a, b, c, past;
+
+  a.at    = 1005;
+  b.at    = 1000 + 64 * 64 + 3; // level 2
+  c.at    = 1000 + RANGE * 3;   // out of range
+  past.at = 10;
+
+  wheel.insert(&a);
+  wheel.insert(&b);
+  wheel.insert(&c);
+  wheel.insert(&past);
+  REQUIRE(wheel.count() == 4);
+  REQUIRE(wheel.in(&a));
+
+  CHECK(wheel.earliest() == 1000);
+  CHECK(advance(wheel, 1000) == 1);
+  CHECK(past.n_expire == 1);
+  CHECK(!wheel.in(&past));
+
+  CHECK(wheel.earliest() == 1005);
+  CHECK(advance(wheel, 1004) == 0);
+  CHECK(advance(wheel, 1005) == 1);
+  CHECK(a.expired == 1005);
+
+  CHECK(advance(wheel, b.at - 1) == 0);
+  CHECK(advance(wheel, b.at) == 1);
+  CHECK(b.expired == b.at);
+
+  CHECK(advance(wheel, c.at - 1) == 0);
+  CHECK(c.n_expire == 0);
+  CHECK(wheel.earliest() <= c.at);
+  CHECK(advance(wheel, c.at + 100) == 1);
+  CHECK(c.expired == c.at + 100);
+  CHECK(wheel.count() == 0);
+}
+
+TEST_CASE("TimerWheel rounds deadlines up to a tick", "[libts][TimerWheel]")
+{
+  TenWheel wheel(100);
+  Timer    a;
+
+  a.at = 121;
+  wheel.insert(&a);
+  CHECK(wheel.earliest() == 130);
+  CHECK(advance(wheel, 129) == 0);
+  CHECK(advance(wheel, 130) == 1);
+}
+
+TEST_CASE("TimerWheel removal", "[libts][TimerWheel]")
+{
+  Wheel wheel(0);
+  Timer a, b;
+
+  a.at = 10;
+  b.at = 10;
+  wheel.insert(&a);
+  wheel.insert(&b);
+  wheel.remove(&a);
+  wheel.remove(&a);
+  CHECK(!wheel.in(&a));
+  CHECK(wheel.count() == 1);
+  CHECK(advance(wheel, 100) == 1);
+  CHECK(a.n_expire == 0);
+  CHECK(b.n_expire == 1);
+  CHECK(wheel.earliest() >= HRTIME_FOREVER);
+}
+
+TEST_CASE("TimerWheel insert while expiring", "[libts][TimerWheel]")
+{
+  Wheel wheel(0);
+  Timer a;
+  int   n = 0;
+
+  a.at = 5;
+  wheel.insert(&a);
+  // Every 7 ticks until 70, even when the wheel is advanced past several of them at once.
+  for (ink_hrtime now : {5, 6, 30, 31, 500}) {
+    wheel.advance(now, [&](Timer *t) {
+      ++n;
+      t->at += 7;
+      if (t->at < 70) {
+        wheel.insert(t);
+      }
+    });
+  }
+  CHECK(n == 10);
+  CHECK(wheel.count() == 0);
+}
+
+TEST_CASE("TimerWheel random deadlines", "[libts][TimerWheel]")
+{
+  std::mt19937_64                           rng(13);
+  std::uniform_int_distribution<ink_hrtime> deadline(0, 64 * 64 * 64 * 4);
+  std::uniform_int_distribution<ink_hrtime> step(0, 5000);
+
+  Wheel              wheel(0);
+  std::vector<Timer> timers(10000);
+
+  for (auto &t : timers) {
+    t.at = deadline(rng);
+    wheel.insert(&t);
+  }
+  // Cancel a few.
+  for (size_t i = 0; i < timers.size(); i += 10) {
+    wheel.remove(&timers[i]);
+  }
+
+  ink_hrtime prev = 0;
+  for (ink_hrtime now = 0; wheel.count(); now += step(rng)) {
+    REQUIRE(wheel.earliest() >= prev);
+    wheel.advance(now, [&](Timer *t) {
+      // Due in this advance and not before.
+      CHECK(t->at <= now);
+      CHECK(t->at >= prev);
+      ++t->n_expire;
+    });
+    prev = now + 1;
+  }
+  for (size_t i = 0; i < timers.size(); ++i) {
+    REQUIRE(timers[i].n_expire == (i % 10 ? 1 : 0));
+  }
+}
+
+TEST_CASE("TimerWheel early expiry", "[libts][TimerWheel]")
+{
+  Wheel wheel(0);
+  Timer keep, drop;
+
+  keep.at = 64 * 64 * 10 + 100;
+  drop.at = 64 * 64 * 10 + 100;
+  wheel.insert(&keep);
+  wheel.insert(&drop);
+
+  auto expire = [](Timer *t) { ++t->n_expire; };
+  auto early  = [&](Timer *t) { return t == &drop; };
+
+  // Moved down from level 2 when the span it is in starts, before it is due.
+  wheel.advance(64 * 64 * 10, expire, early);
+  CHECK(drop.n_expire == 1);
+  CHECK(keep.n_expire == 0);
+  wheel.advance(64 * 64 * 10 + 100, expire, early);
+  CHECK(keep.n_expire == 1);
+}
+
+TEST_CASE("TimerWheel remove while expiring", "[libts][TimerWheel]")
+{
+  Wheel wheel(0);
+  Timer a, b, c;
+
+  // a and b are due together, c is moved down a level in the same advance.
+  a.at = 64 * 64 + 1;
+  b.at = 64 * 64 + 1;
+  c.at = 64 * 64 + 100;
+  wheel.insert(&a);
+  wheel.insert(&b);
+  wheel.insert(&c);
+
+  int n = 0;
+  wheel.advance(
+    64 * 64 + 1,
+    [&](Timer *t) {
+      ++n;
+      wheel.remove(t == &a ? &b : &a);
+      wheel.remove(&c);
+    },
+    [](Timer *) { return false; });
+  CHECK(n == 1);
+  CHECK(wheel.count() == 0);
+  CHECK(wheel.earliest() >= HRTIME_FOREVER);
+}
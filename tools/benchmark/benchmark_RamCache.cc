@@ -0,0 +1,322 @@
+
+/** @file
+
+Trace replay benchmark for the RAM cache replacement and admission policies
+
+@section license License
+
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+  Replay a key trace through the RAM cache replacement and admission policies
+  and report the hit rate of each, so they can be compared on captured traffic.
+
+  The trace is read from the file named by RAM_CACHE_TRACE, one request per
+  line as "<key> [<object size>]". Without a trace a synthetic one is used: a
+  skewed popularity distribution interleaved with scans of one-hit keys. The
+  RAM cache size is taken from RAM_CACHE_SIZE (bytes, default 64MB).
+
+  RamCacheConcurrentHits measures RAM hit throughput from RAM_CACHE_THREADS
+  threads (default: one per core), comparing a per-stripe cache behind a
+  single mutex against the sharded cache.
+*/
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "P_CacheInternal.h"
+#include "P_RamCache.h"
+#include "StripeSM.h"
+
+#include "iocore/eventsystem/EventSystem.h"
+#include "records/RecordsConfig.h"
+#include "tscore/Layout.h"
+
+#include "iocore/utils/diags.i"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern void register_cache_stats(CacheStatsBlock *rsb, const std::string &prefix);
+
+namespace
+{
+
+struct Request {
+  CryptoHash key;
+  uint32_t   size;
+};
+
+constexpr uint32_t DEFAULT_OBJECT_SIZE = 32 * 1024;
+
+std::vector<Request>
+load_trace(const char *path)
+{
+  std::vector<Request> trace;
+  std::ifstream        in(path);
+  std::string          line;
+
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    std::string        name;
+    uint32_t           size = DEFAULT_OBJECT_SIZE;
+    if (!(fields >> name)) {
+      continue;
+    }
+    fields >> size;
+    Request r;
+    CryptoContext().hash_immediate(r.key, name.data(), name.size());
+    r.size = size;
+    trace.push_back(r);
+  }
+  return trace;
+}
+
+std::vector<Request>
+synthetic_trace()
+{
+  constexpr int nkeys     = 100000;
+  constexpr int nrequests = 500000;
+  constexpr int scan_len  = 2000;
+
+  std::mt19937                          gen(42);
+  std::vector<double>                   weights(nkeys);
+  std::uniform_int_distribution<int>    sizes(1024, 128 * 1024);
+  std::uniform_real_distribution<float> coin(0, 1);
+  std::vector<uint32_t>                 object_size(nkeys);
+
+  for (int i = 0; i < nkeys; ++i) {
+    weights[i]     = 1.0 / std::pow(i + 1, 0.9);
+    object_size[i] = sizes(gen);
+  }
+  std::discrete_distribution<int> popular(weights.begin(), weights.end());
+
+  std::vector<Request> trace;
+  uint64_t             one_hit = nkeys;
+  trace.reserve(nrequests);
+  while (static_cast<int>(trace.size()) < nrequests) {
+    Request r;
+    ink_zero(r.key);
+    if (coin(gen) < 0.001) {
+      for (int i = 0; i < scan_len; ++i, ++one_hit) {
+        CryptoContext().hash_immediate(r.key, &one_hit, sizeof(one_hit));
+        r.size = DEFAULT_OBJECT_SIZE;
+        trace.push_back(r);
+      }
+      continue;
+    }
+    uint64_t n = popular(gen);
+    CryptoContext().hash_immediate(r.key, &n, sizeof(n));
+    r.size = object_size[n];
+    trace.push_back(r);
+  }
+  return trace;
+}
+
+struct Policy {
+  const char                 *name;
+  std::function<RamCache *()> create;
+};
+
+class RamCacheReplay
+{
+public:
+  RamCacheReplay()
+  {
+    _disk.path         = ats_strdup("benchmark");
+    _disk.disk_stripes = static_cast<DiskStripe **>(ats_calloc(1, sizeof(DiskStripe *)));
+    _disk.header       = static_cast<DiskHeader *>(ats_calloc(1, sizeof(DiskHeader)));
+    _stripe            = new StripeSM(&_disk, 10, 0);
+    _stripe->cache_vol = &_vol;
+    register_cache_stats(&_vol.vol_rsb, "benchmark.cache.volume_0");
+    for (int i = 0; i < DEFAULT_BUFFER_SIZES; ++i) {
+      _data[i] = new_IOBufferData(i, MEMALIGNED);
+    }
+  }
+
+  // Replay the whole trace through a fresh cache, returning the hit rate.
+  double
+  run(RamCache *cache, const std::vector<Request> &trace, int64_t max_bytes) const
+  {
+    cache->init(max_bytes, _stripe);
+    uint64_t hits = 0;
+    for (auto const &r : trace) {
+      Ptr<IOBufferData> data;
+      CryptoHash        key = r.key;
+      if (cache->get(&key, &data)) {
+        ++hits;
+      } else {
+        cache->put(&key, _data[iobuffer_size_to_index(r.size, MAX_BUFFER_SIZE_INDEX)].get(), r.size);
+      }
+    }
+    delete cache;
+    return trace.empty() ? 0 : static_cast<double>(hits) / trace.size();
+  }
+
+  // Fill the cache with nkeys objects of size bytes, returning their keys.
+  std::vector<CryptoHash>
+  fill(RamCache *cache, uint64_t nkeys, uint32_t size, int64_t max_bytes) const
+  {
+    std::vector<CryptoHash> keys(nkeys);
+    cache->init(max_bytes, _stripe);
+    for (uint64_t n = 0; n < nkeys; ++n) {
+      CryptoContext().hash_immediate(keys[n], &n, sizeof(n));
+      cache->put(&keys[n], _data[iobuffer_size_to_index(size, MAX_BUFFER_SIZE_INDEX)].get(), size);
+    }
+    return keys;
+  }
+
+private:
+  CacheDisk         _disk;
+  CacheVol          _vol;
+  StripeSM         *_stripe = nullptr;
+  Ptr<IOBufferData> _data[DEFAULT_BUFFER_SIZES];
+};
+
+// Run nthreads readers looking up resident keys concurrently, returning lookups per second.
+double
+concurrent_hits(RamCache *cache, std::mutex *stripe_mutex, const std::vector<CryptoHash> &keys, int nthreads, int lookups)
+{
+  std::vector<std::thread> threads;
+  std::atomic<uint64_t>    hits{0};
+  auto                     start = std::chrono::steady_clock::now();
+
+  for (int t = 0; t < nthreads; ++t) {
+    threads.emplace_back([&, t] {
+      std::mt19937                            gen(t);
+      std::uniform_int_distribution<uint64_t> pick(0, keys.size() - 1);
+      uint64_t                                local_hits = 0;
+      for (int i = 0; i < lookups; ++i) {
+        Ptr<IOBufferData> data;
+        CryptoHash        key = keys[pick(gen)];
+        if (stripe_mutex) {
+          std::lock_guard<std::mutex> lock(*stripe_mutex);
+          local_hits += cache->get(&key, &data);
+        } else {
+          local_hits += cache->get(&key, &data);
+        }
+      }
+      hits += local_hits;
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return hits / elapsed.count();
+}
+
+void
+init_ts()
+{
+  static bool initialized = false;
+  if (initialized) {
+    return;
+  }
+  initialized = true;
+
+  Layout::create();
+  init_diags("", nullptr);
+  RecProcessInit();
+  LibRecordsConfigInit();
+  ink_event_system_init(EVENT_SYSTEM_MODULE_PUBLIC_VERSION);
+
+  EThread *main_thread = new EThread;
+  main_thread->set_specific();
+
+  register_cache_stats(&cache_rsb, "benchmark.cache");
+}
+
+RamCacheReplay &
+replay_fixture()
+{
+  static RamCacheReplay replay;
+  return replay;
+}
+
+} // end anonymous namespace
+
+TEST_CASE("RamCacheTraceReplay", "[bench][cache]")
+{
+  init_ts();
+
+  const char *trace_path = getenv("RAM_CACHE_TRACE");
+  const char *size_str   = getenv("RAM_CACHE_SIZE");
+  int64_t     max_bytes  = size_str ? strtoll(size_str, nullptr, 10) : 64 * 1024 * 1024;
+  auto        trace      = trace_path ? load_trace(trace_path) : synthetic_trace();
+  REQUIRE(!trace.empty());
+
+  RamCacheReplay &replay = replay_fixture();
+
+  Policy policies[] = {
+    {"LRU",             [] { return new_RamCacheLRU(); }                       },
+    {"CLFUS",           [] { return new_RamCacheCLFUS(); }                     },
+    {"LRU + TinyLFU",   [] { return new_RamCacheTinyLFU(new_RamCacheLRU()); }  },
+    {"CLFUS + TinyLFU", [] { return new_RamCacheTinyLFU(new_RamCacheCLFUS()); }},
+    {"Sharded",         [] { return new_RamCacheSharded(16); }                 },
+  };
+
+  printf("replaying %zu requests through a %" PRId64 " byte RAM cache\n", trace.size(), max_bytes);
+  for (auto const &p : policies) {
+    printf("%-16s hit rate %.4f\n", p.name, replay.run(p.create(), trace, max_bytes));
+  }
+
+  for (auto const &p : policies) {
+    BENCHMARK(p.name)
+    {
+      return replay.run(p.create(), trace, max_bytes);
+    };
+  }
+}
+
+TEST_CASE("RamCacheConcurrentHits", "[bench][cache]")
+{
+  init_ts();
+
+  const char *threads_str = getenv("RAM_CACHE_THREADS");
+  int         nthreads    = threads_str ? atoi(threads_str) : std::max(1U, std::thread::hardware_concurrency());
+  int         lookups     = 200000;
+  uint64_t    nkeys       = 16384;
+  int64_t     max_bytes   = 2 * nkeys * (DEFAULT_OBJECT_SIZE + 1024);
+
+  RamCacheReplay &replay = replay_fixture();
+
+  // The stripe mutex serializes every lookup into a per-stripe cache.
+  std::mutex stripe_mutex;
+  RamCache  *lru      = new_RamCacheLRU();
+  auto       lru_keys = replay.fill(lru, nkeys, DEFAULT_OBJECT_SIZE, max_bytes);
+  printf("%-16s %d threads %.0f hits/sec\n", "LRU", nthreads, concurrent_hits(lru, &stripe_mutex, lru_keys, nthreads, lookups));
+  delete lru;
+
+  RamCache *sharded      = new_RamCacheSharded(64);
+  auto      sharded_keys = replay.fill(sharded, nkeys, DEFAULT_OBJECT_SIZE, max_bytes);
+  printf("%-16s %d threads %.0f hits/sec\n", "Sharded", nthreads,
+         concurrent_hits(sharded, nullptr, sharded_keys, nthreads, lookups));
+  delete sharded;
+}